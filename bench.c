@@ -0,0 +1,640 @@
+//gcc -O2 -o bench.exe field.c matrix.c field_int.c float_field.c half_field.c int8_field.c matrix_quant.c modular_field.c matrix_modular.c matrix_exact.c matrix_bareiss.c gf2_matrix.c semiring_field.c matrix_semiring.c complex_field.c matrix_complex.c double_field.c int64_field.c matrix_wide.c matrix_lu.c matrix_refine.c matrix_batch.c matrix_inverse.c matrix_chain.c matrix_rowops.c matrix_buffer.c matrix_cache.c matrix_update.c bigint.c matrix_stats.c matrix_trace.c bench.c -lm
+//
+//Использование:
+//  bench [--reps N] [--perf] [--json out.json]
+//  bench --compare bench_baseline.json [--threshold 0.05] [--alpha 0.01] [--json out.json]
+//
+//Режим --compare загружает прошлый результат, повторяет те же замеры и
+//возвращает код 1, если медиана какого-либо замера выросла больше порога
+//и это значимо: односторонний тест Манна-Уитни сравнивает текущие замеры
+//с замерами baseline, умноженными на (1 + порог), то есть проверяет именно
+//рост сверх порога, а не любой сдвиг.
+//
+//bench_baseline.json в репозитории снят с --reps 15 на сборке из первой
+//строки; на другой машине его нужно переснять: bench --json bench_baseline.json
+//
+//Флаг --perf (только Linux) читает аппаратные счетчики через perf_event_open
+//вокруг замеров и печатает IPC и промахи на FLOP. Если счетчики недоступны
+//(контейнер, perf_event_paranoid), замеры идут как обычно.
+#ifdef __linux__
+    #define _GNU_SOURCE     //syscall в <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "matrix.h"
+#include "field.h"
+#include "int_field.h"
+#include "float_field.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+#ifdef __linux__
+    #include <unistd.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <linux/perf_event.h>
+#endif
+
+#define BENCH_MAX_CASES 32
+#define BENCH_MAX_SAMPLES 256
+
+typedef enum {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+static const char* g_perf_names[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses"
+};
+
+typedef struct {
+    const char* name;
+    size_t size;
+    int is_float;
+    void (*run)(Matrix* a, Matrix* b, Matrix* x);
+    double (*flops)(size_t n);
+} BenchCase;
+
+typedef struct {
+    char name[64];
+    size_t count;
+    double samples[BENCH_MAX_SAMPLES];
+    double flops;
+    int has_perf;
+    long long perf[PERF_COUNTER_COUNT];
+} BenchResult;
+
+static double get_precise_time_ms(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+#endif
+}
+
+//Замеры
+//Клон общий по буферу (O(1)): один замер - пачка клонов, иначе он тоньше таймера
+#define BENCH_CLONE_BATCH 1000
+
+static void run_clone(Matrix* a, Matrix* b, Matrix* x) {
+    (void)b;
+    (void)x;
+    MatrixError err;
+    for (int i = 0; i < BENCH_CLONE_BATCH; i++) Matrix_Destroy(Matrix_Clone(a, &err));
+}
+
+static void run_add(Matrix* a, Matrix* b, Matrix* x) {
+    (void)x;
+    MatrixError err;
+    Matrix_Destroy(Matrix_Add(a, b, &err));
+}
+
+static void run_scalar(Matrix* a, Matrix* b, Matrix* x) {
+    (void)b;
+    (void)x;
+    MatrixError err;
+    char scalar[16];
+    if (a->type == GetIntFieldInfo()) {
+        int val = 3;
+        memcpy(scalar, &val, sizeof(int));
+    } else {
+        float val = 2.5f;
+        memcpy(scalar, &val, sizeof(float));
+    }
+    Matrix_Destroy(Matrix_ScalarMultiply(a, scalar, &err));
+}
+
+static void run_multiply(Matrix* a, Matrix* b, Matrix* x) {
+    (void)x;
+    MatrixError err;
+    Matrix_Destroy(Matrix_Multiply(a, b, &err));
+}
+
+//Квантование входит в замер
+static void run_quantized_multiply(Matrix* a, Matrix* b, Matrix* x) {
+    (void)x;
+    MatrixError err;
+    QuantizedMatrix* qa = Matrix_Quantize(a, MATRIX_QUANT_PER_ROW, &err);
+    QuantizedMatrix* qb = Matrix_Quantize(b, MATRIX_QUANT_PER_COL, &err);
+    Matrix_Destroy(Matrix_QuantizedMultiply(qa, qb, &err));
+    QuantizedMatrix_Destroy(qa);
+    QuantizedMatrix_Destroy(qb);
+}
+
+static void run_gauss(Matrix* a, Matrix* b, Matrix* x) {
+    Matrix_GaussSolve(a, b, x);
+}
+
+//Число операций одного запуска
+static double flops_none(size_t n) {
+    (void)n;
+    return 0.0;
+}
+
+static double flops_elementwise(size_t n) {
+    return (double)n * (double)n;
+}
+
+static double flops_multiply(size_t n) {
+    return 2.0 * (double)n * (double)n * (double)n;
+}
+
+static double flops_gauss(size_t n) {
+    return 2.0 * (double)n * (double)n * (double)n / 3.0 + (double)n * (double)n;
+}
+
+static const BenchCase g_cases[] = {
+    { "clone_float_200",     200, 1, run_clone,    flops_none },
+    { "add_float_200",       200, 1, run_add,      flops_elementwise },
+    { "scalar_float_200",    200, 1, run_scalar,   flops_elementwise },
+    { "multiply_int_100",    100, 0, run_multiply, flops_multiply },
+    { "multiply_float_100",  100, 1, run_multiply, flops_multiply },
+    { "multiply_float_200",  200, 1, run_multiply, flops_multiply },
+    { "quantized_multiply_200", 200, 1, run_quantized_multiply, flops_multiply },
+    { "gauss_float_100",     100, 1, run_gauss,    flops_gauss },
+    { "gauss_float_200",     200, 1, run_gauss,    flops_gauss },
+};
+
+static const size_t g_case_count = sizeof(g_cases) / sizeof(g_cases[0]);
+
+static const BenchCase* find_case(const char* name) {
+    for (size_t i = 0; i < g_case_count; i++) {
+        if (strcmp(g_cases[i].name, name) == 0) return &g_cases[i];
+    }
+    return NULL;
+}
+
+//Детерминированное заполнение с диагональным преобладанием,
+//чтобы система для Гаусса была невырожденной
+static void fill_case_matrix(Matrix* m, unsigned seed) {
+    unsigned state = seed;
+    for (size_t i = 0; i < m->rows; i++) {
+        for (size_t j = 0; j < m->cols; j++) {
+            state = state * 1103515245u + 12345u;
+            int ival = (int)((state >> 16) % 19) - 9;
+            if (i == j && m->rows == m->cols) ival += 10 * (int)m->rows;
+            if (m->type == GetIntFieldInfo()) {
+                Matrix_Set(m, i, j, &ival);
+            } else {
+                float fval = (float)ival;
+                Matrix_Set(m, i, j, &fval);
+            }
+        }
+    }
+}
+
+//Аппаратные счетчики
+typedef struct {
+    int fd[PERF_COUNTER_COUNT];
+} PerfGroup;
+
+#ifdef __linux__
+
+//inherit: счетчик учитывает и потоки, созданные после открытия (потоки OpenMP
+//появляются при первом параллельном замере, счетчики открываются раньше)
+static int perf_open(unsigned type, unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+//Каждый счетчик открывается отдельно: часть из них может быть
+//недоступна (например, dTLB в виртуальной машине). Отдельные счетчики
+//мультиплексируются, поэтому значения масштабируются на долю времени работы
+static int perf_group_open(PerfGroup* g) {
+    unsigned long long dtlb = PERF_COUNT_HW_CACHE_DTLB |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    g->fd[PERF_CYCLES] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    g->fd[PERF_INSTRUCTIONS] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    g->fd[PERF_LLC_MISSES] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    g->fd[PERF_DTLB_MISSES] = perf_open(PERF_TYPE_HW_CACHE, dtlb);
+    g->fd[PERF_BRANCH_MISSES] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+
+    int opened = 0;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) opened += g->fd[i] >= 0;
+    return opened;
+}
+
+static void perf_group_start(PerfGroup* g) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (g->fd[i] < 0) continue;
+        ioctl(g->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(g->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static void perf_group_stop(PerfGroup* g, long long* values) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        values[i] = -1;
+        if (g->fd[i] < 0) continue;
+        ioctl(g->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        //value, time_enabled, time_running
+        unsigned long long v[3];
+        if (read(g->fd[i], v, sizeof(v)) != (ssize_t)sizeof(v) || v[2] == 0) continue;
+        values[i] = (long long)((double)v[0] * (double)v[1] / (double)v[2]);
+    }
+}
+
+static void perf_group_close(PerfGroup* g) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (g->fd[i] >= 0) close(g->fd[i]);
+    }
+}
+
+#else
+
+static int perf_group_open(PerfGroup* g) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) g->fd[i] = -1;
+    return 0;
+}
+
+static void perf_group_start(PerfGroup* g) {
+    (void)g;
+}
+
+static void perf_group_stop(PerfGroup* g, long long* values) {
+    (void)g;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) values[i] = -1;
+}
+
+static void perf_group_close(PerfGroup* g) {
+    (void)g;
+}
+
+#endif
+
+static int run_case(const BenchCase* c, size_t reps, PerfGroup* perf, BenchResult* out) {
+    const FieldInfo* type = c->is_float ? GetFloatFieldInfo() : GetIntFieldInfo();
+    Matrix* a = Matrix_Create(c->size, c->size, type);
+    Matrix* b = Matrix_Create(c->size, c->size, type);
+    Matrix* rhs = Matrix_Create(c->size, 1, type);
+    Matrix* x = Matrix_Create(c->size, 1, type);
+    if (!a || !b || !rhs || !x) {
+        Matrix_Destroy(a);
+        Matrix_Destroy(b);
+        Matrix_Destroy(rhs);
+        Matrix_Destroy(x);
+        return 0;
+    }
+    fill_case_matrix(a, 1);
+    fill_case_matrix(b, 2);
+    fill_case_matrix(rhs, 3);
+
+    Matrix* second = (c->run == run_gauss) ? rhs : b;
+
+    //Прогрев
+    for (int w = 0; w < 2; w++) c->run(a, second, x);
+
+    snprintf(out->name, sizeof(out->name), "%s", c->name);
+    out->count = reps;
+    out->flops = c->flops(c->size) * (double)reps;
+    out->has_perf = 0;
+
+    if (perf) perf_group_start(perf);
+    for (size_t r = 0; r < reps; r++) {
+        double start = get_precise_time_ms();
+        c->run(a, second, x);
+        out->samples[r] = get_precise_time_ms() - start;
+    }
+    if (perf) {
+        perf_group_stop(perf, out->perf);
+        out->has_perf = 1;
+    }
+
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(rhs);
+    Matrix_Destroy(x);
+    return 1;
+}
+
+//Статистика
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median(const double* samples, size_t count) {
+    double sorted[BENCH_MAX_SAMPLES];
+    memcpy(sorted, samples, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), compare_doubles);
+    if (count % 2) return sorted[count / 2];
+    return 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+}
+
+//Односторонний тест Манна-Уитни (H1: current медленнее baseline),
+//нормальное приближение с поправкой на совпадения. Возвращает p-value.
+static double mann_whitney_p(const double* base, size_t n1, const double* cur, size_t n2) {
+    size_t n = n1 + n2;
+    double values[2 * BENCH_MAX_SAMPLES];
+    int group[2 * BENCH_MAX_SAMPLES];
+    double ranks[2 * BENCH_MAX_SAMPLES];
+    size_t order[2 * BENCH_MAX_SAMPLES];
+
+    for (size_t i = 0; i < n1; i++) { values[i] = base[i]; group[i] = 0; }
+    for (size_t i = 0; i < n2; i++) { values[n1 + i] = cur[i]; group[n1 + i] = 1; }
+    for (size_t i = 0; i < n; i++) order[i] = i;
+
+    //Сортировка вставками по значению: выборки маленькие
+    for (size_t i = 1; i < n; i++) {
+        size_t key = order[i];
+        size_t j = i;
+        while (j > 0 && values[order[j - 1]] > values[key]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = key;
+    }
+
+    double tie_term = 0.0;
+    for (size_t i = 0; i < n; ) {
+        size_t j = i;
+        while (j + 1 < n && values[order[j + 1]] == values[order[i]]) j++;
+        double rank = 0.5 * (double)(i + j) + 1.0;
+        for (size_t k = i; k <= j; k++) ranks[order[k]] = rank;
+        double t = (double)(j - i + 1);
+        tie_term += t * t * t - t;
+        i = j + 1;
+    }
+
+    double rank_sum_cur = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        if (group[i] == 1) rank_sum_cur += ranks[i];
+    }
+
+    double u = rank_sum_cur - (double)n2 * (double)(n2 + 1) / 2.0;
+    double mean_u = (double)n1 * (double)n2 / 2.0;
+    double var_u = (double)n1 * (double)n2 / 12.0 *
+                   ((double)(n + 1) - tie_term / ((double)n * (double)(n - 1)));
+    if (var_u <= 0.0) return 1.0;
+
+    double z = (u - mean_u - 0.5) / sqrt(var_u);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+//JSON
+static int write_json(const char* path, const BenchResult* results, size_t count, size_t reps) {
+    FILE* f = fopen(path, "w");
+    if (!f) return 0;
+    fprintf(f, "{\n  \"version\": 1,\n  \"reps\": %zu,\n  \"cases\": [\n", reps);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(f, "    {\"name\": \"%s\", \"median_ms\": %.6f, \"samples_ms\": [",
+                results[i].name, median(results[i].samples, results[i].count));
+        for (size_t s = 0; s < results[i].count; s++) {
+            fprintf(f, "%s%.6f", s ? ", " : "", results[i].samples[s]);
+        }
+        fprintf(f, "]");
+        if (results[i].has_perf) {
+            fprintf(f, ", \"perf\": {");
+            for (int k = 0; k < PERF_COUNTER_COUNT; k++) {
+                fprintf(f, "%s\"%s\": %lld", k ? ", " : "", g_perf_names[k], results[i].perf[k]);
+            }
+            fprintf(f, "}");
+        }
+        fprintf(f, "}%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 1;
+}
+
+static char* read_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len < 0) {
+        fclose(f);
+        return NULL;
+    }
+    char* text = (char*)malloc((size_t)len + 1);
+    if (text && fread(text, 1, (size_t)len, f) != (size_t)len) {
+        free(text);
+        text = NULL;
+    }
+    if (text) text[len] = '\0';
+    fclose(f);
+    return text;
+}
+
+//Разбирает только формат, который пишет write_json
+static size_t parse_json(const char* text, BenchResult* results, size_t max_results) {
+    size_t count = 0;
+    const char* p = text;
+
+    while (count < max_results && (p = strstr(p, "\"name\"")) != NULL) {
+        BenchResult* r = &results[count];
+        p = strchr(p + 6, '"');
+        if (!p) break;
+        p++;
+        const char* end = strchr(p, '"');
+        if (!end || (size_t)(end - p) >= sizeof(r->name)) break;
+        memcpy(r->name, p, (size_t)(end - p));
+        r->name[end - p] = '\0';
+
+        r->has_perf = 0;
+        p = strstr(end, "\"samples_ms\"");
+        if (!p) break;
+        p = strchr(p, '[');
+        if (!p) break;
+        p++;
+
+        r->count = 0;
+        while (*p && *p != ']' && r->count < BENCH_MAX_SAMPLES) {
+            char* next;
+            double v = strtod(p, &next);
+            if (next == p) {
+                p++;
+                continue;
+            }
+            r->samples[r->count++] = v;
+            p = next;
+        }
+        if (r->count > 0) count++;
+    }
+
+    return count;
+}
+
+//Недоступный счетчик печатается как "-"
+static void print_perf(const BenchResult* r) {
+    const long long* v = r->perf;
+    if (v[PERF_CYCLES] > 0 && v[PERF_INSTRUCTIONS] >= 0) {
+        printf("  IPC %5.2f", (double)v[PERF_INSTRUCTIONS] / (double)v[PERF_CYCLES]);
+    } else {
+        printf("  IPC     -");
+    }
+
+    const PerfCounter per_flop[] = { PERF_LLC_MISSES, PERF_DTLB_MISSES };
+    for (size_t i = 0; i < sizeof(per_flop) / sizeof(per_flop[0]); i++) {
+        long long value = v[per_flop[i]];
+        if (value >= 0 && r->flops > 0.0) {
+            printf("  %s/flop %.2e", g_perf_names[per_flop[i]], (double)value / r->flops);
+        } else {
+            printf("  %s/flop -", g_perf_names[per_flop[i]]);
+        }
+    }
+
+    if (v[PERF_BRANCH_MISSES] >= 0) {
+        printf("  branch_misses %lld", v[PERF_BRANCH_MISSES]);
+    } else {
+        printf("  branch_misses -");
+    }
+}
+
+static void print_usage(void) {
+    printf("Usage:\n");
+    printf("  bench [--reps N] [--perf] [--json out.json]\n");
+    printf("  bench --compare bench_baseline.json [--threshold 0.05] [--alpha 0.01] [--json out.json]\n");
+}
+
+int main(int argc, char** argv) {
+    size_t reps = 15;
+    const char* json_path = NULL;
+    const char* baseline_path = NULL;
+    double threshold = 0.05;
+    double alpha = 0.01;
+    int use_perf = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+            alpha = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            use_perf = 1;
+        } else {
+            print_usage();
+            return 2;
+        }
+    }
+
+    if (reps < 3 || reps > BENCH_MAX_SAMPLES) {
+        printf("Error: --reps must be in [3, %d]\n", BENCH_MAX_SAMPLES);
+        return 2;
+    }
+
+    static BenchResult baseline[BENCH_MAX_CASES];
+    static BenchResult current[BENCH_MAX_CASES];
+    size_t baseline_count = 0;
+    size_t current_count = 0;
+
+    if (baseline_path) {
+        char* text = read_file(baseline_path);
+        if (!text) {
+            printf("Error: cannot read baseline '%s'\n", baseline_path);
+            return 2;
+        }
+        baseline_count = parse_json(text, baseline, BENCH_MAX_CASES);
+        free(text);
+        if (baseline_count == 0) {
+            printf("Error: no cases in baseline '%s'\n", baseline_path);
+            return 2;
+        }
+    }
+
+    PerfGroup perf;
+    PerfGroup* perf_ptr = NULL;
+    if (use_perf) {
+        if (perf_group_open(&perf) > 0) {
+            perf_ptr = &perf;
+        } else {
+            printf("Hardware counters unavailable, timing only\n");
+            perf_group_close(&perf);
+        }
+    }
+
+    //Без baseline гоняем все замеры, с baseline - только те же самые
+    size_t case_total = baseline_path ? baseline_count : g_case_count;
+    for (size_t i = 0; i < case_total; i++) {
+        const BenchCase* c = baseline_path ? find_case(baseline[i].name) : &g_cases[i];
+        if (!c) {
+            printf("%-22s  skipped (unknown case)\n", baseline[i].name);
+            continue;
+        }
+        BenchResult* r = &current[current_count];
+        if (!run_case(c, reps, perf_ptr, r)) {
+            printf("Error: failed to allocate matrices for %s\n", c->name);
+            return 2;
+        }
+        printf("%-22s  median %9.3f ms", c->name, median(r->samples, reps));
+        if (r->has_perf) print_perf(r);
+        printf("\n");
+        current_count++;
+    }
+    if (perf_ptr) perf_group_close(perf_ptr);
+
+    if (json_path && !write_json(json_path, current, current_count, reps)) {
+        printf("Error: cannot write '%s'\n", json_path);
+        return 2;
+    }
+
+    if (!baseline_path) return 0;
+
+    int regressions = 0;
+    printf("\n%-22s %10s %10s %8s %9s\n", "case", "base ms", "cur ms", "change", "p-value");
+    for (size_t i = 0; i < current_count; i++) {
+        const BenchResult* cur = &current[i];
+        const BenchResult* base = NULL;
+        for (size_t j = 0; j < baseline_count; j++) {
+            if (strcmp(baseline[j].name, cur->name) == 0) {
+                base = &baseline[j];
+                break;
+            }
+        }
+        if (!base) continue;
+
+        double base_median = median(base->samples, base->count);
+        double cur_median = median(cur->samples, cur->count);
+        double change = base_median > 0.0 ? cur_median / base_median - 1.0 : 0.0;
+        //Сдвигаем baseline на порог: значимость тогда означает рост больше порога
+        double shifted[BENCH_MAX_SAMPLES];
+        for (size_t j = 0; j < base->count; j++) shifted[j] = base->samples[j] * (1.0 + threshold);
+        double p = mann_whitney_p(shifted, base->count, cur->samples, cur->count);
+        int regressed = change > threshold && p < alpha;
+
+        printf("%-22s %10.3f %10.3f %+7.1f%% %9.4f%s\n", cur->name, base_median,
+               cur_median, change * 100.0, p, regressed ? "  REGRESSION" : "");
+        regressions += regressed;
+    }
+
+    if (regressions) {
+        printf("\n%d case(s) regressed beyond %.1f%% (alpha = %.3f)\n",
+               regressions, threshold * 100.0, alpha);
+        return 1;
+    }
+    printf("\nNo regressions\n");
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <stdlib.h>
+#include <string.h>
+#include "bigint.h"
+
+static void bigint_trim(BigInt* x) {
+    while (x->size > 0 && x->limbs[x->size - 1] == 0) x->size--;
+    if (x->size == 0) x->negative = false;
+}
+
+static bool bigint_reserve(BigInt* x, size_t capacity) {
+    if (capacity <= x->capacity) return true;
+    uint32_t* limbs = (uint32_t*)realloc(x->limbs, capacity * sizeof(uint32_t));
+    if (!limbs) return false;
+    x->limbs = limbs;
+    x->capacity = capacity;
+    return true;
+}
+
+void BigInt_Init(BigInt* x) {
+    x->limbs = NULL;
+    x->size = 0;
+    x->capacity = 0;
+    x->negative = false;
+}
+
+void BigInt_Free(BigInt* x) {
+    if (x) {
+        free(x->limbs);
+        BigInt_Init(x);
+    }
+}
+
+bool BigInt_ToInt64(const BigInt* x, int64_t* out) {
+    if (x->size > 2) return false;
+    uint64_t mag = 0;
+    for (size_t i = x->size; i-- > 0; ) mag = (mag << 32) | x->limbs[i];
+    if (x->negative) {
+        if (mag > (uint64_t)INT64_MAX + 1) return false;
+        *out = (int64_t)(0 - mag);
+    } else {
+        if (mag > (uint64_t)INT64_MAX) return false;
+        *out = (int64_t)mag;
+    }
+    return true;
+}
+
+size_t BigInt_Bits(const BigInt* x) {
+    if (x->size == 0) return 0;
+    size_t bits = (x->size - 1) * 32;
+    for (uint32_t top = x->limbs[x->size - 1]; top; top >>= 1) bits++;
+    return bits;
+}
+
+//Десятичная запись: деление копии на 10^9 с остатком
+void BigInt_Print(const BigInt* x, FILE* output) {
+    if (x->size == 0) {
+        fprintf(output, "0");
+        return;
+    }
+
+    uint32_t* work = (uint32_t*)malloc(x->size * sizeof(uint32_t));
+    uint32_t* chunks = (uint32_t*)malloc((x->size * 32 / 29 + 1) * sizeof(uint32_t));
+    if (!work || !chunks) {
+        free(work);
+        free(chunks);
+        return;
+    }
+    memcpy(work, x->limbs, x->size * sizeof(uint32_t));
+
+    size_t size = x->size;
+    size_t count = 0;
+    while (size > 0) {
+        uint64_t rem = 0;
+        for (size_t i = size; i-- > 0; ) {
+            uint64_t cur = (rem << 32) | work[i];
+            work[i] = (uint32_t)(cur / 1000000000u);
+            rem = cur % 1000000000u;
+        }
+        chunks[count++] = (uint32_t)rem;
+        while (size > 0 && work[size - 1] == 0) size--;
+    }
+
+    if (x->negative) fprintf(output, "-");
+    fprintf(output, "%u", (unsigned)chunks[count - 1]);
+    for (size_t i = count - 1; i-- > 0; ) fprintf(output, "%09u", (unsigned)chunks[i]);
+
+    free(work);
+    free(chunks);
+}
+
+bool bigint_set_u32(BigInt* x, uint32_t value) {
+    if (!bigint_reserve(x, 1)) return false;
+    x->limbs[0] = value;
+    x->size = 1;
+    x->negative = false;
+    bigint_trim(x);
+    return true;
+}
+
+bool bigint_copy(BigInt* dest, const BigInt* src) {
+    if (!bigint_reserve(dest, src->size)) return false;
+    if (src->size) memcpy(dest->limbs, src->limbs, src->size * sizeof(uint32_t));
+    dest->size = src->size;
+    dest->negative = src->negative;
+    return true;
+}
+
+bool bigint_mul_u32(BigInt* x, uint32_t factor) {
+    if (!bigint_reserve(x, x->size + 1)) return false;
+    uint64_t carry = 0;
+    for (size_t i = 0; i < x->size; i++) {
+        uint64_t cur = (uint64_t)x->limbs[i] * factor + carry;
+        x->limbs[i] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
+    x->limbs[x->size++] = (uint32_t)carry;
+    bigint_trim(x);
+    return true;
+}
+
+bool bigint_add_u32(BigInt* x, uint32_t value) {
+    if (!bigint_reserve(x, x->size + 1)) return false;
+    uint64_t carry = value;
+    for (size_t i = 0; i < x->size && carry; i++) {
+        uint64_t cur = (uint64_t)x->limbs[i] + carry;
+        x->limbs[i] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
+    if (carry) x->limbs[x->size++] = (uint32_t)carry;
+    return true;
+}
+
+bool bigint_add_mul_u32(BigInt* x, const BigInt* y, uint32_t factor) {
+    size_t size = (x->size > y->size ? x->size : y->size) + 1;
+    if (!bigint_reserve(x, size)) return false;
+    for (size_t i = x->size; i < size; i++) x->limbs[i] = 0;
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i < size; i++) {
+        uint64_t cur = (uint64_t)x->limbs[i] + carry;
+        if (i < y->size) cur += (uint64_t)y->limbs[i] * factor;
+        x->limbs[i] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
+    x->size = size;
+    bigint_trim(x);
+    return true;
+}
+
+uint32_t bigint_mod_u32(const BigInt* x, uint32_t p) {
+    uint64_t rem = 0;
+    for (size_t i = x->size; i-- > 0; ) {
+        rem = ((rem << 32) | x->limbs[i]) % p;
+    }
+    return (uint32_t)rem;
+}
+
+int bigint_cmp_abs(const BigInt* a, const BigInt* b) {
+    if (a->size != b->size) return a->size < b->size ? -1 : 1;
+    for (size_t i = a->size; i-- > 0; ) {
+        if (a->limbs[i] != b->limbs[i]) return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+bool bigint_rsub_abs(BigInt* x, const BigInt* y) {
+    if (!bigint_reserve(x, y->size)) return false;
+    for (size_t i = x->size; i < y->size; i++) x->limbs[i] = 0;
+
+    int64_t borrow = 0;
+    for (size_t i = 0; i < y->size; i++) {
+        int64_t cur = (int64_t)y->limbs[i] - x->limbs[i] - borrow;
+        borrow = cur < 0;
+        x->limbs[i] = (uint32_t)(cur + (borrow << 32));
+    }
+    x->size = y->size;
+    bigint_trim(x);
+    return true;
+}
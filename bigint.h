@@ -0,0 +1,38 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+//Целое произвольной длины: знак и модуль в 32-битных разрядах (младшие первыми)
+typedef struct {
+    uint32_t* limbs;
+    size_t size;
+    size_t capacity;
+    bool negative;
+} BigInt;
+
+void BigInt_Init(BigInt* x);
+void BigInt_Free(BigInt* x);
+
+//false, если значение не помещается в int64
+bool BigInt_ToInt64(const BigInt* x, int64_t* out);
+//Число бит модуля (0 для нуля)
+size_t BigInt_Bits(const BigInt* x);
+void BigInt_Print(const BigInt* x, FILE* output);
+
+//Операции над модулями для восстановления по КТО; false при нехватке памяти
+bool bigint_set_u32(BigInt* x, uint32_t value);
+bool bigint_copy(BigInt* dest, const BigInt* src);
+bool bigint_mul_u32(BigInt* x, uint32_t factor);
+bool bigint_add_u32(BigInt* x, uint32_t value);
+//x += y * factor
+bool bigint_add_mul_u32(BigInt* x, const BigInt* y, uint32_t factor);
+uint32_t bigint_mod_u32(const BigInt* x, uint32_t p);
+int bigint_cmp_abs(const BigInt* a, const BigInt* b);
+//x = y - x, требуется |y| >= |x|
+bool bigint_rsub_abs(BigInt* x, const BigInt* y);
+
+#endif
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "field.h"
+#include "complex_field.h"
+
+static const ComplexFloat g_complex_zero = {0.0f, 0.0f};
+static const ComplexFloat g_complex_one = {1.0f, 0.0f};
+
+//Формат ввода: действительная и мнимая части через пробел
+static void ComplexReader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
+    ComplexFloat* z = (ComplexFloat*)dest;
+    fscanf(src, "%f %f", &z->re, &z->im);
+}
+
+static void ComplexPrinter(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
+    const ComplexFloat* z = (const ComplexFloat*)data;
+    fprintf(dest, "%.2f%+.2fi", z->re, z->im);
+}
+
+static void ComplexAdder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    const ComplexFloat* x = (const ComplexFloat*)a;
+    const ComplexFloat* y = (const ComplexFloat*)b;
+    ComplexFloat r = {x->re + y->re, x->im + y->im};
+    *(ComplexFloat*)result = r;
+}
+
+static void ComplexSubtractor(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    const ComplexFloat* x = (const ComplexFloat*)a;
+    const ComplexFloat* y = (const ComplexFloat*)b;
+    ComplexFloat r = {x->re - y->re, x->im - y->im};
+    *(ComplexFloat*)result = r;
+}
+
+static void ComplexMultiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    const ComplexFloat* x = (const ComplexFloat*)a;
+    const ComplexFloat* y = (const ComplexFloat*)b;
+    ComplexFloat r = {x->re * y->re - x->im * y->im, x->re * y->im + x->im * y->re};
+    *(ComplexFloat*)result = r;
+}
+
+//Деление по Смиту: без переполнения в |y|^2 при больших компонентах
+static void ComplexDivider(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    const ComplexFloat* x = (const ComplexFloat*)a;
+    const ComplexFloat* y = (const ComplexFloat*)b;
+    if (y->re == 0.0f && y->im == 0.0f) return;
+
+    ComplexFloat r;
+    if (fabsf(y->re) >= fabsf(y->im)) {
+        float t = y->im / y->re;
+        float d = y->re + y->im * t;
+        r.re = (x->re + x->im * t) / d;
+        r.im = (x->im - x->re * t) / d;
+    } else {
+        float t = y->re / y->im;
+        float d = y->re * t + y->im;
+        r.re = (x->re * t + x->im) / d;
+        r.im = (x->im * t - x->re) / d;
+    }
+    *(ComplexFloat*)result = r;
+}
+
+static double ComplexAbs(const FieldInfo* field, const void* a) {
+    (void)field;
+    const ComplexFloat* z = (const ComplexFloat*)a;
+    return hypot(z->re, z->im);
+}
+
+static int ComplexIsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    const ComplexFloat* z = (const ComplexFloat*)a;
+    return z->re == 0.0f && z->im == 0.0f;
+}
+
+//Инициализация
+static const FieldInfo g_complex_field_info = {
+    .size = sizeof(ComplexFloat),
+    .name = "complex",
+    .read = ComplexReader,
+    .print = ComplexPrinter,
+    .add = ComplexAdder,
+    .sub = ComplexSubtractor,
+    .mul = ComplexMultiplier,
+    .div = ComplexDivider,
+    .abs = ComplexAbs,
+    .is_zero = ComplexIsZero,
+    .to_float = NULL,
+    .from_float = NULL,
+    .modulus = 0,
+    .zero = &g_complex_zero,
+    .one = &g_complex_one,
+    .id = FIELD_ID_COMPLEX,
+};
+
+const FieldInfo* GetComplexFieldInfo(void) {
+    return &g_complex_field_info;
+}
@@ -0,0 +1,14 @@
+#ifndef COMPLEX_FIELD_H
+#define COMPLEX_FIELD_H
+
+#include "field.h"
+
+//Комплексное число одинарной точности; в Matrix хранится чередованием re, im
+typedef struct {
+    float re;
+    float im;
+} ComplexFloat;
+
+const FieldInfo* GetComplexFieldInfo(void);
+
+#endif
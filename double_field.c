@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "field.h"
+#include "double_field.h"
+
+static const double g_double_zero = 0.0;
+static const double g_double_one = 1.0;
+
+static void DoubleReader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
+    fscanf(src, "%lf", (double*)dest);
+}
+
+static void DoublePrinter(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
+    fprintf(dest, "%.2f", *(const double*)data);
+}
+
+static void DoubleAdder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(double*)result = *(const double*)a + *(const double*)b;
+}
+
+static void DoubleSubtractor(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(double*)result = *(const double*)a - *(const double*)b;
+}
+
+static void DoubleMultiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(double*)result = *(const double*)a * *(const double*)b;
+}
+
+static void DoubleDivider(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    double divisor = *(const double*)b;
+    if (divisor != 0.0) {
+        *(double*)result = *(const double*)a / divisor;
+    }
+}
+
+static double DoubleAbs(const FieldInfo* field, const void* a) {
+    (void)field;
+    double value = *(const double*)a;
+    return value < 0.0 ? -value : value;
+}
+
+static int DoubleIsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const double*)a == 0.0;
+}
+
+//Инициализация
+static const FieldInfo g_double_field_info = {
+    .size = sizeof(double),
+    .name = "double",
+    .read = DoubleReader,
+    .print = DoublePrinter,
+    .add = DoubleAdder,
+    .sub = DoubleSubtractor,
+    .mul = DoubleMultiplier,
+    .div = DoubleDivider,
+    .abs = DoubleAbs,
+    .is_zero = DoubleIsZero,
+    .to_float = NULL,
+    .from_float = NULL,
+    .modulus = 0,
+    .zero = &g_double_zero,
+    .one = &g_double_one,
+    .id = FIELD_ID_DOUBLE,
+};
+
+const FieldInfo* GetDoubleFieldInfo(void) {
+    return &g_double_field_info;
+}
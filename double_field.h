@@ -0,0 +1,9 @@
+#ifndef DOUBLE_FIELD_H
+#define DOUBLE_FIELD_H
+
+#include "field.h"
+
+//Двойная точность; без to_float, чтобы не уходить в float-ядра с потерей точности
+const FieldInfo* GetDoubleFieldInfo(void);
+
+#endif
@@ -1,8 +1,97 @@
 #include "field.h"
 #include <string.h>
+#include <stdatomic.h>
+#include "int_field.h"
+#include "float_field.h"
+#include "half_field.h"
+#include "int8_field.h"
+#include "double_field.h"
+#include "int64_field.h"
+#include "complex_field.h"
+#include "semiring_field.h"
+
+//Пользовательские типы: регистрация (и запись field->id) под спин-блокировкой,
+//чтение таблицы - атомарная загрузка без блокировок
+static _Atomic(const FieldInfo*) g_registry[FIELD_ID_MAX];
+static atomic_uint g_registry_next = FIELD_ID_BUILTIN_COUNT;
+static atomic_flag g_registry_lock = ATOMIC_FLAG_INIT;
 
 int FieldInfo_Equals(const FieldInfo* a, const FieldInfo* b) {
     if (a == b) return 1;
     if (!a || !b) return 0;
-    return (a->size == b->size) && (strcmp(a->name, b->name) == 0);
+    uint32_t a_id = atomic_load_explicit(&a->id, memory_order_acquire);
+    uint32_t b_id = atomic_load_explicit(&b->id, memory_order_acquire);
+    if (a_id != FIELD_ID_NONE && b_id != FIELD_ID_NONE) {
+        return a_id == b_id && a->modulus == b->modulus;
+    }
+    return (a->size == b->size) && (a->modulus == b->modulus) &&
+           (strcmp(a->name, b->name) == 0);
+}
+
+void Field_CopyZero(const FieldInfo* field, void* dest) {
+    if (field->zero) {
+        memcpy(dest, field->zero, field->size);
+    } else {
+        memset(dest, 0, field->size);
+    }
+}
+
+int Field_EqualsZero(const FieldInfo* field, const void* a) {
+    if (field->zero) return memcmp(a, field->zero, field->size) == 0;
+    const unsigned char* bytes = (const unsigned char*)a;
+    for (size_t i = 0; i < field->size; i++) {
+        if (bytes[i]) return 0;
+    }
+    return 1;
+}
+
+uint32_t Field_Register(FieldInfo* field) {
+    if (!field) return FIELD_ID_NONE;
+
+    //Проверка и запись id - под блокировкой: описание могут регистрировать
+    //одновременно несколько потоков
+    while (atomic_flag_test_and_set_explicit(&g_registry_lock, memory_order_acquire)) {
+    }
+    uint32_t known_id = atomic_load_explicit(&field->id, memory_order_relaxed);
+    if (known_id != FIELD_ID_NONE) {
+        atomic_flag_clear_explicit(&g_registry_lock, memory_order_release);
+        return known_id;
+    }
+
+    uint32_t next = atomic_load_explicit(&g_registry_next, memory_order_relaxed);
+    uint32_t id = FIELD_ID_NONE;
+    for (uint32_t i = FIELD_ID_BUILTIN_COUNT; i < next; i++) {
+        const FieldInfo* known = atomic_load_explicit(&g_registry[i], memory_order_relaxed);
+        if (known->size == field->size && strcmp(known->name, field->name) == 0) {
+            id = i;
+            break;
+        }
+    }
+    if (id == FIELD_ID_NONE && next < FIELD_ID_MAX) {
+        id = next;
+        atomic_store_explicit(&g_registry[id], field, memory_order_release);
+        atomic_store_explicit(&g_registry_next, next + 1, memory_order_release);
+    }
+    atomic_store_explicit(&field->id, id, memory_order_release);
+
+    atomic_flag_clear_explicit(&g_registry_lock, memory_order_release);
+    return id;
+}
+
+const FieldInfo* Field_Lookup(uint32_t id) {
+    switch (id) {
+        case FIELD_ID_INT: return GetIntFieldInfo();
+        case FIELD_ID_FLOAT: return GetFloatFieldInfo();
+        case FIELD_ID_HALF: return GetHalfFieldInfo();
+        case FIELD_ID_BFLOAT16: return GetBFloat16FieldInfo();
+        case FIELD_ID_INT8: return GetInt8FieldInfo();
+        case FIELD_ID_DOUBLE: return GetDoubleFieldInfo();
+        case FIELD_ID_INT64: return GetInt64FieldInfo();
+        case FIELD_ID_COMPLEX: return GetComplexFieldInfo();
+        case FIELD_ID_MINPLUS: return GetMinPlusFieldInfo();
+        case FIELD_ID_BOOL: return GetBoolFieldInfo();
+        default: break;
+    }
+    if (id < FIELD_ID_BUILTIN_COUNT || id >= FIELD_ID_MAX) return NULL;
+    return atomic_load_explicit(&g_registry[id], memory_order_acquire);
 }
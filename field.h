@@ -2,13 +2,43 @@
 #define FIELD_H
 
 #include <stdio.h>
-
-typedef void (*FieldReaderFunc)(void* dest, FILE* src);
-typedef void (*FieldPrinterFunc)(const void* data, FILE* dest);
-typedef void (*FieldBinaryOpFunc)(void* result, const void* a, const void* b);
+#include <stdint.h>
 
 typedef struct FieldInfo FieldInfo;
 
+//Плотные номера типов: проверка совместимости и выбор ядра - одно сравнение
+//или индекс в таблице. Встроенные типы описаны статически (без ленивой
+//инициализации), пользовательские получают номер через Field_Register
+typedef enum {
+    FIELD_ID_NONE = 0,      //тип не зарегистрирован
+    FIELD_ID_INT,
+    FIELD_ID_FLOAT,
+    FIELD_ID_HALF,
+    FIELD_ID_BFLOAT16,
+    FIELD_ID_INT8,
+    FIELD_ID_DOUBLE,
+    FIELD_ID_INT64,
+    FIELD_ID_COMPLEX,
+    FIELD_ID_MINPLUS,
+    FIELD_ID_BOOL,
+    FIELD_ID_MODULAR,       //все GF(p), различаются полем modulus
+    FIELD_ID_BUILTIN_COUNT
+} FieldId;
+
+#define FIELD_ID_MAX 256
+
+//Первый аргумент - сам тип: параметризованным полям (GF(p)) нужен модуль
+typedef void (*FieldReaderFunc)(const FieldInfo* field, void* dest, FILE* src);
+typedef void (*FieldPrinterFunc)(const FieldInfo* field, const void* data, FILE* dest);
+typedef void (*FieldBinaryOpFunc)(const FieldInfo* field, void* result, const void* a, const void* b);
+//Пакетное преобразование в float и обратно (NULL, если тип не вещественный)
+typedef void (*FieldToFloatFunc)(float* dest, const void* src, size_t count);
+typedef void (*FieldFromFloatFunc)(void* dest, const float* src, size_t count);
+//Модуль элемента для выбора главного элемента (NULL, если порядка нет, как в GF(p))
+typedef double (*FieldAbsFunc)(const FieldInfo* field, const void* a);
+//Ненулевой результат, если элемент - нейтральный по сложению
+typedef int (*FieldIsZeroFunc)(const FieldInfo* field, const void* a);
+
 struct FieldInfo {
     size_t size;
     char name[16];
@@ -21,8 +51,37 @@ struct FieldInfo {
     FieldBinaryOpFunc sub;  
     FieldBinaryOpFunc mul;
     FieldBinaryOpFunc div;      
+    
+    FieldAbsFunc abs;
+    FieldIsZeroFunc is_zero;
+    
+    FieldToFloatFunc to_float;
+    FieldFromFloatFunc from_float;
+    
+    uint32_t modulus;   //p для GF(p), 0 для остальных типов
+    
+    //Нейтральные элементы сложения и умножения (для полуколец 0 - не всегда нуль)
+    const void* zero;
+    const void* one;
+    
+    //FieldId; FIELD_ID_NONE до Field_Register. Атомарный: тип может
+    //регистрироваться, пока другие потоки уже сравнивают его
+    _Atomic uint32_t id;
 };
 
 int FieldInfo_Equals(const FieldInfo* a, const FieldInfo* b);
 
+//Нуль типа: zero или нулевые байты, если тип его не задает (описания,
+//созданные до появления полей zero и one)
+void Field_CopyZero(const FieldInfo* field, void* dest);
+//Ненулевой результат, если a побайтно совпадает с нулем типа
+int Field_EqualsZero(const FieldInfo* field, const void* a);
+
+//Регистрация пользовательского типа: назначает field->id. Тип с тем же именем
+//и размером получает уже выданный номер. Возвращает номер или FIELD_ID_NONE,
+//если таблица заполнена (тогда типы сравниваются по имени, как раньше)
+uint32_t Field_Register(FieldInfo* field);
+//Описание по номеру без блокировок; NULL для FIELD_ID_MODULAR и неизвестных номеров
+const FieldInfo* Field_Lookup(uint32_t id);
+
 #endif
\ No newline at end of file
@@ -4,56 +4,74 @@
 #include "field.h"
 #include "int_field.h"
 
-static const FieldInfo* g_int_field_info = NULL;
+static const int g_int_zero = 0;
+static const int g_int_one = 1;
 
-static void IntReader(void* dest, FILE* src) {
+static void IntReader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
     fscanf(src, "%d", (int*)dest);
 }
 
-static void IntPrinter(const void* data, FILE* dest) {
+static void IntPrinter(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
     fprintf(dest, "%d", *(const int*)data);
 }
 
-static void IntAdder(void* result, const void* a, const void* b) {
-    *(int*)result = *(const int*)a + *(const int*)b;
+//Переполнение по модулю 2^32 через unsigned, без неопределенного поведения
+static void IntAdder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int*)result = (int)((unsigned)*(const int*)a + (unsigned)*(const int*)b);
 }
 
-static void IntSubtractor(void* result, const void* a, const void* b) {
-    *(int*)result = *(const int*)a - *(const int*)b;
+static void IntSubtractor(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int*)result = (int)((unsigned)*(const int*)a - (unsigned)*(const int*)b);
 }
 
-static void IntMultiplier(void* result, const void* a, const void* b) {
-    *(int*)result = *(const int*)a * *(const int*)b;
+static void IntMultiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int*)result = (int)((unsigned)*(const int*)a * (unsigned)*(const int*)b);
 }
 
-static void IntDivider(void* result, const void* a, const void* b) {
+static void IntDivider(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
     int divisor = *(const int*)b;
     if (divisor != 0) {
         *(int*)result = *(const int*)a / divisor;
     }
 }
 
-//Инициализация
-static const FieldInfo* CreateIntFieldInfo(void) {
-    FieldInfo* info = (FieldInfo*)malloc(sizeof(FieldInfo));
-    if (!info) return NULL;
-    
-    info->size = sizeof(int);
-    strcpy(info->name, "int");
-    
-    info->read = IntReader;
-    info->print = IntPrinter;
-    info->add = IntAdder;
-    info->sub = IntSubtractor;  
-    info->mul = IntMultiplier;
-    info->div = IntDivider;      
-    
-    return info;
+static double IntAbs(const FieldInfo* field, const void* a) {
+    (void)field;
+    int value = *(const int*)a;
+    return value < 0 ? -(double)value : (double)value;
+}
+
+static int IntIsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const int*)a == 0;
 }
 
+//Инициализация
+static const FieldInfo g_int_field_info = {
+    .size = sizeof(int),
+    .name = "int",
+    .read = IntReader,
+    .print = IntPrinter,
+    .add = IntAdder,
+    .sub = IntSubtractor,
+    .mul = IntMultiplier,
+    .div = IntDivider,
+    .abs = IntAbs,
+    .is_zero = IntIsZero,
+    .to_float = NULL,
+    .from_float = NULL,
+    .modulus = 0,
+    .zero = &g_int_zero,
+    .one = &g_int_one,
+    .id = FIELD_ID_INT,
+};
+
 const FieldInfo* GetIntFieldInfo(void) {
-    if (g_int_field_info == NULL) {
-        g_int_field_info = CreateIntFieldInfo();
-    }
-    return g_int_field_info;
+    return &g_int_field_info;
 }
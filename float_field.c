@@ -4,57 +4,82 @@
 #include "field.h"
 #include "float_field.h"
 
-static const FieldInfo* g_float_field_info = NULL;
+static const float g_float_zero = 0.0f;
+static const float g_float_one = 1.0f;
 
-static void FloatReader(void* dest, FILE* src) {
+static void FloatReader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
     fscanf(src, "%f", (float*)dest);
 }
 
-static void FloatPrinter(const void* data, FILE* dest) {
+static void FloatPrinter(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
     fprintf(dest, "%.2f", *(const float*)data);
 }
 
-static void FloatAdder(void* result, const void* a, const void* b) {
+static void FloatAdder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
     *(float*)result = *(const float*)a + *(const float*)b;
 }
 
-static void FloatSubtractor(void* result, const void* a, const void* b) {
+static void FloatSubtractor(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
     *(float*)result = *(const float*)a - *(const float*)b;
 }
 
-static void FloatMultiplier(void* result, const void* a, const void* b) {
+static void FloatMultiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
     *(float*)result = *(const float*)a * *(const float*)b;
 }
 
-static void FloatDivider(void* result, const void* a, const void* b) {
+static void FloatDivider(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
     float divisor = *(const float*)b;
     if (divisor != 0.0f) {
         *(float*)result = *(const float*)a / divisor;
     }
 }
 
-//Инициализация
-static const FieldInfo* CreateFloatFieldInfo(void) {
-    FieldInfo* info = (FieldInfo*)malloc(sizeof(FieldInfo));
-    if (!info) return NULL;
-    
-    info->size = sizeof(float);
-    strcpy(info->name, "float");
-    
-    info->read = FloatReader;
-    info->print = FloatPrinter;
-    info->add = FloatAdder;
-    info->sub = FloatSubtractor;  
-    info->mul = FloatMultiplier;
-    info->div = FloatDivider;      
-    
-    return info;
+static double FloatAbs(const FieldInfo* field, const void* a) {
+    (void)field;
+    float value = *(const float*)a;
+    return value < 0.0f ? -value : value;
+}
+
+static int FloatIsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const float*)a == 0.0f;
+}
+
+static void FloatToFloat(float* dest, const void* src, size_t count) {
+    memcpy(dest, src, count * sizeof(float));
 }
 
+static void FloatFromFloat(void* dest, const float* src, size_t count) {
+    memcpy(dest, src, count * sizeof(float));
+}
+
+//Инициализация
+static const FieldInfo g_float_field_info = {
+    .size = sizeof(float),
+    .name = "float",
+    .read = FloatReader,
+    .print = FloatPrinter,
+    .add = FloatAdder,
+    .sub = FloatSubtractor,
+    .mul = FloatMultiplier,
+    .div = FloatDivider,
+    .abs = FloatAbs,
+    .is_zero = FloatIsZero,
+    .to_float = FloatToFloat,
+    .from_float = FloatFromFloat,
+    .modulus = 0,
+    .zero = &g_float_zero,
+    .one = &g_float_one,
+    .id = FIELD_ID_FLOAT,
+};
+
 const FieldInfo* GetFloatFieldInfo(void) {
-    if (g_float_field_info == NULL) {
-        g_float_field_info = CreateFloatFieldInfo();
-    }
-    return g_float_field_info;
+    return &g_float_field_info;
 }
 
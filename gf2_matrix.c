@@ -0,0 +1,359 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "int_field.h"
+#include "gf2_matrix.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Число строк, из которых строится таблица сумм (2^8 строк-комбинаций)
+#define GF2_TABLE_BITS 8
+
+static uint64_t* gf2_row(const GF2Matrix* m, size_t row) {
+    return m->words + row * m->stride;
+}
+
+static int get_bit(const uint64_t* row, size_t col) {
+    return (int)((row[col >> 6] >> (col & 63)) & 1);
+}
+
+static void row_xor(uint64_t* dst, const uint64_t* src, size_t from, size_t to) {
+    for (size_t w = from; w < to; w++) dst[w] ^= src[w];
+}
+
+static void row_swap(uint64_t* a, uint64_t* b, size_t stride) {
+    for (size_t w = 0; w < stride; w++) {
+        uint64_t t = a[w];
+        a[w] = b[w];
+        b[w] = t;
+    }
+}
+
+static size_t lowest_bit(size_t s) {
+    size_t bit = 0;
+    while (!(s & 1)) {
+        s >>= 1;
+        bit++;
+    }
+    return bit;
+}
+
+//Таблица всех XOR-комбинаций строк rows[0..count-1]: table[s] = table[s без младшего бита] ^ rows[младший бит]
+static void build_table(uint64_t* table, const uint64_t* const* rows, size_t count, size_t from, size_t stride) {
+    memset(table, 0, stride * sizeof(uint64_t));
+    for (size_t s = 1; s < ((size_t)1 << count); s++) {
+        uint64_t* dst = table + s * stride;
+        const uint64_t* prev = table + (s & (s - 1)) * stride;
+        const uint64_t* add = rows[lowest_bit(s)];
+        for (size_t w = from; w < stride; w++) dst[w] = prev[w] ^ add[w];
+    }
+}
+
+GF2Matrix* GF2Matrix_Create(size_t rows, size_t cols) {
+    if (rows == 0 || cols == 0) return NULL;
+
+    GF2Matrix* m = (GF2Matrix*)malloc(sizeof(GF2Matrix));
+    if (!m) return NULL;
+
+    m->rows = rows;
+    m->cols = cols;
+    m->stride = (cols + 63) / 64;
+    m->words = (uint64_t*)calloc(rows * m->stride, sizeof(uint64_t));
+    if (!m->words) {
+        free(m);
+        return NULL;
+    }
+    MATRIX_STATS_ALLOC(rows * m->stride * sizeof(uint64_t));
+    return m;
+}
+
+void GF2Matrix_Destroy(GF2Matrix* m) {
+    if (m) {
+        MATRIX_STATS_FREE(m->rows * m->stride * sizeof(uint64_t));
+        free(m->words);
+        free(m);
+    }
+}
+
+MatrixError GF2Matrix_Get(const GF2Matrix* m, size_t row, size_t col, int* out) {
+    if (!m || !out) return MATRIX_ERROR_NULL_POINTER;
+    if (row >= m->rows || col >= m->cols) return MATRIX_ERROR_INVALID_INDEX;
+    *out = get_bit(gf2_row(m, row), col);
+    return MATRIX_OK;
+}
+
+MatrixError GF2Matrix_Set(GF2Matrix* m, size_t row, size_t col, int bit) {
+    if (!m) return MATRIX_ERROR_NULL_POINTER;
+    if (row >= m->rows || col >= m->cols) return MATRIX_ERROR_INVALID_INDEX;
+    uint64_t mask = (uint64_t)1 << (col & 63);
+    uint64_t* word = gf2_row(m, row) + (col >> 6);
+    *word = bit ? (*word | mask) : (*word & ~mask);
+    return MATRIX_OK;
+}
+
+GF2Matrix* GF2Matrix_FromMatrix(const Matrix* m, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    if (m->type != GetIntFieldInfo() && m->type->modulus != 2) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    GF2Matrix* g = GF2Matrix_Create(m->rows, m->cols);
+    if (!g) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    //int и uint32_t одного размера, младший бит у обоих один и тот же
+    const unsigned* src = (const unsigned*)m->data;
+    for (size_t i = 0; i < m->rows; i++) {
+        uint64_t* row = gf2_row(g, i);
+        for (size_t j = 0; j < m->cols; j++) {
+            row[j >> 6] |= (uint64_t)(src[i * m->cols + j] & 1u) << (j & 63);
+        }
+    }
+    return g;
+}
+
+Matrix* GF2Matrix_ToMatrix(const GF2Matrix* m, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+
+    Matrix* result = Matrix_Create(m->rows, m->cols, GetIntFieldInfo());
+    if (!result) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    int* dst = (int*)result->data;
+    for (size_t i = 0; i < m->rows; i++) {
+        const uint64_t* row = gf2_row(m, i);
+        for (size_t j = 0; j < m->cols; j++) dst[i * m->cols + j] = get_bit(row, j);
+    }
+    return result;
+}
+
+//M4RM: строки B группами по 8, для каждой группы таблица из 256 сумм,
+//строка C получает одну табличную строку на группу вместо 8 условных XOR
+static GF2Matrix* gf2_multiply_impl(const GF2Matrix* a, const GF2Matrix* b, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!a || !b) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    if (a->cols != b->rows) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+
+    GF2Matrix* c = GF2Matrix_Create(a->rows, b->cols);
+    uint64_t* table = (uint64_t*)malloc(((size_t)1 << GF2_TABLE_BITS) * b->stride * sizeof(uint64_t));
+    if (!c || !table) {
+        GF2Matrix_Destroy(c);
+        free(table);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    MATRIX_TRACE_BEGIN(kernel_span, "gf2_m4rm", a->rows, b->cols);
+    const uint64_t* group[GF2_TABLE_BITS];
+    for (size_t g = 0; g < a->cols; g += GF2_TABLE_BITS) {
+        size_t bits = a->cols - g < GF2_TABLE_BITS ? a->cols - g : GF2_TABLE_BITS;
+        for (size_t t = 0; t < bits; t++) group[t] = gf2_row(b, g + t);
+        build_table(table, group, bits, 0, b->stride);
+
+        //g кратно 8, поэтому 8 бит группы лежат в одном слове
+        size_t word = g >> 6;
+        size_t shift = g & 63;
+        uint64_t mask = ((uint64_t)1 << bits) - 1;
+
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < (long)a->rows; i++) {
+            size_t idx = (size_t)((gf2_row(a, (size_t)i)[word] >> shift) & mask);
+            if (idx) row_xor(gf2_row(c, (size_t)i), table + idx * b->stride, 0, b->stride);
+        }
+    }
+    MATRIX_TRACE_END(kernel_span);
+
+    free(table);
+    return c;
+}
+
+//M4RI: приведение к приведенному ступенчатому виду по первым pivot_cols
+//столбцам полосами по 8 столбцов. В полосе опорные строки ищутся с ленивой
+//редукцией (бит кандидата вычисляется с учетом уже найденных опорных без
+//изменения строки), затем все остальные строки очищаются одной табличной
+//строкой. pivots[r] - столбец опорного элемента строки r; возвращает ранг.
+static size_t gf2_reduce(GF2Matrix* m, size_t pivot_cols, size_t* pivots, uint64_t* table) {
+    size_t r = 0;
+    for (size_t c = 0; c < pivot_cols && r < m->rows; c += GF2_TABLE_BITS) {
+        size_t width = pivot_cols - c < GF2_TABLE_BITS ? pivot_cols - c : GF2_TABLE_BITS;
+        size_t from = c >> 6;
+        size_t found = 0;
+        size_t q[GF2_TABLE_BITS];
+        const uint64_t* pivot_rows[GF2_TABLE_BITS];
+
+        for (size_t col = c; col < c + width && r + found < m->rows; col++) {
+            size_t sel = m->rows;
+            for (size_t i = r + found; i < m->rows && sel == m->rows; i++) {
+                const uint64_t* row = gf2_row(m, i);
+                int bit = get_bit(row, col);
+                for (size_t t = 0; t < found; t++) {
+                    if (get_bit(row, q[t])) bit ^= get_bit(pivot_rows[t], col);
+                }
+                if (bit) sel = i;
+            }
+            if (sel == m->rows) continue;
+
+            uint64_t* p = gf2_row(m, r + found);
+            if (sel != r + found) row_swap(p, gf2_row(m, sel), m->stride);
+            for (size_t t = 0; t < found; t++) {
+                if (get_bit(p, q[t])) row_xor(p, pivot_rows[t], from, m->stride);
+            }
+            for (size_t t = 0; t < found; t++) {
+                if (get_bit(pivot_rows[t], col)) row_xor((uint64_t*)pivot_rows[t], p, from, m->stride);
+            }
+            q[found] = col;
+            pivot_rows[found] = p;
+            found++;
+        }
+        if (found == 0) continue;
+
+        build_table(table, pivot_rows, found, from, m->stride);
+
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < (long)m->rows; i++) {
+            if ((size_t)i >= r && (size_t)i < r + found) continue;
+            uint64_t* row = gf2_row(m, (size_t)i);
+            size_t idx = 0;
+            for (size_t t = 0; t < found; t++) idx |= (size_t)get_bit(row, q[t]) << t;
+            if (idx) row_xor(row, table + idx * m->stride, from, m->stride);
+        }
+
+        for (size_t t = 0; t < found; t++) pivots[r + t] = q[t];
+        r += found;
+    }
+    return r;
+}
+
+static GF2Matrix* gf2_clone(const GF2Matrix* m) {
+    GF2Matrix* copy = GF2Matrix_Create(m->rows, m->cols);
+    if (copy) memcpy(copy->words, m->words, m->rows * m->stride * sizeof(uint64_t));
+    return copy;
+}
+
+static MatrixError gf2_rank_impl(const GF2Matrix* m, size_t* rank) {
+    if (!m || !rank) return MATRIX_ERROR_NULL_POINTER;
+
+    GF2Matrix* work = gf2_clone(m);
+    size_t* pivots = (size_t*)malloc(m->rows * sizeof(size_t));
+    uint64_t* table = (uint64_t*)malloc(((size_t)1 << GF2_TABLE_BITS) * m->stride * sizeof(uint64_t));
+
+    MatrixError err = MATRIX_ERROR_MEMORY;
+    if (work && pivots && table) {
+        MATRIX_TRACE_BEGIN(span, "gf2_m4ri", m->rows, m->cols);
+        *rank = gf2_reduce(work, m->cols, pivots, table);
+        MATRIX_TRACE_END(span);
+        err = MATRIX_OK;
+    }
+
+    GF2Matrix_Destroy(work);
+    free(pivots);
+    free(table);
+    return err;
+}
+
+//[A|B] приводится по столбцам A; решение единственно, только если rank A = cols A
+static MatrixError gf2_solve_impl(const GF2Matrix* a, const GF2Matrix* b, GF2Matrix* x) {
+    if (!a || !b || !x) return MATRIX_ERROR_NULL_POINTER;
+    if (b->rows != a->rows || x->rows != a->cols || x->cols != b->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    GF2Matrix* aug = GF2Matrix_Create(a->rows, a->cols + b->cols);
+    size_t* pivots = (size_t*)malloc(a->rows * sizeof(size_t));
+    uint64_t* table = aug ? (uint64_t*)malloc(((size_t)1 << GF2_TABLE_BITS) * aug->stride * sizeof(uint64_t)) : NULL;
+    if (!aug || !pivots || !table) {
+        GF2Matrix_Destroy(aug);
+        free(pivots);
+        free(table);
+        return MATRIX_ERROR_MEMORY;
+    }
+
+    for (size_t i = 0; i < a->rows; i++) {
+        uint64_t* row = gf2_row(aug, i);
+        memcpy(row, gf2_row(a, i), a->stride * sizeof(uint64_t));
+        const uint64_t* rhs = gf2_row(b, i);
+        for (size_t j = 0; j < b->cols; j++) {
+            size_t col = a->cols + j;
+            row[col >> 6] |= (uint64_t)get_bit(rhs, j) << (col & 63);
+        }
+    }
+
+    MATRIX_TRACE_BEGIN(span, "gf2_m4ri", aug->rows, aug->cols);
+    size_t rank = gf2_reduce(aug, a->cols, pivots, table);
+    MATRIX_TRACE_END(span);
+
+    MatrixError err = (rank == a->cols) ? MATRIX_OK : MATRIX_ERROR_SINGULAR_MATRIX;
+
+    //Строки без опорного элемента: 0 = rhs, иначе система несовместна
+    for (size_t i = rank; err == MATRIX_OK && i < aug->rows; i++) {
+        const uint64_t* row = gf2_row(aug, i);
+        for (size_t j = 0; j < b->cols; j++) {
+            if (get_bit(row, a->cols + j)) err = MATRIX_ERROR_SINGULAR_MATRIX;
+        }
+    }
+
+    if (err == MATRIX_OK) {
+        memset(x->words, 0, x->rows * x->stride * sizeof(uint64_t));
+        for (size_t i = 0; i < rank; i++) {
+            const uint64_t* row = gf2_row(aug, i);
+            uint64_t* dst = gf2_row(x, pivots[i]);
+            for (size_t j = 0; j < b->cols; j++) {
+                dst[j >> 6] |= (uint64_t)get_bit(row, a->cols + j) << (j & 63);
+            }
+        }
+    }
+
+    GF2Matrix_Destroy(aug);
+    free(pivots);
+    free(table);
+    return err;
+}
+
+//Публичные функции
+GF2Matrix* GF2Matrix_Multiply(const GF2Matrix* a, const GF2Matrix* b, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_GF2_MULTIPLY);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_GF2_MULTIPLY), a ? a->rows : 0, b ? b->cols : 0);
+    GF2Matrix* result = gf2_multiply_impl(a, b, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * a->rows * a->cols * b->cols : 0);
+    return result;
+}
+
+MatrixError GF2Matrix_Rank(const GF2Matrix* m, size_t* rank) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_GF2_RANK);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_GF2_RANK), m ? m->rows : 0, m ? m->cols : 0);
+    MatrixError err = gf2_rank_impl(m, rank);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * m->rows * m->cols * m->cols / 3 : 0);
+    return err;
+}
+
+MatrixError GF2Matrix_Solve(const GF2Matrix* a, const GF2Matrix* b, GF2Matrix* x) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_GF2_SOLVE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_GF2_SOLVE), a ? a->rows : 0, a ? a->cols : 0);
+    MatrixError err = gf2_solve_impl(a, b, x);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * a->rows * a->cols * (a->cols + b->cols) / 3 : 0);
+    return err;
+}
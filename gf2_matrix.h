@@ -0,0 +1,33 @@
+#ifndef GF2_MATRIX_H
+#define GF2_MATRIX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+
+//Матрица над GF(2): 64 элемента в слове, строка занимает stride слов,
+//бит j строки - (words[j / 64] >> (j % 64)) & 1. Хвост последнего слова нулевой.
+typedef struct {
+    uint64_t* words;
+    size_t rows;
+    size_t cols;
+    size_t stride;
+} GF2Matrix;
+
+GF2Matrix* GF2Matrix_Create(size_t rows, size_t cols);
+void GF2Matrix_Destroy(GF2Matrix* m);
+
+MatrixError GF2Matrix_Get(const GF2Matrix* m, size_t row, size_t col, int* out);
+MatrixError GF2Matrix_Set(GF2Matrix* m, size_t row, size_t col, int bit);
+
+//Из int-матрицы или GF(2) (CreateModularFieldInfo(2)) берется младший бит
+GF2Matrix* GF2Matrix_FromMatrix(const Matrix* m, MatrixError* error);
+Matrix* GF2Matrix_ToMatrix(const GF2Matrix* m, MatrixError* error);
+
+//Умножение методом четырех русских (M4RM)
+GF2Matrix* GF2Matrix_Multiply(const GF2Matrix* a, const GF2Matrix* b, MatrixError* error);
+//Ранг и решение AX = B через исключение M4RI; B может иметь несколько столбцов
+MatrixError GF2Matrix_Rank(const GF2Matrix* m, size_t* rank);
+MatrixError GF2Matrix_Solve(const GF2Matrix* a, const GF2Matrix* b, GF2Matrix* x);
+
+#endif
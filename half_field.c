@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "field.h"
+#include "half_field.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define HALF_HAVE_F16C_DISPATCH 1
+#endif
+
+static const uint16_t g_half_zero = 0;
+static const uint16_t g_half_one = 0x3C00;
+static const uint16_t g_bfloat16_one = 0x3F80;
+
+static uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+//Программное преобразование IEEE binary16 с округлением к ближайшему четному
+uint16_t HalfFromFloat(float value) {
+    uint32_t bits = float_bits(value);
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000u);
+    uint32_t abs_bits = bits & 0x7FFFFFFFu;
+
+    if (abs_bits >= 0x7F800000u) {
+        //Inf или NaN (NaN остается "тихим")
+        return (uint16_t)(sign | 0x7C00u | (abs_bits > 0x7F800000u ? 0x0200u : 0));
+    }
+    if (abs_bits >= 0x477FF000u) {
+        //Переполнение после округления
+        return (uint16_t)(sign | 0x7C00u);
+    }
+    if (abs_bits < 0x38800000u) {
+        //Субнормальные числа и ноль
+        if (abs_bits < 0x33000000u) return sign;
+        uint32_t mantissa = (abs_bits & 0x007FFFFFu) | 0x00800000u;
+        int shift = 126 - (int)(abs_bits >> 23);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t rounded = abs_bits + 0x0FFFu + ((abs_bits >> 13) & 1u);
+    return (uint16_t)(sign | ((rounded - 0x38000000u) >> 13));
+}
+
+float HalfToFloat(uint16_t value) {
+    uint32_t sign = (uint32_t)(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x03FFu;
+
+    if (exponent == 0x1Fu) {
+        return bits_float(sign | 0x7F800000u | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        //Субнормальное: mantissa * 2^-24
+        float magnitude = (float)mantissa * (1.0f / 16777216.0f);
+        return sign ? -magnitude : magnitude;
+    }
+    return bits_float(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+uint16_t BFloat16FromFloat(float value) {
+    uint32_t bits = float_bits(value);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        return (uint16_t)((bits >> 16) | 0x0040u);
+    }
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return (uint16_t)(bits >> 16);
+}
+
+float BFloat16ToFloat(uint16_t value) {
+    return bits_float((uint32_t)value << 16);
+}
+
+//Пакетные преобразования
+static void HalfToFloatSoftware(float* dest, const void* src, size_t count) {
+    const uint16_t* h = (const uint16_t*)src;
+    for (size_t i = 0; i < count; i++) dest[i] = HalfToFloat(h[i]);
+}
+
+static void HalfFromFloatSoftware(void* dest, const float* src, size_t count) {
+    uint16_t* h = (uint16_t*)dest;
+    for (size_t i = 0; i < count; i++) h[i] = HalfFromFloat(src[i]);
+}
+
+#ifdef HALF_HAVE_F16C_DISPATCH
+
+__attribute__((target("avx,f16c")))
+static void HalfToFloatF16C(float* dest, const void* src, size_t count) {
+    const uint16_t* h = (const uint16_t*)src;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i packed = _mm_loadu_si128((const __m128i*)(h + i));
+        _mm256_storeu_ps(dest + i, _mm256_cvtph_ps(packed));
+    }
+    for (; i < count; i++) dest[i] = HalfToFloat(h[i]);
+}
+
+__attribute__((target("avx,f16c")))
+static void HalfFromFloatF16C(void* dest, const float* src, size_t count) {
+    uint16_t* h = (uint16_t*)dest;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(h + i), packed);
+    }
+    for (; i < count; i++) h[i] = HalfFromFloat(src[i]);
+}
+
+#endif
+
+//Описание типа статическое, поэтому реализация выбирается при вызове
+static void HalfToFloatBulk(float* dest, const void* src, size_t count) {
+#ifdef HALF_HAVE_F16C_DISPATCH
+    if (__builtin_cpu_supports("f16c") && __builtin_cpu_supports("avx")) {
+        HalfToFloatF16C(dest, src, count);
+        return;
+    }
+#endif
+    HalfToFloatSoftware(dest, src, count);
+}
+
+static void HalfFromFloatBulk(void* dest, const float* src, size_t count) {
+#ifdef HALF_HAVE_F16C_DISPATCH
+    if (__builtin_cpu_supports("f16c") && __builtin_cpu_supports("avx")) {
+        HalfFromFloatF16C(dest, src, count);
+        return;
+    }
+#endif
+    HalfFromFloatSoftware(dest, src, count);
+}
+
+static void BFloat16ToFloatBulk(float* dest, const void* src, size_t count) {
+    const uint16_t* h = (const uint16_t*)src;
+    for (size_t i = 0; i < count; i++) dest[i] = BFloat16ToFloat(h[i]);
+}
+
+static void BFloat16FromFloatBulk(void* dest, const float* src, size_t count) {
+    uint16_t* h = (uint16_t*)dest;
+    for (size_t i = 0; i < count; i++) h[i] = BFloat16FromFloat(src[i]);
+}
+
+//Поэлементные операции: через float
+#define DEFINE_HALF_OPS(prefix, to_f, from_f)                                  \
+    static void prefix##Reader(const FieldInfo* field, void* dest, FILE* src) {\
+        (void)field;                                                           \
+        float value = 0.0f;                                                    \
+        fscanf(src, "%f", &value);                                             \
+        *(uint16_t*)dest = from_f(value);                                      \
+    }                                                                          \
+    static void prefix##Printer(const FieldInfo* field, const void* data,      \
+                                FILE* dest) {                                  \
+        (void)field;                                                           \
+        fprintf(dest, "%.2f", to_f(*(const uint16_t*)data));                   \
+    }                                                                          \
+    static void prefix##Adder(const FieldInfo* field, void* result,            \
+                              const void* a, const void* b) {                  \
+        (void)field;                                                           \
+        *(uint16_t*)result = from_f(to_f(*(const uint16_t*)a) +                \
+                                    to_f(*(const uint16_t*)b));                \
+    }                                                                          \
+    static void prefix##Subtractor(const FieldInfo* field, void* result,       \
+                                   const void* a, const void* b) {             \
+        (void)field;                                                           \
+        *(uint16_t*)result = from_f(to_f(*(const uint16_t*)a) -                \
+                                    to_f(*(const uint16_t*)b));                \
+    }                                                                          \
+    static void prefix##Multiplier(const FieldInfo* field, void* result,       \
+                                   const void* a, const void* b) {             \
+        (void)field;                                                           \
+        *(uint16_t*)result = from_f(to_f(*(const uint16_t*)a) *                \
+                                    to_f(*(const uint16_t*)b));                \
+    }                                                                          \
+    static void prefix##Divider(const FieldInfo* field, void* result,          \
+                                const void* a, const void* b) {                \
+        (void)field;                                                           \
+        float divisor = to_f(*(const uint16_t*)b);                             \
+        if (divisor != 0.0f) {                                                 \
+            *(uint16_t*)result = from_f(to_f(*(const uint16_t*)a) / divisor);  \
+        }                                                                      \
+    }                                                                          \
+    static double prefix##Abs(const FieldInfo* field, const void* a) {         \
+        (void)field;                                                           \
+        float value = to_f(*(const uint16_t*)a);                               \
+        return value < 0.0f ? -value : value;                                  \
+    }                                                                          \
+    static int prefix##IsZero(const FieldInfo* field, const void* a) {         \
+        (void)field;                                                           \
+        return to_f(*(const uint16_t*)a) == 0.0f;                              \
+    }
+
+DEFINE_HALF_OPS(Half, HalfToFloat, HalfFromFloat)
+DEFINE_HALF_OPS(BFloat16, BFloat16ToFloat, BFloat16FromFloat)
+
+//Инициализация
+static const FieldInfo g_half_field_info = {
+    .size = sizeof(uint16_t),
+    .name = "half",
+    .read = HalfReader,
+    .print = HalfPrinter,
+    .add = HalfAdder,
+    .sub = HalfSubtractor,
+    .mul = HalfMultiplier,
+    .div = HalfDivider,
+    .abs = HalfAbs,
+    .is_zero = HalfIsZero,
+    .to_float = HalfToFloatBulk,
+    .from_float = HalfFromFloatBulk,
+    .modulus = 0,
+    .zero = &g_half_zero,
+    .one = &g_half_one,
+    .id = FIELD_ID_HALF,
+};
+
+static const FieldInfo g_bfloat16_field_info = {
+    .size = sizeof(uint16_t),
+    .name = "bfloat16",
+    .read = BFloat16Reader,
+    .print = BFloat16Printer,
+    .add = BFloat16Adder,
+    .sub = BFloat16Subtractor,
+    .mul = BFloat16Multiplier,
+    .div = BFloat16Divider,
+    .abs = BFloat16Abs,
+    .is_zero = BFloat16IsZero,
+    .to_float = BFloat16ToFloatBulk,
+    .from_float = BFloat16FromFloatBulk,
+    .modulus = 0,
+    .zero = &g_half_zero,
+    .one = &g_bfloat16_one,
+    .id = FIELD_ID_BFLOAT16,
+};
+
+const FieldInfo* GetHalfFieldInfo(void) {
+    return &g_half_field_info;
+}
+
+const FieldInfo* GetBFloat16FieldInfo(void) {
+    return &g_bfloat16_field_info;
+}
@@ -0,0 +1,17 @@
+#ifndef HALF_FIELD_H
+#define HALF_FIELD_H
+
+#include <stdint.h>
+#include "field.h"
+
+//2-байтовые вещественные типы: хранение в half/bfloat16,
+//вычисления во float
+const FieldInfo* GetHalfFieldInfo(void);
+const FieldInfo* GetBFloat16FieldInfo(void);
+
+uint16_t HalfFromFloat(float value);
+float HalfToFloat(uint16_t value);
+uint16_t BFloat16FromFloat(float value);
+float BFloat16ToFloat(uint16_t value);
+
+#endif
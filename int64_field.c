@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include "field.h"
+#include "int64_field.h"
+
+static const int64_t g_int64_zero = 0;
+static const int64_t g_int64_one = 1;
+
+static void Int64Reader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
+    fscanf(src, "%" SCNd64, (int64_t*)dest);
+}
+
+static void Int64Printer(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
+    fprintf(dest, "%" PRId64, *(const int64_t*)data);
+}
+
+//Переполнение по модулю 2^64 через uint64_t, без неопределенного поведения
+static void Int64Adder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int64_t*)result = (int64_t)((uint64_t)*(const int64_t*)a + (uint64_t)*(const int64_t*)b);
+}
+
+static void Int64Subtractor(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int64_t*)result = (int64_t)((uint64_t)*(const int64_t*)a - (uint64_t)*(const int64_t*)b);
+}
+
+static void Int64Multiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int64_t*)result = (int64_t)((uint64_t)*(const int64_t*)a * (uint64_t)*(const int64_t*)b);
+}
+
+static void Int64Divider(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    int64_t divisor = *(const int64_t*)b;
+    int64_t dividend = *(const int64_t*)a;
+    if (divisor != 0 && !(divisor == -1 && dividend == INT64_MIN)) {
+        *(int64_t*)result = dividend / divisor;
+    }
+}
+
+static double Int64Abs(const FieldInfo* field, const void* a) {
+    (void)field;
+    int64_t value = *(const int64_t*)a;
+    return value < 0 ? -(double)value : (double)value;
+}
+
+static int Int64IsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const int64_t*)a == 0;
+}
+
+//Инициализация
+static const FieldInfo g_int64_field_info = {
+    .size = sizeof(int64_t),
+    .name = "int64",
+    .read = Int64Reader,
+    .print = Int64Printer,
+    .add = Int64Adder,
+    .sub = Int64Subtractor,
+    .mul = Int64Multiplier,
+    .div = Int64Divider,
+    .abs = Int64Abs,
+    .is_zero = Int64IsZero,
+    .to_float = NULL,
+    .from_float = NULL,
+    .modulus = 0,
+    .zero = &g_int64_zero,
+    .one = &g_int64_one,
+    .id = FIELD_ID_INT64,
+};
+
+const FieldInfo* GetInt64FieldInfo(void) {
+    return &g_int64_field_info;
+}
@@ -0,0 +1,9 @@
+#ifndef INT64_FIELD_H
+#define INT64_FIELD_H
+
+#include "field.h"
+
+//Знаковые 64-битные целые; переполнение по модулю 2^64, как у int по модулю 2^32
+const FieldInfo* GetInt64FieldInfo(void);
+
+#endif
@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "field.h"
+#include "int8_field.h"
+
+static const int8_t g_int8_zero = 0;
+static const int8_t g_int8_one = 1;
+
+static void Int8Reader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
+    int value = 0;
+    fscanf(src, "%d", &value);
+    *(int8_t*)dest = (int8_t)value;
+}
+
+static void Int8Printer(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
+    fprintf(dest, "%d", (int)*(const int8_t*)data);
+}
+
+static void Int8Adder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int8_t*)result = (int8_t)(*(const int8_t*)a + *(const int8_t*)b);
+}
+
+static void Int8Subtractor(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int8_t*)result = (int8_t)(*(const int8_t*)a - *(const int8_t*)b);
+}
+
+static void Int8Multiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(int8_t*)result = (int8_t)(*(const int8_t*)a * *(const int8_t*)b);
+}
+
+static void Int8Divider(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    int divisor = *(const int8_t*)b;
+    if (divisor != 0) {
+        *(int8_t*)result = (int8_t)(*(const int8_t*)a / divisor);
+    }
+}
+
+static double Int8Abs(const FieldInfo* field, const void* a) {
+    (void)field;
+    int value = *(const int8_t*)a;
+    return value < 0 ? -value : value;
+}
+
+static int Int8IsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const int8_t*)a == 0;
+}
+
+//Инициализация
+static const FieldInfo g_int8_field_info = {
+    .size = sizeof(int8_t),
+    .name = "int8",
+    .read = Int8Reader,
+    .print = Int8Printer,
+    .add = Int8Adder,
+    .sub = Int8Subtractor,
+    .mul = Int8Multiplier,
+    .div = Int8Divider,
+    .abs = Int8Abs,
+    .is_zero = Int8IsZero,
+    .to_float = NULL,
+    .from_float = NULL,
+    .modulus = 0,
+    .zero = &g_int8_zero,
+    .one = &g_int8_one,
+    .id = FIELD_ID_INT8,
+};
+
+const FieldInfo* GetInt8FieldInfo(void) {
+    return &g_int8_field_info;
+}
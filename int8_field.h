@@ -0,0 +1,9 @@
+#ifndef INT8_FIELD_H
+#define INT8_FIELD_H
+
+#include "field.h"
+
+//Знаковые 8-битные целые (хранение квантованных матриц)
+const FieldInfo* GetInt8FieldInfo(void);
+
+#endif
@@ -1,9 +1,30 @@
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
 #include "matrix.h"
 #include "field.h"         
 #include "int_field.h"      
 #include "float_field.h" 
+#include "modular_field.h"
+#include "matrix_modular.h"
+#include "matrix_bareiss.h"
+#include "semiring_field.h"
+#include "matrix_semiring.h"
+#include "complex_field.h"
+#include "matrix_complex.h"
+#include "double_field.h"
+#include "int64_field.h"
+#include "matrix_wide.h"
+#include "matrix_lu.h"
+#include "matrix_multiply.h"
+#include "matrix_buffer.h"
+#include "matrix_cache.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+#define ROWS_OF(m) ((m) ? (m)->rows : 0)
+#define COLS_OF(m) ((m) ? (m)->cols : 0)
 
 static size_t matrix_index(const Matrix* m, size_t row, size_t col) {
     return row * m->cols + col;
@@ -14,11 +35,84 @@ static void* matrix_element_ptr(const Matrix* m, size_t row, size_t col) {
     return (char*)m->data + idx * m->type->size;
 }
 
+//Одно сравнение номеров (и модуля для GF(p)), если оба типа зарегистрированы;
+//иначе сравнение по имени, одинаковое при любом порядке аргументов
+static bool fields_equal(const FieldInfo* a, const FieldInfo* b) {
+    if (a == b) return true;
+    if (a->id != FIELD_ID_NONE && b->id != FIELD_ID_NONE) return a->id == b->id && a->modulus == b->modulus;
+    return FieldInfo_Equals(a, b);
+}
+
 static bool types_compatible(const Matrix* a, const Matrix* b) {
-    return FieldInfo_Equals(a->type, b->type);
+    return fields_equal(a->type, b->type);
 }
 
-Matrix* Matrix_Create(size_t rows, size_t cols, const FieldInfo* type) {
+//Вещественные типы (float, half, bfloat16) считаются во float
+static bool float_convertible(const Matrix* m) {
+    return m->type->to_float && m->type->from_float;
+}
+
+//Смешанные операции разрешены явно для вещественных типов
+static bool types_mixable(const Matrix* a, const Matrix* b) {
+    return types_compatible(a, b) || (float_convertible(a) && float_convertible(b));
+}
+
+//Тип результата смешанной операции: более широкий из двух,
+//half x bfloat16 дает float
+static const FieldInfo* promoted_type(const FieldInfo* a, const FieldInfo* b) {
+    if (fields_equal(a, b)) return a;
+    if (a->size > b->size) return a;
+    if (b->size > a->size) return b;
+    return GetFloatFieldInfo();
+}
+
+//Данные матрицы как float: для float без копии, иначе преобразованная копия
+static float* matrix_load_float(const Matrix* m, bool* owned) {
+    if (m->type == GetFloatFieldInfo()) {
+        *owned = false;
+        return (float*)m->data;
+    }
+    
+    size_t total = m->rows * m->cols;
+    float* buffer = (float*)malloc(total * sizeof(float));
+    if (!buffer) return NULL;
+    m->type->to_float(buffer, m->data, total);
+    *owned = true;
+    return buffer;
+}
+
+//C = A * B во float: порядок i-k-j дает непрерывный доступ к B и C
+static void float_gemm(const float* a, const float* b, float* c,
+                       size_t m, size_t k, size_t n) {
+    memset(c, 0, m * n * sizeof(float));
+    for (size_t i = 0; i < m; i++) {
+        float* c_row = c + i * n;
+        for (size_t p = 0; p < k; p++) {
+            float a_ip = a[i * k + p];
+            const float* b_row = b + p * n;
+            for (size_t j = 0; j < n; j++) {
+                c_row[j] += a_ip * b_row[j];
+            }
+        }
+    }
+}
+
+//Нейтральный элемент сложения, если он не из нулевых байтов (min-plus: +inf).
+//Без zero нуль типа - нулевые байты, которые уже записаны
+static void fill_zero(Matrix* m) {
+    const unsigned char* zero = (const unsigned char*)m->type->zero;
+    if (!zero) return;
+    size_t nonzero = 0;
+    while (nonzero < m->type->size && zero[nonzero] == 0) nonzero++;
+    if (nonzero == m->type->size) return;
+    
+    size_t total = m->rows * m->cols;
+    for (size_t i = 0; i < total; i++) {
+        memcpy((char*)m->data + i * m->type->size, m->type->zero, m->type->size);
+    }
+}
+
+static Matrix* matrix_create_impl(size_t rows, size_t cols, const FieldInfo* type) {
     if (!type || rows == 0 || cols == 0) return NULL;
     
     Matrix* m = (Matrix*)malloc(sizeof(Matrix));
@@ -29,24 +123,25 @@ Matrix* Matrix_Create(size_t rows, size_t cols, const FieldInfo* type) {
     m->type = type;
     
     size_t total = rows * cols * type->size;
-    m->data = malloc(total);
-    if (!m->data) {
+    m->buffer = matrix_buffer_create(total, &m->data);
+    if (!m->buffer) {
         free(m);
         return NULL;
     }
     
     memset(m->data, 0, total);
+    fill_zero(m);
     return m;
 }
 
-void Matrix_Destroy(Matrix* m) {
+static void matrix_destroy_impl(Matrix* m) {
     if (m) {
-        free(m->data);
+        matrix_buffer_release(m->buffer);
         free(m);
     }
 }
 //Ошибки
-MatrixError Matrix_Get(const Matrix* m, size_t row, size_t col, void* out) {
+static MatrixError matrix_get_impl(const Matrix* m, size_t row, size_t col, void* out) {
     if (!m || !out) return MATRIX_ERROR_NULL_POINTER;
     if (!m->data || !m->type) return MATRIX_ERROR_TYPE_MISMATCH;
     if (row >= m->rows || col >= m->cols) return MATRIX_ERROR_INVALID_INDEX;
@@ -56,17 +151,143 @@ MatrixError Matrix_Get(const Matrix* m, size_t row, size_t col, void* out) {
     return MATRIX_OK;
 }
 
-MatrixError Matrix_Set(Matrix* m, size_t row, size_t col, const void* value) {
+static MatrixError matrix_set_impl(Matrix* m, size_t row, size_t col, const void* value) {
     if (!m || !value) return MATRIX_ERROR_NULL_POINTER;
     if (!m->data || !m->type) return MATRIX_ERROR_TYPE_MISMATCH;
     if (row >= m->rows || col >= m->cols) return MATRIX_ERROR_INVALID_INDEX;
+    MatrixError err = matrix_make_writable(m);
+    if (err != MATRIX_OK) return err;
     
     void* ptr = matrix_element_ptr(m, row, col);
     memcpy(ptr, value, m->type->size);
     return MATRIX_OK;
 }
 
-Matrix* Matrix_Add(const Matrix* a, const Matrix* b, MatrixError* error) {
+//Аккумулятор на 128 бит для строк, где сумма может не уместиться в int64
+typedef struct {
+    int64_t hi;
+    uint64_t lo;
+} Acc128;
+
+static void acc128_add(Acc128* acc, int64_t value) {
+    uint64_t lo = acc->lo + (uint64_t)value;
+    acc->hi += (value < 0 ? -1 : 0) + (lo < acc->lo ? 1 : 0);
+    acc->lo = lo;
+}
+
+static uint64_t abs_int(int value) {
+    return value < 0 ? (uint64_t)(-(int64_t)value) : (uint64_t)value;
+}
+
+//Запись суммы в int с учетом режима; возвращает false при переполнении
+static bool store_int_result(int* dest, int64_t value, bool fits_int64, const Acc128* wide,
+                             MatrixOverflowMode mode) {
+    bool negative = fits_int64 ? value < 0 : wide->hi < 0;
+    bool fits = fits_int64 ? (value >= INT_MIN && value <= INT_MAX)
+                           : ((wide->hi == 0 && wide->lo <= (uint64_t)INT_MAX) ||
+                              (wide->hi == -1 && wide->lo >= (uint64_t)(int64_t)INT_MIN));
+    if (fits) {
+        *dest = (int)(fits_int64 ? value : (int64_t)wide->lo);
+        return true;
+    }
+    
+    if (mode == MATRIX_OVERFLOW_WRAP) {
+        uint32_t low = (uint32_t)(fits_int64 ? (uint64_t)value : wide->lo);
+        *dest = (low > (uint32_t)INT_MAX) ? -(int)(~low) - 1 : (int)low;
+    } else {
+        *dest = negative ? INT_MIN : INT_MAX;
+    }
+    return false;
+}
+
+//C = A * B для int с накоплением в int64. Если оценка max|a|*max|b|*k
+//не помещается в int64, строка считается со 128-битным аккумулятором. Для
+//перехода через 2^32 без отчета точное значение не нужно: младшие 32 бита
+//суммы по модулю 2^64 те же, и такие строки считаются обычным проходом
+static size_t int_gemm(const int* a, const int* b, int* c, size_t m, size_t k, size_t n,
+                       MatrixOverflowMode mode, MatrixOverflowReport* report) {
+    uint64_t* acc = (uint64_t*)malloc(n * sizeof(uint64_t));
+    if (!acc) return (size_t)-1;
+    bool exact = mode != MATRIX_OVERFLOW_WRAP || report != NULL;
+    
+    uint64_t b_max = 0;
+    for (size_t idx = 0; idx < k * n; idx++) {
+        if (abs_int(b[idx]) > b_max) b_max = abs_int(b[idx]);
+    }
+    
+    size_t overflows = 0;
+    for (size_t i = 0; i < m; i++) {
+        const int* a_row = a + i * k;
+        uint64_t a_max = 0;
+        for (size_t p = 0; p < k; p++) {
+            if (abs_int(a_row[p]) > a_max) a_max = abs_int(a_row[p]);
+        }
+        
+        bool safe = a_max == 0 || b_max == 0 || a_max * b_max <= (uint64_t)INT64_MAX / k;
+        bool wide_row = !safe && exact;
+        
+        for (size_t j = 0; j < n; j++) acc[j] = 0;
+        if (!wide_row) {
+            //Беззнаковая арифметика: для безопасной строки это та же сумма int64
+            for (size_t p = 0; p < k; p++) {
+                uint64_t a_ip = (uint64_t)(int64_t)a_row[p];
+                const int* b_row = b + p * n;
+                for (size_t j = 0; j < n; j++) {
+                    acc[j] += a_ip * (uint64_t)(int64_t)b_row[j];
+                }
+            }
+        }
+        
+        for (size_t j = 0; j < n; j++) {
+            Acc128 wide = {0, 0};
+            if (wide_row) {
+                for (size_t p = 0; p < k; p++) {
+                    acc128_add(&wide, (int64_t)a_row[p] * (int64_t)b[p * n + j]);
+                }
+            }
+            if (!store_int_result(&c[i * n + j], (int64_t)acc[j], !wide_row, &wide, mode)) {
+                if (overflows == 0 && report) {
+                    report->first_row = i;
+                    report->first_col = j;
+                }
+                overflows++;
+            }
+        }
+    }
+    
+    free(acc);
+    if (report) report->overflow_count = overflows;
+    return overflows;
+}
+
+//Сложение разных вещественных типов через float
+static Matrix* add_via_float(const Matrix* a, const Matrix* b, MatrixError* error) {
+    Matrix* result = Matrix_Create(a->rows, a->cols, promoted_type(a->type, b->type));
+    bool a_owned, b_owned;
+    float* fa = matrix_load_float(a, &a_owned);
+    float* fb = matrix_load_float(b, &b_owned);
+    size_t total = a->rows * a->cols;
+    float* sum = (float*)malloc(total * sizeof(float));
+    
+    if (!result || !fa || !fb || !sum) {
+        if (a_owned) free(fa);
+        if (b_owned) free(fb);
+        free(sum);
+        Matrix_Destroy(result);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < total; i++) sum[i] = fa[i] + fb[i];
+    result->type->from_float(result->data, sum, total);
+    
+    if (a_owned) free(fa);
+    if (b_owned) free(fb);
+    free(sum);
+    return result;
+}
+
+static Matrix* matrix_add_impl(const Matrix* a, const Matrix* b, MatrixError* error) {
     if (error) *error = MATRIX_OK;
     
     if (!a || !b) {
@@ -74,7 +295,7 @@ Matrix* Matrix_Add(const Matrix* a, const Matrix* b, MatrixError* error) {
         return NULL;
     }
     
-    if (!types_compatible(a, b)) {
+    if (!types_mixable(a, b)) {
         if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
         return NULL;
     }
@@ -84,6 +305,10 @@ Matrix* Matrix_Add(const Matrix* a, const Matrix* b, MatrixError* error) {
         return NULL;
     }
     
+    if (!types_compatible(a, b)) {
+        return add_via_float(a, b, error);
+    }
+    
     Matrix* result = Matrix_Create(a->rows, a->cols, a->type);
     if (!result) {
         if (error) *error = MATRIX_ERROR_MEMORY;
@@ -91,25 +316,196 @@ Matrix* Matrix_Add(const Matrix* a, const Matrix* b, MatrixError* error) {
     }
     
     size_t total = a->rows * a->cols;
+    if (a->type == GetDoubleFieldInfo()) {
+        double_add((const double*)a->data, (const double*)b->data, (double*)result->data, total);
+        return result;
+    }
+    if (a->type == GetInt64FieldInfo()) {
+        int64_add((const int64_t*)a->data, (const int64_t*)b->data, (int64_t*)result->data, total);
+        return result;
+    }
+    
     for (size_t i = 0; i < total; i++) {
         void* a_ptr = (char*)a->data + i * a->type->size;
         void* b_ptr = (char*)b->data + i * b->type->size;
         void* r_ptr = (char*)result->data + i * result->type->size;
-        a->type->add(r_ptr, a_ptr, b_ptr);
+        a->type->add(a->type, r_ptr, a_ptr, b_ptr);
     }
     
     return result;
 }
 
-Matrix* Matrix_Multiply(const Matrix* a, const Matrix* b, MatrixError* error) {
+//Умножение вещественных типов: упаковка во float, ядро с float-аккумуляторами,
+//запись результата в тип результата
+static Matrix* multiply_via_float(const Matrix* a, const Matrix* b, MatrixError* error) {
+    const FieldInfo* type = promoted_type(a->type, b->type);
+    Matrix* result = Matrix_Create(a->rows, b->cols, type);
+    if (!result) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    MATRIX_TRACE_BEGIN(pack_span, "multiply_pack", a->rows, b->cols);
+    bool a_owned = false, b_owned = false, c_owned = false;
+    float* fa = matrix_load_float(a, &a_owned);
+    float* fb = matrix_load_float(b, &b_owned);
+    float* fc = (type == GetFloatFieldInfo()) ? (float*)result->data
+                                              : (float*)malloc(a->rows * b->cols * sizeof(float));
+    c_owned = (fc != result->data);
+    MATRIX_TRACE_END(pack_span);
+    
+    if (!fa || !fb || !fc) {
+        if (a_owned) free(fa);
+        if (b_owned) free(fb);
+        if (c_owned) free(fc);
+        Matrix_Destroy(result);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    MATRIX_TRACE_BEGIN(kernel_span, "multiply_kernel", a->rows, b->cols);
+    float_gemm(fa, fb, fc, a->rows, a->cols, b->cols);
+    MATRIX_TRACE_END(kernel_span);
+    
+    if (c_owned) {
+        type->from_float(result->data, fc, a->rows * b->cols);
+        free(fc);
+    }
+    if (a_owned) free(fa);
+    if (b_owned) free(fb);
+    return result;
+}
+
+//Специализированное ядро по номеру типа: false, если его нет и нужен общий цикл.
+//*ok = false при нехватке памяти внутри ядра
+static bool multiply_dedicated(const Matrix* a, const Matrix* b, Matrix* c, bool* ok) {
+    size_t m = a->rows, k = a->cols, n = b->cols;
+    *ok = true;
+    
+    switch (a->type->id) {
+        case FIELD_ID_FLOAT:
+            float_gemm((const float*)a->data, (const float*)b->data, (float*)c->data, m, k, n);
+            return true;
+        case FIELD_ID_MINPLUS:
+            minplus_gemm((const float*)a->data, (const float*)b->data, (float*)c->data, m, k, n);
+            return true;
+        case FIELD_ID_BOOL:
+            bool_gemm((const uint8_t*)a->data, (const uint8_t*)b->data, (uint8_t*)c->data, m, k, n);
+            return true;
+        case FIELD_ID_DOUBLE:
+            double_gemm((const double*)a->data, (const double*)b->data, (double*)c->data, m, k, n);
+            return true;
+        case FIELD_ID_INT64:
+            int64_gemm((const int64_t*)a->data, (const int64_t*)b->data, (int64_t*)c->data, m, k, n);
+            return true;
+        case FIELD_ID_COMPLEX:
+            complex_gemm((const ComplexFloat*)a->data, (const ComplexFloat*)b->data, (ComplexFloat*)c->data,
+                         m, k, n);
+            return true;
+        case FIELD_ID_MODULAR:
+            *ok = modular_gemm(modular_info(a->type), (const uint32_t*)a->data, (const uint32_t*)b->data,
+                               (uint32_t*)c->data, m, k, n);
+            return true;
+        //int: прежняя семантика переполнения (по модулю 2^32), но без UB
+        case FIELD_ID_INT:
+            *ok = int_gemm((const int*)a->data, (const int*)b->data, (int*)c->data, m, k, n,
+                           MATRIX_OVERFLOW_WRAP, NULL) != (size_t)-1;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool matrix_multiply_into(const Matrix* a, const Matrix* b, Matrix* c) {
+    bool ok = true;
+    if (multiply_dedicated(a, b, c, &ok)) return ok;
+    
+    char temp[16];
+    for (size_t i = 0; i < a->rows; i++) {
+        for (size_t j = 0; j < b->cols; j++) {
+            void* r_ptr = matrix_element_ptr(c, i, j);
+            Field_CopyZero(a->type, r_ptr);
+            
+            for (size_t k = 0; k < a->cols; k++) {
+                void* a_ptr = matrix_element_ptr(a, i, k);
+                void* b_ptr = matrix_element_ptr(b, k, j);
+                
+                a->type->mul(a->type, temp, a_ptr, b_ptr);
+                a->type->add(a->type, r_ptr, r_ptr, temp);
+            }
+        }
+    }
+    return true;
+}
+
+static Matrix* multiply_compute(const Matrix* a, const Matrix* b, MatrixError* error) {
+    if (float_convertible(a) && float_convertible(b)) {
+        return multiply_via_float(a, b, error);
+    }
+    
+    Matrix* result = Matrix_Create(a->rows, b->cols, a->type);
+    if (!result) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    MATRIX_TRACE_BEGIN(kernel_span, "multiply_kernel", a->rows, b->cols);
+    bool ok = matrix_multiply_into(a, b, result);
+    MATRIX_TRACE_END(kernel_span);
+    if (!ok) {
+        Matrix_Destroy(result);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    return result;
+}
+
+//При включенном кэше повторное произведение тех же операндов - клон готового результата
+static Matrix* matrix_multiply_impl(const Matrix* a, const Matrix* b, unsigned long long* flops,
+                                    MatrixError* error) {
     if (error) *error = MATRIX_OK;
+    *flops = 0;
     
     if (!a || !b) {
         if (error) *error = MATRIX_ERROR_NULL_POINTER;
         return NULL;
     }
     
-    if (!types_compatible(a, b)) {
+    if (!types_mixable(a, b)) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+    
+    if (a->cols != b->rows) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+    
+    MatrixCacheKey key;
+    bool cacheable = matrix_cache_key(&key, MATRIX_CACHE_PRODUCT, a, b);
+    Matrix* result = cacheable ? matrix_cache_find(&key, promoted_type(a->type, b->type), NULL) : NULL;
+    if (result) return result;
+    
+    result = multiply_compute(a, b, error);
+    if (result) {
+        *flops = 2ULL * a->rows * a->cols * b->cols;
+        if (cacheable) matrix_cache_store(&key, result, NULL);
+    }
+    return result;
+}
+
+static Matrix* matrix_multiply_checked_impl(const Matrix* a, const Matrix* b, MatrixOverflowMode mode,
+                                            MatrixOverflowReport* report, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    if (report) memset(report, 0, sizeof(*report));
+    
+    if (!a || !b) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    
+    if (a->type != GetIntFieldInfo() || b->type != GetIntFieldInfo()) {
         if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
         return NULL;
     }
@@ -125,28 +521,27 @@ Matrix* Matrix_Multiply(const Matrix* a, const Matrix* b, MatrixError* error) {
         return NULL;
     }
     
-    char temp[16];
+    MATRIX_TRACE_BEGIN(kernel_span, "multiply_checked_kernel", a->rows, b->cols);
+    size_t overflows = int_gemm((const int*)a->data, (const int*)b->data, (int*)result->data,
+                                a->rows, a->cols, b->cols, mode, report);
+    MATRIX_TRACE_END(kernel_span);
     
-    for (size_t i = 0; i < a->rows; i++) {
-        for (size_t j = 0; j < b->cols; j++) {
-            void* r_ptr = matrix_element_ptr(result, i, j);
-            memset(r_ptr, 0, a->type->size);
-            
-            for (size_t k = 0; k < a->cols; k++) {
-                void* a_ptr = matrix_element_ptr(a, i, k);
-                void* b_ptr = matrix_element_ptr(b, k, j);
-                
-                a->type->mul(temp, a_ptr, b_ptr);
-                a->type->add(r_ptr, r_ptr, temp);
-            }
-        }
+    if (overflows == (size_t)-1) {
+        Matrix_Destroy(result);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    if (overflows > 0 && mode == MATRIX_OVERFLOW_ERROR) {
+        Matrix_Destroy(result);
+        if (error) *error = MATRIX_ERROR_OVERFLOW;
+        return NULL;
     }
     
     return result;
 }
 
-
-Matrix* Matrix_ScalarMultiply(const Matrix* m, const void* scalar, MatrixError* error) {
+static Matrix* matrix_scalar_multiply_impl(const Matrix* m, const void* scalar, MatrixError* error) {
     if (error) *error = MATRIX_OK;
     
     if (!m || !scalar) {
@@ -154,20 +549,33 @@ Matrix* Matrix_ScalarMultiply(const Matrix* m, const void* scalar, MatrixError*
         return NULL;
     }
     
-    Matrix* result = Matrix_Clone(m, error);
-    if (!result) return NULL;
+    Matrix* result = Matrix_Create(m->rows, m->cols, m->type);
+    if (!result) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
     
     size_t total = m->rows * m->cols;
+    if (m->type == GetDoubleFieldInfo()) {
+        double_scale((const double*)m->data, *(const double*)scalar, (double*)result->data, total);
+        return result;
+    }
+    if (m->type == GetInt64FieldInfo()) {
+        int64_scale((const int64_t*)m->data, *(const int64_t*)scalar, (int64_t*)result->data, total);
+        return result;
+    }
+    
     for (size_t i = 0; i < total; i++) {
-        void* elem = (char*)result->data + i * result->type->size;
-        result->type->mul(elem, elem, scalar);
+        const void* elem = (const char*)m->data + i * m->type->size;
+        void* r_ptr = (char*)result->data + i * result->type->size;
+        result->type->mul(result->type, r_ptr, elem, scalar);
     }
     
     return result;
 }
 
-Matrix* Matrix_AddLinearCombination(const Matrix* m, size_t row_idx, 
-                                    const void* alphas, MatrixError* error) {
+static Matrix* matrix_add_linear_combination_impl(const Matrix* m, size_t row_idx, 
+                                                 const void* alphas, MatrixError* error) {
     if (error) *error = MATRIX_OK;
     
     if (!m || !alphas) {
@@ -183,31 +591,19 @@ Matrix* Matrix_AddLinearCombination(const Matrix* m, size_t row_idx,
     Matrix* result = Matrix_Clone(m, error);
     if (!result) return NULL;
     
-    char temp_sum[16];
-    char temp_mul[16];
-    
-    for (size_t j = 0; j < m->cols; j++) {
-        void* target = matrix_element_ptr(result, row_idx, j);
-        
-        memset(temp_sum, 0, m->type->size);
-        
-        for (size_t k = 0; k < m->rows; k++) {
-            if (k == row_idx) continue;
-            
-            const void* alpha = (const char*)alphas + k * m->type->size;
-            void* elem = matrix_element_ptr(m, k, j);
-            
-            m->type->mul(temp_mul, alpha, elem);
-            m->type->add(temp_sum, temp_sum, temp_mul);
-        }
-        
-        m->type->add(target, target, temp_sum);
+    //Одна операция движка строковых операций: строка коэффициентов на все строки
+    MatrixRowOp op = { row_idx, alphas };
+    MatrixError err = Matrix_ApplyRowOpList(result, &op, 1);
+    if (err != MATRIX_OK) {
+        Matrix_Destroy(result);
+        if (error) *error = err;
+        return NULL;
     }
     
     return result;
 }
 
-Matrix* Matrix_Clone(const Matrix* m, MatrixError* error) {
+static Matrix* matrix_clone_impl(const Matrix* m, MatrixError* error) {
     if (error) *error = MATRIX_OK;
     
     if (!m) {
@@ -215,20 +611,81 @@ Matrix* Matrix_Clone(const Matrix* m, MatrixError* error) {
         return NULL;
     }
     
-    Matrix* clone = Matrix_Create(m->rows, m->cols, m->type);
+    //Копируется только заголовок, данные - при первой записи
+    Matrix* clone = (Matrix*)malloc(sizeof(Matrix));
     if (!clone) {
         if (error) *error = MATRIX_ERROR_MEMORY;
         return NULL;
     }
     
-    size_t total_bytes = m->rows * m->cols * m->type->size;
-    memcpy(clone->data, m->data, total_bytes);
-    
+    *clone = *m;
+    matrix_buffer_retain(m->buffer);
     return clone;
 }
 
-MatrixError Matrix_Fill(Matrix* m, const void* value) {
+static Matrix* matrix_view_rows_impl(const Matrix* m, size_t first_row, size_t rows, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    
+    if (rows == 0 || first_row >= m->rows || rows > m->rows - first_row) {
+        if (error) *error = MATRIX_ERROR_INVALID_INDEX;
+        return NULL;
+    }
+    
+    Matrix* view = (Matrix*)malloc(sizeof(Matrix));
+    if (!view) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    *view = *m;
+    view->rows = rows;
+    view->data = (char*)m->data + first_row * m->cols * m->type->size;
+    matrix_buffer_retain(m->buffer);
+    return view;
+}
+
+static Matrix* matrix_map_file_impl(const char* path, size_t rows, size_t cols, const FieldInfo* type,
+                                    MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    
+    if (!path || !type) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    
+    if (rows == 0 || cols == 0) {
+        if (error) *error = MATRIX_ERROR_INVALID_SIZE;
+        return NULL;
+    }
+    
+    Matrix* m = (Matrix*)malloc(sizeof(Matrix));
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    MatrixError err = MATRIX_OK;
+    m->rows = rows;
+    m->cols = cols;
+    m->type = type;
+    m->buffer = matrix_buffer_map(path, rows * cols * type->size, &m->data, &err);
+    if (!m->buffer) {
+        free(m);
+        if (error) *error = err;
+        return NULL;
+    }
+    return m;
+}
+
+static MatrixError matrix_fill_impl(Matrix* m, const void* value) {
     if (!m || !value) return MATRIX_ERROR_NULL_POINTER;
+    MatrixError err = matrix_make_writable(m);
+    if (err != MATRIX_OK) return err;
     
     size_t total = m->rows * m->cols;
     for (size_t i = 0; i < total; i++) {
@@ -239,28 +696,124 @@ MatrixError Matrix_Fill(Matrix* m, const void* value) {
     return MATRIX_OK;
 }
 
-MatrixError Matrix_Identity(Matrix* m) {
+static MatrixError matrix_identity_impl(Matrix* m) {
     if (!m) return MATRIX_ERROR_NULL_POINTER;
     if (m->rows != m->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
-    
-    memset(m->data, 0, m->rows * m->cols * m->type->size);
+    if (!m->type->one) return MATRIX_ERROR_TYPE_MISMATCH;
+    MatrixError err = matrix_make_writable(m);
+    if (err != MATRIX_OK) return err;
     
     for (size_t i = 0; i < m->rows; i++) {
-        void* elem = matrix_element_ptr(m, i, i);
-        
-        if (m->type == GetIntFieldInfo()) {
-            int one = 1;
-            memcpy(elem, &one, m->type->size);
-        } else {
-            float one = 1.0f;
-            memcpy(elem, &one, m->type->size);
+        for (size_t j = 0; j < m->cols; j++) {
+            void* elem = matrix_element_ptr(m, i, j);
+            if (i == j) {
+                memcpy(elem, m->type->one, m->type->size);
+            } else {
+                Field_CopyZero(m->type, elem);
+            }
         }
     }
     
     return MATRIX_OK;
 }
 
-MatrixError Matrix_Print(const Matrix* m, const char* name, FILE* output) {
+//Число умножений при двоичном возведении в степень k
+static inline size_t power_multiplies(uint64_t k) {
+    size_t count = 0;
+    for (bool first = true; k > 0; k >>= 1) {
+        if (k & 1) {
+            if (!first) count++;
+            first = false;
+        }
+        if (k > 1) count++;
+    }
+    return count;
+}
+
+//A^k двоичным возведением: result, base и scratch создаются один раз, после
+//каждого умножения scratch и приемник меняются указателями. half и bfloat16
+//возводятся во float с одним округлением в конце
+static Matrix* matrix_power_impl(const Matrix* m, uint64_t k, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    
+    if (m->rows != m->cols) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+    
+    //A^0 - единичная матрица, для нее нужна единица типа
+    if (k == 0 && !m->type->one) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+    
+    size_t n = m->rows;
+    const FieldInfo* work_type = float_convertible(m) ? GetFloatFieldInfo() : m->type;
+    Matrix* result = Matrix_Create(n, n, work_type);
+    Matrix* base = Matrix_Create(n, n, work_type);
+    Matrix* scratch = Matrix_Create(n, n, work_type);
+    if (!result || !base || !scratch) {
+        Matrix_Destroy(result);
+        Matrix_Destroy(base);
+        Matrix_Destroy(scratch);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    if (work_type == m->type) {
+        memcpy(base->data, m->data, n * n * m->type->size);
+    } else {
+        m->type->to_float((float*)base->data, m->data, n * n);
+    }
+    
+    bool have_result = false;
+    bool ok = true;
+    while (k > 0 && ok) {
+        if (k & 1) {
+            if (!have_result) {
+                memcpy(result->data, base->data, n * n * work_type->size);
+                have_result = true;
+            } else {
+                ok = matrix_multiply_into(result, base, scratch);
+                Matrix* t = result;
+                result = scratch;
+                scratch = t;
+            }
+        }
+        k >>= 1;
+        if (k > 0 && ok) {
+            ok = matrix_multiply_into(base, base, scratch);
+            Matrix* t = base;
+            base = scratch;
+            scratch = t;
+        }
+    }
+    if (!have_result) matrix_identity_impl(result);
+    
+    Matrix_Destroy(base);
+    Matrix_Destroy(scratch);
+    if (!ok) {
+        Matrix_Destroy(result);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    
+    if (work_type != m->type) {
+        Matrix* converted = Matrix_Create(n, n, m->type);
+        if (converted) m->type->from_float(converted->data, (const float*)result->data, n * n);
+        Matrix_Destroy(result);
+        if (!converted && error) *error = MATRIX_ERROR_MEMORY;
+        return converted;
+    }
+    return result;
+}
+
+static MatrixError matrix_print_impl(const Matrix* m, const char* name, FILE* output) {
     if (!m || !output) return MATRIX_ERROR_NULL_POINTER;
     
     if (name) {
@@ -273,7 +826,7 @@ MatrixError Matrix_Print(const Matrix* m, const char* name, FILE* output) {
         fprintf(output, "[");
         for (size_t j = 0; j < m->cols; j++) {
             void* elem = matrix_element_ptr(m, i, j);
-            m->type->print(elem, output);
+            m->type->print(m->type, elem, output);
             if (j < m->cols - 1) fprintf(output, " ");
         }
         fprintf(output, "]");
@@ -284,7 +837,7 @@ MatrixError Matrix_Print(const Matrix* m, const char* name, FILE* output) {
     return MATRIX_OK;
 }
 
-Matrix* Matrix_Read(FILE* input, const FieldInfo* type, MatrixError* error) {
+static Matrix* matrix_read_impl(FILE* input, const FieldInfo* type, MatrixError* error) {
     if (error) *error = MATRIX_OK;
     
     if (!input || !type) {
@@ -307,7 +860,7 @@ Matrix* Matrix_Read(FILE* input, const FieldInfo* type, MatrixError* error) {
     for (size_t i = 0; i < rows; i++) {
         for (size_t j = 0; j < cols; j++) {
             void* elem = matrix_element_ptr(m, i, j);
-            type->read(elem, input);
+            type->read(type, elem, input);
         }
     }
     
@@ -324,15 +877,198 @@ const char* Matrix_ErrorString(MatrixError error) {
         case MATRIX_ERROR_DIMENSION_MISMATCH: return "Несовпадение размерностей";
         case MATRIX_ERROR_INVALID_INDEX: return "Индекс вне диапазона";
         case MATRIX_ERROR_SINGULAR_MATRIX: return "Вырожденная матрица"; 
+        case MATRIX_ERROR_OVERFLOW: return "Переполнение";
+        case MATRIX_ERROR_INEXACT: return "Решение не целое";
+        case MATRIX_ERROR_IO: return "Ошибка ввода-вывода";
         default: return "Неизвестная ошибка";
     }
 }
 
-//Метод Гаусса для решения СЛАУ
-MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x) {
+//Копия вещественной матрицы во float
+static Matrix* matrix_to_float(const Matrix* m) {
+    Matrix* f = Matrix_Create(m->rows, m->cols, GetFloatFieldInfo());
+    if (f) m->type->to_float((float*)f->data, m->data, m->rows * m->cols);
+    return f;
+}
+
+static MatrixError matrix_gauss_solve_impl(const Matrix* a, const Matrix* b, Matrix* x, bool* reused);
+
+//half/bfloat16 и смешанные системы: преобразование во float при загрузке
+static MatrixError gauss_solve_via_float(const Matrix* a, const Matrix* b, Matrix* x, bool* reused) {
+    Matrix* fa = matrix_to_float(a);
+    Matrix* fb = matrix_to_float(b);
+    Matrix* fx = Matrix_Create(x->rows, 1, GetFloatFieldInfo());
+    
+    MatrixError err = MATRIX_ERROR_MEMORY;
+    if (fa && fb && fx) {
+        err = matrix_gauss_solve_impl(fa, fb, fx, reused);
+        if (err == MATRIX_OK) x->type->from_float(x->data, (const float*)fx->data, x->rows);
+    }
+    
+    Matrix_Destroy(fa);
+    Matrix_Destroy(fb);
+    Matrix_Destroy(fx);
+    return err;
+}
+
+//GF(p): исключение и обратный ход с отложенной редукцией
+static MatrixError gauss_solve_modular(const Matrix* a, const Matrix* b, Matrix* x) {
+    size_t n = a->rows;
+    const ModularFieldInfo* f = modular_info(a->type);
+    
+    uint32_t* augmented = (uint32_t*)malloc(n * (n + 1) * sizeof(uint32_t));
+    if (!augmented) return MATRIX_ERROR_MEMORY;
+    
+    MATRIX_TRACE_BEGIN(augment_span, "gauss_augment", n, n + 1);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(augmented + i * (n + 1), (const uint32_t*)a->data + i * n, n * sizeof(uint32_t));
+        augmented[i * (n + 1) + n] = ((const uint32_t*)b->data)[i];
+    }
+    MATRIX_TRACE_END(augment_span);
+    
+    MATRIX_TRACE_BEGIN(eliminate_span, "gauss_eliminate", n, n + 1);
+    size_t rank = modular_eliminate(f, augmented, n, n + 1, n, NULL);
+    MATRIX_TRACE_END(eliminate_span);
+    
+    if (rank != n) {
+        free(augmented);
+        return rank == (size_t)-1 ? MATRIX_ERROR_MEMORY : MATRIX_ERROR_SINGULAR_MATRIX;
+    }
+    
+    MATRIX_TRACE_BEGIN(back_span, "gauss_back_substitution", n, 1);
+    modular_back_substitute(f, augmented, n, (uint32_t*)x->data);
+    MATRIX_TRACE_END(back_span);
+    
+    free(augmented);
+    return MATRIX_OK;
+}
+
+//LU-множители float или double матрицы A: из кэша или разложением ее копии
+//(тогда они сохраняются в кэш); key = NULL, если кэш выключен
+static Matrix* factor_lu(const Matrix* a, const MatrixCacheKey* key, size_t* perm, bool* reused,
+                         MatrixError* error) {
+    Matrix* lu = key ? matrix_cache_find(key, a->type, perm) : NULL;
+    *reused = lu != NULL;
+    if (lu) return lu;
+    
+    size_t n = a->rows;
+    lu = Matrix_Create(n, n, a->type);
+    if (!lu) {
+        *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    memcpy(lu->data, a->data, n * n * a->type->size);
+    
+    MATRIX_TRACE_BEGIN(factor_span, "gauss_lu_factor", n, n);
+    *error = a->type == GetDoubleFieldInfo() ? double_lu_factor((double*)lu->data, n, perm)
+                                             : float_lu_factor((float*)lu->data, n, perm);
+    MATRIX_TRACE_END(factor_span);
+    if (*error != MATRIX_OK) {
+        Matrix_Destroy(lu);
+        return NULL;
+    }
+    if (key) matrix_cache_store(key, lu, perm);
+    return lu;
+}
+
+//float: LU-разложение копии A, затем прямой и обратный ход
+static MatrixError gauss_solve_float(const Matrix* a, const Matrix* b, Matrix* x, bool* reused) {
+    size_t n = a->rows;
+    float* rhs = (float*)malloc(n * sizeof(float));
+    size_t* perm = (size_t*)malloc(n * sizeof(size_t));
+    if (!rhs || !perm) {
+        free(rhs);
+        free(perm);
+        return MATRIX_ERROR_MEMORY;
+    }
+    
+    //Копия b: x может быть той же матрицей
+    memcpy(rhs, b->data, n * sizeof(float));
+    MatrixCacheKey key;
+    bool cacheable = matrix_cache_key(&key, MATRIX_CACHE_LU, a, NULL);
+    MatrixError err = MATRIX_OK;
+    Matrix* lu = factor_lu(a, cacheable ? &key : NULL, perm, reused, &err);
+    if (lu) {
+        MATRIX_TRACE_BEGIN(back_span, "gauss_back_substitution", n, 1);
+        float_lu_solve((const float*)lu->data, perm, n, rhs, (float*)x->data);
+        MATRIX_TRACE_END(back_span);
+    }
+    
+    Matrix_Destroy(lu);
+    free(rhs);
+    free(perm);
+    return err;
+}
+
+//double: без кэша - исключение на расширенной матрице, с кэшем - блочное LU,
+//множители которого нужны следующим правым частям
+static MatrixError gauss_solve_double(const Matrix* a, const Matrix* b, Matrix* x, bool* reused) {
+    size_t n = a->rows;
+    MatrixCacheKey key;
+    if (!matrix_cache_key(&key, MATRIX_CACHE_LU, a, NULL)) {
+        return double_gauss_solve((const double*)a->data, (const double*)b->data, (double*)x->data, n);
+    }
+    
+    double* rhs = (double*)malloc(n * sizeof(double));
+    size_t* perm = (size_t*)malloc(n * sizeof(size_t));
+    if (!rhs || !perm) {
+        free(rhs);
+        free(perm);
+        return MATRIX_ERROR_MEMORY;
+    }
+    
+    memcpy(rhs, b->data, n * sizeof(double));
+    MatrixError err = MATRIX_OK;
+    Matrix* lu = factor_lu(a, &key, perm, reused, &err);
+    if (lu) {
+        MATRIX_TRACE_BEGIN(back_span, "gauss_back_substitution", n, 1);
+        double_lu_solve((const double*)lu->data, perm, n, rhs, (double*)x->data);
+        MATRIX_TRACE_END(back_span);
+    }
+    
+    Matrix_Destroy(lu);
+    free(rhs);
+    free(perm);
+    return err;
+}
+
+//int и int64: исключение Барейса без дробей; x записывается, только если решение целое
+static MatrixError gauss_solve_int(const Matrix* a, const Matrix* b, Matrix* x) {
+    size_t n = a->rows;
+    bool wide = (a->type == GetInt64FieldInfo());
+    int64_t* numerators = (int64_t*)malloc(n * sizeof(int64_t));
+    if (!numerators) return MATRIX_ERROR_MEMORY;
+    
+    int64_t denominator = 1;
+    MatrixError err = bareiss_solve(a, b, numerators, &denominator);
+    for (size_t i = 0; err == MATRIX_OK && i < n; i++) {
+        if (numerators[i] % denominator != 0) {
+            err = MATRIX_ERROR_INEXACT;
+        } else if (!wide && (numerators[i] / denominator > INT_MAX || numerators[i] / denominator < INT_MIN)) {
+            err = MATRIX_ERROR_OVERFLOW;
+        }
+    }
+    if (err == MATRIX_OK) {
+        for (size_t i = 0; i < n; i++) {
+            if (wide) ((int64_t*)x->data)[i] = numerators[i] / denominator;
+            else ((int*)x->data)[i] = (int)(numerators[i] / denominator);
+        }
+    }
+    
+    free(numerators);
+    return err;
+}
+
+//Метод Гаусса для решения СЛАУ; reused - LU-множители A взяты из кэша
+static MatrixError matrix_gauss_solve_impl(const Matrix* a, const Matrix* b, Matrix* x, bool* reused) {
     if (!a || !b || !x) return MATRIX_ERROR_NULL_POINTER;
     if (!a->type || !b->type || !x->type) return MATRIX_ERROR_TYPE_MISMATCH;
-    if (!types_compatible(a, b) || !types_compatible(a, x)) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (!a->type->sub || !a->type->div) return MATRIX_ERROR_TYPE_MISMATCH;
+    
+    bool mixed = !types_compatible(a, b) || !types_compatible(a, x);
+    if (mixed && !(float_convertible(a) && float_convertible(b) && float_convertible(x))) {
+        return MATRIX_ERROR_TYPE_MISMATCH;
+    }
     
     // Проверка: A - квадратная, b - вектор-столбец
     if (a->rows != a->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
@@ -340,6 +1076,34 @@ MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x) {
     if (a->rows != b->rows) return MATRIX_ERROR_DIMENSION_MISMATCH;
     if (x->rows != a->rows || x->cols != 1) return MATRIX_ERROR_DIMENSION_MISMATCH;
     
+    MatrixError writable = matrix_make_writable(x);
+    if (writable != MATRIX_OK) return writable;
+    
+    if (float_convertible(a) && (mixed || a->type != GetFloatFieldInfo())) {
+        return gauss_solve_via_float(a, b, x, reused);
+    }
+    
+    if (a->type == GetComplexFieldInfo()) {
+        return complex_gauss_solve((const ComplexFloat*)a->data, (const ComplexFloat*)b->data,
+                                   (ComplexFloat*)x->data, a->rows);
+    }
+    
+    if (a->type->modulus) {
+        return gauss_solve_modular(a, b, x);
+    }
+    
+    if (a->type == GetIntFieldInfo() || a->type == GetInt64FieldInfo()) {
+        return gauss_solve_int(a, b, x);
+    }
+    
+    if (a->type == GetFloatFieldInfo()) {
+        return gauss_solve_float(a, b, x, reused);
+    }
+    
+    if (a->type == GetDoubleFieldInfo()) {
+        return gauss_solve_double(a, b, x, reused);
+    }
+    
     size_t n = a->rows;
     
      // Создаем расширенную матрицу [A|b]
@@ -347,6 +1111,7 @@ MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x) {
     if (!augmented) return MATRIX_ERROR_MEMORY;
     
     // Копируем A и b (как в оригинале)
+    MATRIX_TRACE_BEGIN(augment_span, "gauss_augment", n, n + 1);
     for (size_t i = 0; i < n; i++) {
         for (size_t j = 0; j < n; j++) {
             void* src = matrix_element_ptr(a, i, j);
@@ -357,53 +1122,47 @@ MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x) {
         void* dst = matrix_element_ptr(augmented, i, n);
         memcpy(dst, src, b->type->size);
     }
+    MATRIX_TRACE_END(augment_span);
     
     char temp[16];
     char factor[16];
     
+    const FieldInfo* type = a->type;
+    
     // Прямой ход метода Гаусса
     for (size_t k = 0; k < n; k++) {
-        // Поиск главного элемента
+        // Поиск главного элемента: наибольший по модулю, если у типа есть abs,
+        // иначе первый ненулевой
+        MATRIX_TRACE_BEGIN(pivot_span, "gauss_pivot_search", n - k, 1);
         size_t max_row = k;
         void* max_pivot = matrix_element_ptr(augmented, k, k);
         
-        for (size_t i = k + 1; i < n; i++) {
-            void* current = matrix_element_ptr(augmented, i, k);
-            
-            if (a->type == GetFloatFieldInfo()) {
-                float max_val = *(float*)max_pivot;
-                float cur_val = *(float*)current;
-                if (cur_val < 0) cur_val = -cur_val;
-                if (max_val < 0) max_val = -max_val;
-                if (cur_val > max_val) {
-                    max_row = i;
-                    max_pivot = current;
-                }
-            } else if (a->type == GetIntFieldInfo()) {
-                int max_val = *(int*)max_pivot;
-                int cur_val = *(int*)current;
-                if (cur_val < 0) cur_val = -cur_val;
-                if (max_val < 0) max_val = -max_val;
+        if (type->abs) {
+            double max_val = type->abs(type, max_pivot);
+            for (size_t i = k + 1; i < n; i++) {
+                void* current = matrix_element_ptr(augmented, i, k);
+                double cur_val = type->abs(type, current);
                 if (cur_val > max_val) {
+                    max_val = cur_val;
                     max_row = i;
                     max_pivot = current;
                 }
             }
+        } else if (type->is_zero) {
+            while (max_row + 1 < n && type->is_zero(type, max_pivot)) {
+                max_row++;
+                max_pivot = matrix_element_ptr(augmented, max_row, k);
+            }
         }
         
+        MATRIX_TRACE_END(pivot_span);
+        
         // Проверка на вырожденность
-        if (a->type == GetFloatFieldInfo()) {
-            float pivot_abs = *(float*)max_pivot;
-            if (pivot_abs < 0) pivot_abs = -pivot_abs;
-            if (pivot_abs < 1e-10f) {
-                Matrix_Destroy(augmented);
-                return MATRIX_ERROR_SINGULAR_MATRIX;
-            }
-        } else if (a->type == GetIntFieldInfo()) {
-            if (*(int*)max_pivot == 0) {
-                Matrix_Destroy(augmented);
-                return MATRIX_ERROR_SINGULAR_MATRIX;
-            }
+        bool singular = type->abs ? type->abs(type, max_pivot) < 1e-10
+                                  : (type->is_zero && type->is_zero(type, max_pivot));
+        if (singular) {
+            Matrix_Destroy(augmented);
+            return MATRIX_ERROR_SINGULAR_MATRIX;
         }
         
         // Меняем строки, если нужно
@@ -418,31 +1177,32 @@ MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x) {
         }
         
         //Исключение переменной из нижних строк
+        MATRIX_TRACE_BEGIN(eliminate_span, "gauss_eliminate", n - k - 1, n + 1 - k);
         for (size_t i = k + 1; i < n; i++) {
             void* elem_i_k = matrix_element_ptr(augmented, i, k);
             
             //Если элемент уже нулевой, пропускаем
-            if (a->type == GetFloatFieldInfo()) {
-                if (*(float*)elem_i_k == 0) continue;
-            }
+            if (type->is_zero && type->is_zero(type, elem_i_k)) continue;
             
             memcpy(factor, elem_i_k, a->type->size);
             
             
             void* pivot = matrix_element_ptr(augmented, k, k);
-            a->type->div(factor, factor, pivot);
+            a->type->div(a->type, factor, factor, pivot);
             
             for (size_t j = k; j < n + 1; j++) {
                 void* elem_i_j = matrix_element_ptr(augmented, i, j);
                 void* elem_k_j = matrix_element_ptr(augmented, k, j);
                 
-                a->type->mul(temp, factor, elem_k_j);
-                a->type->sub(elem_i_j, elem_i_j, temp);
+                a->type->mul(a->type, temp, factor, elem_k_j);
+                a->type->sub(a->type, elem_i_j, elem_i_j, temp);
             }
         }
+        MATRIX_TRACE_END(eliminate_span);
     }
     
     //Обратный ход 
+    MATRIX_TRACE_BEGIN(back_span, "gauss_back_substitution", n, 1);
     for (size_t i = n; i-- > 0; ) {
         void* x_i = matrix_element_ptr(x, i, 0);
         void* b_i = matrix_element_ptr(augmented, i, n);
@@ -452,15 +1212,194 @@ MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x) {
             void* a_i_j = matrix_element_ptr(augmented, i, j);
             void* x_j = matrix_element_ptr(x, j, 0);
             
-            a->type->mul(temp, a_i_j, x_j);
-            a->type->sub(x_i, x_i, temp);
+            a->type->mul(a->type, temp, a_i_j, x_j);
+            a->type->sub(a->type, x_i, x_i, temp);
         }
         
         // Делим на диагональный элемент
         void* a_i_i = matrix_element_ptr(augmented, i, i);
-        a->type->div(x_i, x_i, a_i_i);
+        a->type->div(a->type, x_i, x_i, a_i_i);
     }
+    MATRIX_TRACE_END(back_span);
     
     Matrix_Destroy(augmented);
     return MATRIX_OK;
 }
+
+
+//Публичные функции: замер времени и FLOP вокруг реализаций
+Matrix* Matrix_Create(size_t rows, size_t cols, const FieldInfo* type) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_CREATE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_CREATE), rows, cols);
+    Matrix* m = matrix_create_impl(rows, cols, type);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return m;
+}
+
+void Matrix_Destroy(Matrix* m) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_DESTROY);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_DESTROY), ROWS_OF(m), COLS_OF(m));
+    matrix_destroy_impl(m);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+}
+
+MatrixError Matrix_Get(const Matrix* m, size_t row, size_t col, void* out) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_GET);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_GET), ROWS_OF(m), COLS_OF(m));
+    MatrixError err = matrix_get_impl(m, row, col, out);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
+
+MatrixError Matrix_Set(Matrix* m, size_t row, size_t col, const void* value) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_SET);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_SET), ROWS_OF(m), COLS_OF(m));
+    MatrixError err = matrix_set_impl(m, row, col, value);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
+
+Matrix* Matrix_Add(const Matrix* a, const Matrix* b, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_ADD);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_ADD), ROWS_OF(a), COLS_OF(a));
+    Matrix* result = matrix_add_impl(a, b, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? result->rows * result->cols : 0);
+    return result;
+}
+
+Matrix* Matrix_Multiply(const Matrix* a, const Matrix* b, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MULTIPLY);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MULTIPLY), ROWS_OF(a), COLS_OF(b));
+    unsigned long long flops = 0;
+    Matrix* result = matrix_multiply_impl(a, b, &flops, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(flops);
+    return result;
+}
+
+Matrix* Matrix_MultiplyChecked(const Matrix* a, const Matrix* b, MatrixOverflowMode mode,
+                               MatrixOverflowReport* report, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MULTIPLY_CHECKED);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MULTIPLY_CHECKED), ROWS_OF(a), COLS_OF(b));
+    Matrix* result = matrix_multiply_checked_impl(a, b, mode, report, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * a->rows * a->cols * b->cols : 0);
+    return result;
+}
+
+Matrix* Matrix_ScalarMultiply(const Matrix* m, const void* scalar, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_SCALAR_MULTIPLY);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_SCALAR_MULTIPLY), ROWS_OF(m), COLS_OF(m));
+    Matrix* result = matrix_scalar_multiply_impl(m, scalar, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? result->rows * result->cols : 0);
+    return result;
+}
+
+Matrix* Matrix_AddLinearCombination(const Matrix* m, size_t row_idx, 
+                                    const void* alphas, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_ADD_LINEAR_COMBINATION);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_ADD_LINEAR_COMBINATION), ROWS_OF(m), COLS_OF(m));
+    Matrix* result = matrix_add_linear_combination_impl(m, row_idx, alphas, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * m->rows * m->cols : 0);
+    return result;
+}
+
+Matrix* Matrix_Clone(const Matrix* m, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_CLONE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_CLONE), ROWS_OF(m), COLS_OF(m));
+    Matrix* clone = matrix_clone_impl(m, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return clone;
+}
+
+Matrix* Matrix_ViewRows(const Matrix* m, size_t first_row, size_t rows, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_VIEW_ROWS);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_VIEW_ROWS), rows, COLS_OF(m));
+    Matrix* view = matrix_view_rows_impl(m, first_row, rows, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return view;
+}
+
+Matrix* Matrix_MapFile(const char* path, size_t rows, size_t cols, const FieldInfo* type, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MAP_FILE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MAP_FILE), rows, cols);
+    Matrix* m = matrix_map_file_impl(path, rows, cols, type, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return m;
+}
+
+MatrixError Matrix_MakeWritable(Matrix* m) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MAKE_WRITABLE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MAKE_WRITABLE), ROWS_OF(m), COLS_OF(m));
+    MatrixError err = m ? matrix_make_writable(m) : MATRIX_ERROR_NULL_POINTER;
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
+
+MatrixError Matrix_Fill(Matrix* m, const void* value) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_FILL);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_FILL), ROWS_OF(m), COLS_OF(m));
+    MatrixError err = matrix_fill_impl(m, value);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
+
+MatrixError Matrix_Identity(Matrix* m) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_IDENTITY);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_IDENTITY), ROWS_OF(m), COLS_OF(m));
+    MatrixError err = matrix_identity_impl(m);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
+
+Matrix* Matrix_Power(const Matrix* m, uint64_t k, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_POWER);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_POWER), ROWS_OF(m), COLS_OF(m));
+    Matrix* result = matrix_power_impl(m, k, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * power_multiplies(k) * result->rows * result->rows * result->rows : 0);
+    return result;
+}
+
+MatrixError Matrix_Print(const Matrix* m, const char* name, FILE* output) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_PRINT);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_PRINT), ROWS_OF(m), COLS_OF(m));
+    MatrixError err = matrix_print_impl(m, name, output);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
+
+Matrix* Matrix_Read(FILE* input, const FieldInfo* type, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_READ);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_READ), 0, 0);
+    Matrix* m = matrix_read_impl(input, type, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return m;
+}
+
+//Прямой ход ~2n^3/3, обратный ~n^2
+MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_GAUSS_SOLVE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_GAUSS_SOLVE), ROWS_OF(a), COLS_OF(a));
+    bool reused = false;
+    MatrixError err = matrix_gauss_solve_impl(a, b, x, &reused);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err != MATRIX_OK ? 0 :
+                     reused ? 2 * a->rows * a->rows : 2 * a->rows * a->rows * a->rows / 3 + a->rows * a->rows);
+    return err;
+}
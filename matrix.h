@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include "field.h"  
+#include "bigint.h"
 
 typedef enum {
     MATRIX_OK = 0,
@@ -14,16 +15,180 @@ typedef enum {
     MATRIX_ERROR_TYPE_MISMATCH = -4,
     MATRIX_ERROR_DIMENSION_MISMATCH = -5,
     MATRIX_ERROR_INVALID_INDEX = -6,
-    MATRIX_ERROR_SINGULAR_MATRIX = -7
+    MATRIX_ERROR_SINGULAR_MATRIX = -7,
+    MATRIX_ERROR_OVERFLOW = -8,
+    MATRIX_ERROR_INEXACT = -9,
+    MATRIX_ERROR_IO = -10
 } MatrixError;
 
+//Поведение int-умножения при выходе результата за пределы int
+typedef enum {
+    MATRIX_OVERFLOW_WRAP = 0,
+    MATRIX_OVERFLOW_SATURATE,
+    MATRIX_OVERFLOW_ERROR
+} MatrixOverflowMode;
+
+typedef struct {
+    size_t overflow_count;
+    size_t first_row;
+    size_t first_col;
+} MatrixOverflowReport;
+
+//Буфер данных со счетчиком ссылок (matrix_buffer.c)
+typedef struct MatrixBuffer MatrixBuffer;
+
+//Клоны и представления разделяют buffer; прямая запись в data допустима только
+//после Matrix_MakeWritable, функции библиотеки делают это сами
 typedef struct {
     void* data;
     size_t rows;
     size_t cols;
     const FieldInfo* type;  
+    MatrixBuffer* buffer;
 } Matrix;
 
+//Операции, по которым ведется статистика (сборка с -DMATRIX_ENABLE_STATS)
+typedef enum {
+    MATRIX_OP_CREATE = 0,
+    MATRIX_OP_DESTROY,
+    MATRIX_OP_GET,
+    MATRIX_OP_SET,
+    MATRIX_OP_ADD,
+    MATRIX_OP_MULTIPLY,
+    MATRIX_OP_MULTIPLY_CHECKED,
+    MATRIX_OP_SCALAR_MULTIPLY,
+    MATRIX_OP_ADD_LINEAR_COMBINATION,
+    MATRIX_OP_CLONE,
+    MATRIX_OP_FILL,
+    MATRIX_OP_IDENTITY,
+    MATRIX_OP_PRINT,
+    MATRIX_OP_READ,
+    MATRIX_OP_GAUSS_SOLVE,
+    MATRIX_OP_QUANTIZE,
+    MATRIX_OP_DEQUANTIZE,
+    MATRIX_OP_QUANTIZED_MULTIPLY,
+    MATRIX_OP_MODULAR_RANK,
+    MATRIX_OP_MODULAR_DETERMINANT,
+    MATRIX_OP_DETERMINANT_EXACT,
+    MATRIX_OP_SOLVE_EXACT,
+    MATRIX_OP_BAREISS_DETERMINANT,
+    MATRIX_OP_BAREISS_SOLVE,
+    MATRIX_OP_GF2_MULTIPLY,
+    MATRIX_OP_GF2_RANK,
+    MATRIX_OP_GF2_SOLVE,
+    MATRIX_OP_CLOSURE,
+    MATRIX_OP_SPLIT_COMPLEX_MULTIPLY,
+    MATRIX_OP_TO_SPLIT_COMPLEX,
+    MATRIX_OP_FROM_SPLIT_COMPLEX,
+    MATRIX_OP_SOLVE_REFINED,
+    MATRIX_OP_MULTIPLY_BATCH,
+    MATRIX_OP_SOLVE_BATCH,
+    MATRIX_OP_DETERMINANT,
+    MATRIX_OP_INVERSE,
+    MATRIX_OP_POWER,
+    MATRIX_OP_MULTIPLY_CHAIN,
+    MATRIX_OP_PLAN_CHAIN,
+    MATRIX_OP_APPLY_ROW_OPS,
+    MATRIX_OP_VIEW_ROWS,
+    MATRIX_OP_MAP_FILE,
+    MATRIX_OP_MAKE_WRITABLE,
+    MATRIX_OP_FACTORIZE,
+    MATRIX_OP_FACTORIZATION_UPDATE,
+    MATRIX_OP_FACTORIZATION_SOLVE,
+    MATRIX_OP_INVERSE_UPDATE,
+    MATRIX_OP_PRODUCT_REFRESH,
+    MATRIX_OP_COUNT
+} MatrixOp;
+
+//Квантованная int8-матрица: масштаб и нулевая точка на строку или столбец,
+//x = scale * (q - zero_point)
+typedef enum {
+    MATRIX_QUANT_PER_ROW = 0,
+    MATRIX_QUANT_PER_COL
+} MatrixQuantAxis;
+
+typedef struct {
+    Matrix* values;
+    float* scales;
+    int* zero_points;
+    MatrixQuantAxis axis;
+} QuantizedMatrix;
+
+//Комплексная матрица с раздельным хранением: действительные и мнимые части
+//в двух float-матрицах одного размера (обычная Matrix чередует re, im)
+typedef struct {
+    Matrix* re;
+    Matrix* im;
+} SplitComplexMatrix;
+
+//Итог Matrix_SolveRefined
+typedef struct {
+    size_t iterations;          //шагов уточнения после начального решения
+    double backward_error;      //||b - Ax|| / (||A|| ||x|| + ||b||), норма max
+    bool fell_back;             //уточнение не сошлось, система решена целиком в double
+} MatrixRefineReport;
+
+//row[target] += sum alphas[k] * row[k] по k != target; alphas - m->rows элементов типа матрицы
+typedef struct {
+    size_t target;
+    const void* alphas;
+} MatrixRowOp;
+
+//Порядок умножения цепочки A_0 ... A_{count-1}: отрезок i..j делится как
+//(A_i..A_s)(A_s+1..A_j), s = split[i * count + j]
+typedef struct {
+    size_t count;
+    size_t* split;
+    unsigned long long flops;           //оценка для найденного порядка, 2 * сумма m * k * n
+    unsigned long long naive_flops;     //то же для порядка слева направо
+} MatrixChainPlan;
+
+//Разложение double-матрицы, которое обновляется поправками малого ранга (matrix_update.c)
+typedef struct MatrixFactorization MatrixFactorization;
+
+typedef struct {
+    size_t rank;                //ранг поправки, накопленной с последнего полного разложения
+    size_t updates;             //всего поправок ранга 1
+    size_t refactorizations;    //полных разложений, включая первое
+    double backward_error;      //последнего решения
+} MatrixUpdateReport;
+
+//Пакет count матриц rows x cols одного типа в одном буфере: матрица t начинается
+//с элемента t * stride (stride >= rows * cols), внутри хранится построчно, как Matrix
+typedef struct {
+    void* data;
+    size_t count;
+    size_t rows;
+    size_t cols;
+    size_t stride;
+    const FieldInfo* type;
+} MatrixBatch;
+
+typedef struct {
+    unsigned long long calls;
+    unsigned long long total_ns;
+    unsigned long long max_ns;
+    unsigned long long flops;
+    unsigned long long bytes_allocated;
+} MatrixOpStats;
+
+typedef struct {
+    int enabled;
+    MatrixOpStats ops[MATRIX_OP_COUNT];
+    unsigned long long live_bytes;
+    unsigned long long peak_live_bytes;
+} MatrixStats;
+
+typedef struct {
+    int enabled;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+    unsigned long long entries;
+    unsigned long long bytes;
+    unsigned long long budget_bytes;
+} MatrixCacheStats;
+
 Matrix* Matrix_Create(size_t rows, size_t cols, const FieldInfo* type);
 void Matrix_Destroy(Matrix* m);
 
@@ -32,19 +197,150 @@ MatrixError Matrix_Set(Matrix* m, size_t row, size_t col, const void* value);
 
 Matrix* Matrix_Add(const Matrix* a, const Matrix* b, MatrixError* error);
 Matrix* Matrix_Multiply(const Matrix* a, const Matrix* b, MatrixError* error);
+//int x int с накоплением в int64; report (может быть NULL) - число переполнений
+Matrix* Matrix_MultiplyChecked(const Matrix* a, const Matrix* b, MatrixOverflowMode mode,
+                               MatrixOverflowReport* report, MatrixError* error);
 Matrix* Matrix_ScalarMultiply(const Matrix* m, const void* scalar, MatrixError* error);
 Matrix* Matrix_AddLinearCombination(const Matrix* m, size_t row_idx, 
                                     const void* alphas, MatrixError* error);
+//Набор строковых операций на месте за один проход: все операции читают исходные
+//строки, то есть M = (I + C) M одним умножением по ненулевым строкам C.
+//C - rows x rows типа M (диагональ тоже учитывается); в списке операции над одной
+//строкой суммируются
+MatrixError Matrix_ApplyRowOps(Matrix* m, const Matrix* coeffs);
+MatrixError Matrix_ApplyRowOpList(Matrix* m, const MatrixRowOp* ops, size_t count);
 
+//O(1): буфер общий, копия делается при первой записи в любую из матриц
 Matrix* Matrix_Clone(const Matrix* m, MatrixError* error);
+//Строки first_row..first_row+rows-1 без копирования; запись в представление или
+//в исходную матрицу отделяет записывающую сторону, вторая видит прежние данные
+Matrix* Matrix_ViewRows(const Matrix* m, size_t first_row, size_t rows, MatrixError* error);
+//Двоичный файл из rows * cols элементов type (построчно) отображается в память
+//только для чтения; первая запись копирует данные в кучу
+Matrix* Matrix_MapFile(const char* path, size_t rows, size_t cols, const FieldInfo* type, MatrixError* error);
+MatrixError Matrix_MakeWritable(Matrix* m);
 MatrixError Matrix_Fill(Matrix* m, const void* value);
 MatrixError Matrix_Identity(Matrix* m);
+//Произведение цепочки в порядке с наименьшим числом операций (ДП): независимые
+//небольшие подпроизведения считаются одновременно, промежуточные буферы переиспользуются
+Matrix* Matrix_MultiplyChain(const Matrix* const* matrices, size_t count, MatrixError* error);
+//План без вычисления; Print выводит расстановку скобок, например ((A0 A1) A2)
+MatrixChainPlan* Matrix_PlanChain(const Matrix* const* matrices, size_t count, MatrixError* error);
+MatrixError MatrixChainPlan_Print(const MatrixChainPlan* plan, FILE* output);
+void MatrixChainPlan_Destroy(MatrixChainPlan* plan);
+//A^k за O(log k) умножений в трех заранее созданных буферах; A^0 = I типа A.
+//Для всех типов с ядром умножения, включая полукольца и GF(p)
+Matrix* Matrix_Power(const Matrix* m, uint64_t k, MatrixError* error);
 
 MatrixError Matrix_Print(const Matrix* m, const char* name, FILE* output);
 Matrix* Matrix_Read(FILE* input, const FieldInfo* type, MatrixError* error);
 
+//Для int и int64 решение точное (Барейс): MATRIX_ERROR_INEXACT, если оно не целое
 MatrixError Matrix_GaussSolve(const Matrix* a, const Matrix* b, Matrix* x);
+//Смешанная точность для double-систем: A раскладывается один раз в factor_type
+//(float, bfloat16, half; NULL - float), невязка и поправки считаются в double.
+//Если уточнение расходится, система решается целиком в double
+MatrixError Matrix_SolveRefined(const Matrix* a, const Matrix* b, Matrix* x,
+                                const FieldInfo* factor_type, MatrixRefineReport* report);
+
+//det A = sign * exp(log_abs): сумма логарифмов не переполняется при больших n.
+//Вырожденная матрица дает sign = 0 и log_abs = -inf. Блочное LU в double
+MatrixError Matrix_Determinant(const Matrix* m, int* sign, double* log_abs);
+//A^-1 = U^-1 L^-1 P по тому же LU: треугольные множители обращаются по строкам
+//параллельно, затем одно умножение. Для double и типов с to_float/from_float
+Matrix* Matrix_Inverse(const Matrix* m, MatrixError* error);
+
+//Инкрементальные решения для double: LU хранится для A0, изменения A = A0 + U V^T
+//учитываются формулой Шермана-Моррисона-Вудбери - O(n^2) на поправку ранга 1 и
+//O(n^2 + n K) на решение. Когда ранг K превышает max_rank (0 - 32) или обратная
+//ошибка решения выше tolerance (0 - 64 sqrt(n) eps), A раскладывается заново
+MatrixFactorization* Matrix_Factorize(const Matrix* a, size_t max_rank, double tolerance, MatrixError* error);
+//A += U V^T, U и V - n x k. Если новая A вырождена (MATRIX_ERROR_SINGULAR_MATRIX)
+//или не хватило памяти, разложение остается прежним
+MatrixError MatrixFactorization_Update(MatrixFactorization* f, const Matrix* u, const Matrix* v);
+//A[row][col] = value; при ошибке, как у Update, разложение не меняется
+MatrixError MatrixFactorization_Set(MatrixFactorization* f, size_t row, size_t col, double value);
+MatrixError MatrixFactorization_Solve(MatrixFactorization* f, const Matrix* b, Matrix* x);
+MatrixError MatrixFactorization_GetReport(const MatrixFactorization* f, MatrixUpdateReport* report);
+void MatrixFactorization_Destroy(MatrixFactorization* f);
+//A += U V^T и inv = A^-1 по Вудбери за O(n^2 k). Проверка пробным вектором: при
+//дрейфе или вырожденной поправке inv считается заново через Matrix_Inverse. Если
+//новая A вырождена (MATRIX_ERROR_SINGULAR_MATRIX) или не хватило памяти, a и inv
+//остаются прежними
+MatrixError Matrix_InverseUpdate(Matrix* inv, Matrix* a, const Matrix* u, const Matrix* v);
+//C = A B после изменения строки row матрицы A: строка C считается заново, O(k n)
+MatrixError Matrix_ProductRefreshRow(Matrix* c, const Matrix* a, const Matrix* b, size_t row);
+//После изменения столбца col матрицы A (old_column - прежние a->rows значений):
+//C += (A[:, col] - old) B[col, :], O(m n). Для float и double строка с наибольшим
+//изменением пересчитывается для проверки, при расхождении C считается целиком;
+//полукольца, half, bfloat16 и комплексные всегда пересчитываются целиком
+MatrixError Matrix_ProductRefreshColumn(Matrix* c, const Matrix* a, const Matrix* b, size_t col,
+                                        const void* old_column);
+
+//Независимые операции над пакетом float или double матриц одного размера: проверка
+//типа и размеров один раз на пакет, матрицы идут по SIMD-дорожкам и по потокам.
+//singular (может быть NULL) - флаг для каждой системы; вырожденные x не меняются,
+//остальные решаются, ошибка MATRIX_ERROR_SINGULAR_MATRIX
+MatrixError Matrix_MultiplyBatch(const MatrixBatch* a, const MatrixBatch* b, MatrixBatch* c);
+MatrixError Matrix_SolveBatch(const MatrixBatch* a, const MatrixBatch* b, MatrixBatch* x, bool* singular);
+//То же для массивов уже созданных матриц; c и x должны быть нужного размера
+MatrixError Matrix_MultiplyArray(const Matrix* const* a, const Matrix* const* b, Matrix* const* c, size_t count);
+MatrixError Matrix_SolveArray(const Matrix* const* a, const Matrix* const* b, Matrix* const* x,
+                              size_t count, bool* singular);
+
+//Замыкание A* = I + A + A^2 + ... для min-plus (кратчайшие пути) и bool
+//(достижимость); блочный Флойд-Уоршелл
+Matrix* Matrix_Closure(const Matrix* m, MatrixError* error);
+
+QuantizedMatrix* Matrix_Quantize(const Matrix* m, MatrixQuantAxis axis, MatrixError* error);
+Matrix* Matrix_Dequantize(const QuantizedMatrix* q, MatrixError* error);
+//A квантуется по строкам, B - по столбцам; результат во float
+Matrix* Matrix_QuantizedMultiply(const QuantizedMatrix* a, const QuantizedMatrix* b, MatrixError* error);
+void QuantizedMatrix_Destroy(QuantizedMatrix* q);
+
+//Переход между чередующимся (GetComplexFieldInfo) и раздельным хранением
+SplitComplexMatrix* Matrix_ToSplitComplex(const Matrix* m, MatrixError* error);
+Matrix* SplitComplexMatrix_ToMatrix(const SplitComplexMatrix* s, MatrixError* error);
+//Умножение 3M: три вещественных умножения через float-ядро вместо четырех
+SplitComplexMatrix* SplitComplexMatrix_Multiply(const SplitComplexMatrix* a, const SplitComplexMatrix* b,
+                                                MatrixError* error);
+void SplitComplexMatrix_Destroy(SplitComplexMatrix* s);
+
+//Точные ранг и определитель над GF(p) (тип из CreateModularFieldInfo)
+MatrixError Matrix_ModularRank(const Matrix* m, size_t* rank);
+MatrixError Matrix_ModularDeterminant(const Matrix* m, uint32_t* det);
+
+//Точные определитель и решение для int: исключение по многим простым и КТО.
+//Решение x = numerators[i] / denominator, denominator = |det A| > 0;
+//numerators - массив из a->rows инициализированных BigInt.
+MatrixError Matrix_DeterminantExact(const Matrix* m, BigInt* det);
+MatrixError Matrix_SolveExact(const Matrix* a, const Matrix* b, BigInt* numerators, BigInt* denominator);
+
+//Исключение Барейса для int и int64 с промежуточными значениями в int64/__int128;
+//MATRIX_ERROR_OVERFLOW, если минор не помещается в int64.
+//Решение x = numerators[i] / denominator, denominator = |det A|.
+MatrixError Matrix_BareissDeterminant(const Matrix* m, int64_t* det);
+MatrixError Matrix_BareissSolve(const Matrix* a, const Matrix* b, int64_t* numerators, int64_t* denominator);
 
 const char* Matrix_ErrorString(MatrixError error);
 
+MatrixError Matrix_GetStats(MatrixStats* out);
+void Matrix_ResetStats(void);
+const char* Matrix_OpName(MatrixOp op);
+
+MatrixError Matrix_TraceDump(FILE* output);
+void Matrix_TraceClear(void);
+
+//Кэш результатов (по умолчанию выключен): произведения Matrix_Multiply и LU-множители
+//Matrix_GaussSolve для float, double, half и bfloat16. Ключ - тип, размеры и 64-битный
+//хеш содержимого операндов, который считается при каждом вызове (один проход по
+//данным), поэтому прямая запись в data тоже учитывается. Запись хранит копию
+//операндов, и совпадение хеша подтверждается побайтовым сравнением: результат
+//другой матрицы не возвращается. Копии входят в budget_bytes, вытеснение LRU
+MatrixError Matrix_CacheEnable(size_t budget_bytes);
+void Matrix_CacheDisable(void);
+void Matrix_CacheClear(void);
+MatrixError Matrix_GetCacheStats(MatrixCacheStats* out);
+void Matrix_ResetCacheStats(void);
+
 #endif
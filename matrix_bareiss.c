@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "int_field.h"
+#include "int64_field.h"
+#include "matrix_bareiss.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Промежуточные произведения: __int128, где он есть, иначе int64 с проверкой.
+//Все хранимые значения ограничены |v| <= INT64_MAX, поэтому одно произведение
+//занимает меньше 2^126, а сумма под WIDE_LIMIT не переполняет __int128.
+#if defined(__SIZEOF_INT128__)
+
+typedef __int128 WideInt;
+#define WIDE_LIMIT ((WideInt)1 << 126)
+
+static bool wide_mul_sub(int64_t a, int64_t b, int64_t c, int64_t d, WideInt* out) {
+    *out = (WideInt)a * b - (WideInt)c * d;
+    return true;
+}
+
+static bool wide_sub_mul(WideInt* acc, int64_t a, int64_t b) {
+    *acc -= (WideInt)a * b;
+    return *acc < WIDE_LIMIT && *acc > -WIDE_LIMIT;
+}
+
+#else
+
+typedef int64_t WideInt;
+
+static bool mul_checked(int64_t a, int64_t b, int64_t* out) {
+    int64_t abs_a = a < 0 ? -a : a;
+    if (abs_a != 0 && (b > INT64_MAX / abs_a || b < -INT64_MAX / abs_a)) return false;
+    *out = a * b;
+    return true;
+}
+
+static bool wide_sub_mul(WideInt* acc, int64_t a, int64_t b) {
+    int64_t p;
+    if (!mul_checked(a, b, &p)) return false;
+    if ((p > 0 && *acc < -INT64_MAX + p) || (p < 0 && *acc > INT64_MAX + p)) return false;
+    *acc -= p;
+    return true;
+}
+
+static bool wide_mul_sub(int64_t a, int64_t b, int64_t c, int64_t d, WideInt* out) {
+    return mul_checked(a, b, out) && wide_sub_mul(out, c, d);
+}
+
+#endif
+
+static bool wide_to_int64(WideInt v, int64_t* out) {
+    if (v > INT64_MAX || v < -INT64_MAX) return false;
+    *out = (int64_t)v;
+    return true;
+}
+
+//Исключение Барейса: после шага k элемент (i, j) равен минору порядка k+1,
+//деление на предыдущий опорный всегда точное. Строки под опорной независимы
+//и обновляются параллельно. Возвращает определитель квадратной части n x n.
+static MatrixError bareiss_eliminate(int64_t* w, size_t n, size_t cols, int64_t* det) {
+    int64_t prev = 1;
+    bool negate = false;
+
+    for (size_t k = 0; k < n; k++) {
+        size_t pivot_row = k;
+        while (pivot_row < n && w[pivot_row * cols + k] == 0) pivot_row++;
+        if (pivot_row == n) {
+            *det = 0;
+            return MATRIX_ERROR_SINGULAR_MATRIX;
+        }
+        if (pivot_row != k) {
+            for (size_t j = 0; j < cols; j++) {
+                int64_t t = w[k * cols + j];
+                w[k * cols + j] = w[pivot_row * cols + j];
+                w[pivot_row * cols + j] = t;
+            }
+            negate = !negate;
+        }
+
+        const int64_t* pivot_row_data = w + k * cols;
+        int64_t pivot = pivot_row_data[k];
+        int overflow = 0;
+
+        MATRIX_TRACE_BEGIN(span, "bareiss_eliminate", n - k - 1, cols - k);
+        #pragma omp parallel for schedule(static) reduction(|:overflow)
+        for (long i = (long)k + 1; i < (long)n; i++) {
+            int64_t* row = w + (size_t)i * cols;
+            int64_t factor = row[k];
+            for (size_t j = k + 1; j < cols; j++) {
+                WideInt v;
+                if (!wide_mul_sub(pivot, row[j], factor, pivot_row_data[j], &v) ||
+                    !wide_to_int64(v / prev, &row[j])) {
+                    overflow = 1;
+                }
+            }
+            row[k] = 0;
+        }
+        MATRIX_TRACE_END(span);
+
+        if (overflow) return MATRIX_ERROR_OVERFLOW;
+        prev = pivot;
+    }
+
+    *det = negate ? -prev : prev;
+    return MATRIX_OK;
+}
+
+//Обратный ход в целых: y = det * x, строка i дает
+//w[i][i] * y[i] = det * w[i][n] - sum w[i][j] * y[j], деление точное
+static MatrixError bareiss_back_substitute(const int64_t* w, size_t n, int64_t det, int64_t* y) {
+    size_t cols = n + 1;
+    for (size_t i = n; i-- > 0; ) {
+        const int64_t* row = w + i * cols;
+        WideInt acc = 0;
+        if (!wide_sub_mul(&acc, -det, row[n])) return MATRIX_ERROR_OVERFLOW;
+        for (size_t j = i + 1; j < n; j++) {
+            if (!wide_sub_mul(&acc, row[j], y[j])) return MATRIX_ERROR_OVERFLOW;
+        }
+        if (!wide_to_int64(acc / row[i], &y[i])) return MATRIX_ERROR_OVERFLOW;
+    }
+    return MATRIX_OK;
+}
+
+static bool is_integer_type(const FieldInfo* type) {
+    return type == GetIntFieldInfo() || type == GetInt64FieldInfo();
+}
+
+//INT64_MIN не допускается: все значения должны удовлетворять |v| <= INT64_MAX
+static bool load_element(const Matrix* m, size_t idx, int64_t* out) {
+    if (m->type == GetInt64FieldInfo()) {
+        *out = ((const int64_t*)m->data)[idx];
+        return *out != INT64_MIN;
+    }
+    *out = ((const int*)m->data)[idx];
+    return true;
+}
+
+static MatrixError load_int64(const Matrix* a, const Matrix* b, int64_t** out) {
+    size_t n = a->rows;
+    size_t cols = b ? n + 1 : n;
+    int64_t* w = (int64_t*)malloc(n * cols * sizeof(int64_t));
+    if (!w) return MATRIX_ERROR_MEMORY;
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) ok &= load_element(a, i * n + j, &w[i * cols + j]);
+        if (b) ok &= load_element(b, i, &w[i * cols + n]);
+    }
+    if (!ok) {
+        free(w);
+        return MATRIX_ERROR_OVERFLOW;
+    }
+    *out = w;
+    return MATRIX_OK;
+}
+
+MatrixError bareiss_solve(const Matrix* a, const Matrix* b, int64_t* numerators, int64_t* denominator) {
+    size_t n = a->rows;
+    int64_t* w = NULL;
+    MatrixError load_err = load_int64(a, b, &w);
+    if (load_err != MATRIX_OK) return load_err;
+
+    int64_t det = 0;
+    MatrixError err = bareiss_eliminate(w, n, n + 1, &det);
+    if (err == MATRIX_OK) {
+        MATRIX_TRACE_BEGIN(span, "bareiss_back_substitution", n, 1);
+        err = bareiss_back_substitute(w, n, det, numerators);
+        MATRIX_TRACE_END(span);
+    }
+    if (err == MATRIX_OK) {
+        if (det < 0) {
+            det = -det;
+            for (size_t i = 0; i < n; i++) numerators[i] = -numerators[i];
+        }
+        *denominator = det;
+    }
+
+    free(w);
+    return err;
+}
+
+static MatrixError matrix_bareiss_determinant_impl(const Matrix* m, int64_t* det) {
+    if (!m || !det) return MATRIX_ERROR_NULL_POINTER;
+    if (!is_integer_type(m->type)) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (m->rows != m->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    int64_t* w = NULL;
+    MatrixError load_err = load_int64(m, NULL, &w);
+    if (load_err != MATRIX_OK) return load_err;
+
+    MatrixError err = bareiss_eliminate(w, m->rows, m->cols, det);
+    if (err == MATRIX_ERROR_SINGULAR_MATRIX) err = MATRIX_OK;
+
+    free(w);
+    return err;
+}
+
+static MatrixError matrix_bareiss_solve_impl(const Matrix* a, const Matrix* b,
+                                             int64_t* numerators, int64_t* denominator) {
+    if (!a || !b || !numerators || !denominator) return MATRIX_ERROR_NULL_POINTER;
+    if (!is_integer_type(a->type) || b->type != a->type) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (a->rows != a->cols || b->rows != a->rows || b->cols != 1) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    return bareiss_solve(a, b, numerators, denominator);
+}
+
+//Публичные функции
+MatrixError Matrix_BareissDeterminant(const Matrix* m, int64_t* det) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_BAREISS_DETERMINANT);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_BAREISS_DETERMINANT), m ? m->rows : 0, m ? m->cols : 0);
+    MatrixError err = matrix_bareiss_determinant_impl(m, det);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * m->rows * m->rows * m->rows / 3 : 0);
+    return err;
+}
+
+MatrixError Matrix_BareissSolve(const Matrix* a, const Matrix* b, int64_t* numerators, int64_t* denominator) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_BAREISS_SOLVE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_BAREISS_SOLVE), a ? a->rows : 0, a ? a->cols : 0);
+    MatrixError err = matrix_bareiss_solve_impl(a, b, numerators, denominator);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * a->rows * a->rows * a->rows / 3 + a->rows * a->rows : 0);
+    return err;
+}
@@ -0,0 +1,11 @@
+#ifndef MATRIX_BAREISS_H
+#define MATRIX_BAREISS_H
+
+#include <stdint.h>
+#include "matrix.h"
+
+//Решение int-системы без дробей: x[i] = numerators[i] / *denominator,
+//*denominator = |det A|. Используется Matrix_GaussSolve для int и int64.
+MatrixError bareiss_solve(const Matrix* a, const Matrix* b, int64_t* numerators, int64_t* denominator);
+
+#endif
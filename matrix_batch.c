@@ -0,0 +1,381 @@
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "matrix.h"
+#include "matrix_buffer.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Пакет обрабатывается блоками по BATCH_LANES матриц. Блок упаковывается в структуру
+//массивов: элемент e всех матриц блока лежит подряд (soa[e * BATCH_LANES + l]),
+//поэтому внутренний цикл по l - одна и та же операция во всех SIMD-дорожках.
+//Блоки независимы и делятся между потоками
+#define BATCH_LANES 16
+
+#define BATCH_ABS(x) ((x) < 0 ? -(x) : (x))
+
+//Источник матриц пакета: общий буфер с шагом или массив Matrix*
+typedef struct {
+    char* base;
+    size_t stride_bytes;
+    const Matrix* const* items;
+} BatchSource;
+
+static char* batch_item(const BatchSource* s, size_t t) {
+    return s->items ? (char*)s->items[t]->data : s->base + t * s->stride_bytes;
+}
+
+static size_t batch_lanes(size_t count, size_t first) {
+    return count - first < BATCH_LANES ? count - first : BATCH_LANES;
+}
+
+//Неполный последний блок добивается копиями первой матрицы: пустые дорожки
+//считают то же, что и первая, и не дают деления на мусор
+#define BATCH_KERNELS(T, S, EPS)                                                            \
+static void S##_pack(const BatchSource* src, size_t first, size_t lanes, size_t elems,       \
+                     T* soa) {                                                              \
+    for (size_t l = 0; l < BATCH_LANES; l++) {                                              \
+        const T* m = (const T*)batch_item(src, first + (l < lanes ? l : 0));                \
+        for (size_t e = 0; e < elems; e++) soa[e * BATCH_LANES + l] = m[e];                 \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+static void S##_unpack(const BatchSource* dst, size_t first, size_t lanes, size_t elems,     \
+                       const T* soa, const bool* skip) {                                    \
+    for (size_t l = 0; l < lanes; l++) {                                                    \
+        if (skip && skip[l]) continue;                                                      \
+        T* m = (T*)batch_item(dst, first + l);                                              \
+        for (size_t e = 0; e < elems; e++) m[e] = soa[e * BATCH_LANES + l];                 \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+static void S##_multiply_block(const T* a, const T* b, T* c, size_t m, size_t k, size_t n) { \
+    size_t row = n * BATCH_LANES;                                                           \
+    for (size_t i = 0; i < m; i++) {                                                        \
+        T* ci = c + i * row;                                                                \
+        for (size_t e = 0; e < row; e++) ci[e] = 0;                                         \
+        for (size_t p = 0; p < k; p++) {                                                    \
+            const T* aip = a + (i * k + p) * BATCH_LANES;                                   \
+            const T* bp = b + p * row;                                                      \
+            for (size_t j = 0; j < n; j++) {                                                \
+                for (size_t l = 0; l < BATCH_LANES; l++) {                                  \
+                    ci[j * BATCH_LANES + l] += aip[l] * bp[j * BATCH_LANES + l];            \
+                }                                                                           \
+            }                                                                               \
+        }                                                                                   \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+/*Гаусс с выбором главного элемента независимо в каждой дорожке; порог      */             \
+/*n * eps * max|A|, как в double_gauss_solve. У вырожденной дорожки опорный  */             \
+/*заменяется единицей, чтобы не портить соседние дорожки inf и NaN           */             \
+static void S##_solve_block(T* a, T* b, size_t n, size_t r, bool* singular) {               \
+    T threshold[BATCH_LANES];                                                               \
+    for (size_t l = 0; l < BATCH_LANES; l++) {                                              \
+        threshold[l] = 0;                                                                   \
+        singular[l] = false;                                                                \
+    }                                                                                       \
+    for (size_t e = 0; e < n * n; e++) {                                                    \
+        for (size_t l = 0; l < BATCH_LANES; l++) {                                          \
+            T v = BATCH_ABS(a[e * BATCH_LANES + l]);                                        \
+            if (v > threshold[l]) threshold[l] = v;                                         \
+        }                                                                                   \
+    }                                                                                       \
+    for (size_t l = 0; l < BATCH_LANES; l++) threshold[l] *= (T)n * EPS;                    \
+                                                                                            \
+    for (size_t k = 0; k < n; k++) {                                                        \
+        for (size_t l = 0; l < BATCH_LANES; l++) {                                          \
+            size_t p = k;                                                                   \
+            T best = BATCH_ABS(a[(k * n + k) * BATCH_LANES + l]);                           \
+            for (size_t i = k + 1; i < n; i++) {                                            \
+                T v = BATCH_ABS(a[(i * n + k) * BATCH_LANES + l]);                          \
+                if (v > best) {                                                             \
+                    best = v;                                                               \
+                    p = i;                                                                  \
+                }                                                                           \
+            }                                                                               \
+            if (!(best > threshold[l])) {                                                   \
+                singular[l] = true;                                                         \
+                a[(k * n + k) * BATCH_LANES + l] = 1;                                       \
+                for (size_t i = k + 1; i < n; i++) a[(i * n + k) * BATCH_LANES + l] = 0;    \
+                continue;                                                                   \
+            }                                                                               \
+            if (p == k) continue;                                                           \
+            for (size_t j = k; j < n; j++) {                                                \
+                T t = a[(k * n + j) * BATCH_LANES + l];                                     \
+                a[(k * n + j) * BATCH_LANES + l] = a[(p * n + j) * BATCH_LANES + l];        \
+                a[(p * n + j) * BATCH_LANES + l] = t;                                       \
+            }                                                                               \
+            for (size_t j = 0; j < r; j++) {                                                \
+                T t = b[(k * r + j) * BATCH_LANES + l];                                     \
+                b[(k * r + j) * BATCH_LANES + l] = b[(p * r + j) * BATCH_LANES + l];        \
+                b[(p * r + j) * BATCH_LANES + l] = t;                                       \
+            }                                                                               \
+        }                                                                                   \
+                                                                                            \
+        const T* pivot = a + (k * n + k) * BATCH_LANES;                                     \
+        for (size_t i = k + 1; i < n; i++) {                                                \
+            T f[BATCH_LANES];                                                               \
+            T* aik = a + (i * n + k) * BATCH_LANES;                                         \
+            for (size_t l = 0; l < BATCH_LANES; l++) f[l] = aik[l] / pivot[l];              \
+            for (size_t j = k + 1; j < n; j++) {                                            \
+                T* dst = a + (i * n + j) * BATCH_LANES;                                     \
+                const T* src = a + (k * n + j) * BATCH_LANES;                               \
+                for (size_t l = 0; l < BATCH_LANES; l++) dst[l] -= f[l] * src[l];           \
+            }                                                                               \
+            for (size_t j = 0; j < r; j++) {                                                \
+                T* dst = b + (i * r + j) * BATCH_LANES;                                     \
+                const T* src = b + (k * r + j) * BATCH_LANES;                               \
+                for (size_t l = 0; l < BATCH_LANES; l++) dst[l] -= f[l] * src[l];           \
+            }                                                                               \
+            for (size_t l = 0; l < BATCH_LANES; l++) aik[l] = 0;                            \
+        }                                                                                   \
+    }                                                                                       \
+                                                                                            \
+    for (size_t i = n; i-- > 0; ) {                                                         \
+        for (size_t j = i + 1; j < n; j++) {                                                \
+            const T* aij = a + (i * n + j) * BATCH_LANES;                                   \
+            for (size_t c = 0; c < r; c++) {                                                \
+                T* dst = b + (i * r + c) * BATCH_LANES;                                     \
+                const T* src = b + (j * r + c) * BATCH_LANES;                               \
+                for (size_t l = 0; l < BATCH_LANES; l++) dst[l] -= aij[l] * src[l];         \
+            }                                                                               \
+        }                                                                                   \
+        const T* aii = a + (i * n + i) * BATCH_LANES;                                       \
+        for (size_t c = 0; c < r; c++) {                                                    \
+            T* dst = b + (i * r + c) * BATCH_LANES;                                         \
+            for (size_t l = 0; l < BATCH_LANES; l++) dst[l] /= aii[l];                      \
+        }                                                                                   \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+static MatrixError S##_multiply_batch(const BatchSource* a, const BatchSource* b,            \
+                                      const BatchSource* c, size_t count,                   \
+                                      size_t m, size_t k, size_t n) {                       \
+    long blocks = (long)((count + BATCH_LANES - 1) / BATCH_LANES);                          \
+    size_t block_elems = (m * k + k * n + m * n) * BATCH_LANES;                             \
+    int failed = 0;                                                                         \
+    _Pragma("omp parallel reduction(|:failed)")                                             \
+    {                                                                                       \
+        T* buf = (T*)malloc(block_elems * sizeof(T));                                       \
+        if (!buf) failed = 1;                                                               \
+        _Pragma("omp for schedule(static)")                                                 \
+        for (long blk = 0; blk < blocks; blk++) {                                           \
+            if (!buf) continue;                                                             \
+            size_t first = (size_t)blk * BATCH_LANES;                                       \
+            size_t lanes = batch_lanes(count, first);                                       \
+            T* sa = buf;                                                                    \
+            T* sb = sa + m * k * BATCH_LANES;                                               \
+            T* sc = sb + k * n * BATCH_LANES;                                               \
+            S##_pack(a, first, lanes, m * k, sa);                                           \
+            S##_pack(b, first, lanes, k * n, sb);                                           \
+            S##_multiply_block(sa, sb, sc, m, k, n);                                        \
+            S##_unpack(c, first, lanes, m * n, sc, NULL);                                   \
+        }                                                                                   \
+        free(buf);                                                                          \
+    }                                                                                       \
+    return failed ? MATRIX_ERROR_MEMORY : MATRIX_OK;                                        \
+}                                                                                           \
+                                                                                            \
+static MatrixError S##_solve_batch(const BatchSource* a, const BatchSource* b,               \
+                                   const BatchSource* x, size_t count, size_t n, size_t r,  \
+                                   bool* singular) {                                        \
+    long blocks = (long)((count + BATCH_LANES - 1) / BATCH_LANES);                          \
+    size_t block_elems = (n * n + n * r) * BATCH_LANES;                                     \
+    int failed = 0;                                                                         \
+    int any_singular = 0;                                                                   \
+    _Pragma("omp parallel reduction(|:failed, any_singular)")                               \
+    {                                                                                       \
+        T* buf = (T*)malloc(block_elems * sizeof(T));                                       \
+        if (!buf) failed = 1;                                                               \
+        _Pragma("omp for schedule(static)")                                                 \
+        for (long blk = 0; blk < blocks; blk++) {                                           \
+            if (!buf) continue;                                                             \
+            size_t first = (size_t)blk * BATCH_LANES;                                       \
+            size_t lanes = batch_lanes(count, first);                                       \
+            bool lane_singular[BATCH_LANES];                                                \
+            T* sa = buf;                                                                    \
+            T* sb = sa + n * n * BATCH_LANES;                                               \
+            S##_pack(a, first, lanes, n * n, sa);                                           \
+            S##_pack(b, first, lanes, n * r, sb);                                           \
+            S##_solve_block(sa, sb, n, r, lane_singular);                                   \
+            S##_unpack(x, first, lanes, n * r, sb, lane_singular);                          \
+            for (size_t l = 0; l < lanes; l++) {                                            \
+                any_singular |= lane_singular[l];                                           \
+                if (singular) singular[first + l] = lane_singular[l];                       \
+            }                                                                               \
+        }                                                                                   \
+        free(buf);                                                                          \
+    }                                                                                       \
+    if (failed) return MATRIX_ERROR_MEMORY;                                                 \
+    return any_singular ? MATRIX_ERROR_SINGULAR_MATRIX : MATRIX_OK;                         \
+}
+
+BATCH_KERNELS(float, float, FLT_EPSILON)
+BATCH_KERNELS(double, double, DBL_EPSILON)
+
+static bool batch_type_supported(const FieldInfo* type) {
+    return type && (type->id == FIELD_ID_FLOAT || type->id == FIELD_ID_DOUBLE);
+}
+
+static MatrixError check_batch(const MatrixBatch* m, const FieldInfo* type, size_t count) {
+    if (!m) return MATRIX_ERROR_NULL_POINTER;
+    if (!m->data && m->count > 0) return MATRIX_ERROR_NULL_POINTER;
+    if (!m->type || m->type->id != type->id) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (m->count != count || m->stride < m->rows * m->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    return MATRIX_OK;
+}
+
+static BatchSource batch_source(const MatrixBatch* m) {
+    BatchSource s = { (char*)m->data, m->stride * m->type->size, NULL };
+    return s;
+}
+
+//Все матрицы массива должны совпадать по типу и размеру с первой
+static MatrixError check_array(const Matrix* const* items, size_t count, const FieldInfo* type,
+                               size_t rows, size_t cols) {
+    if (!items) return MATRIX_ERROR_NULL_POINTER;
+    for (size_t t = 0; t < count; t++) {
+        if (!items[t]) return MATRIX_ERROR_NULL_POINTER;
+        if (items[t]->type->id != type->id) return MATRIX_ERROR_TYPE_MISMATCH;
+        if (items[t]->rows != rows || items[t]->cols != cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    }
+    return MATRIX_OK;
+}
+
+//Выходные матрицы могут разделять буфер с клонами
+static MatrixError make_array_writable(Matrix* const* items, size_t count) {
+    for (size_t t = 0; t < count; t++) {
+        MatrixError err = matrix_make_writable(items[t]);
+        if (err != MATRIX_OK) return err;
+    }
+    return MATRIX_OK;
+}
+
+static BatchSource array_source(const Matrix* const* items) {
+    BatchSource s = { NULL, 0, items };
+    return s;
+}
+
+static MatrixError multiply_sources(const FieldInfo* type, const BatchSource* a, const BatchSource* b,
+                                    const BatchSource* c, size_t count, size_t m, size_t k, size_t n) {
+    if (count == 0) return MATRIX_OK;
+    if (type->id == FIELD_ID_DOUBLE) return double_multiply_batch(a, b, c, count, m, k, n);
+    return float_multiply_batch(a, b, c, count, m, k, n);
+}
+
+static MatrixError solve_sources(const FieldInfo* type, const BatchSource* a, const BatchSource* b,
+                                 const BatchSource* x, size_t count, size_t n, size_t r, bool* singular) {
+    if (count == 0) return MATRIX_OK;
+    if (type->id == FIELD_ID_DOUBLE) return double_solve_batch(a, b, x, count, n, r, singular);
+    return float_solve_batch(a, b, x, count, n, r, singular);
+}
+
+static MatrixError matrix_multiply_batch_impl(const MatrixBatch* a, const MatrixBatch* b, MatrixBatch* c) {
+    if (!a || !b || !c) return MATRIX_ERROR_NULL_POINTER;
+    if (!batch_type_supported(a->type)) return MATRIX_ERROR_TYPE_MISMATCH;
+    MatrixError err = check_batch(a, a->type, a->count);
+    if (err == MATRIX_OK) err = check_batch(b, a->type, a->count);
+    if (err == MATRIX_OK) err = check_batch(c, a->type, a->count);
+    if (err != MATRIX_OK) return err;
+    if (a->cols != b->rows || c->rows != a->rows || c->cols != b->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    BatchSource sa = batch_source(a), sb = batch_source(b), sc = batch_source(c);
+    return multiply_sources(a->type, &sa, &sb, &sc, a->count, a->rows, a->cols, b->cols);
+}
+
+static MatrixError matrix_solve_batch_impl(const MatrixBatch* a, const MatrixBatch* b, MatrixBatch* x,
+                                           bool* singular) {
+    if (!a || !b || !x) return MATRIX_ERROR_NULL_POINTER;
+    if (!batch_type_supported(a->type)) return MATRIX_ERROR_TYPE_MISMATCH;
+    MatrixError err = check_batch(a, a->type, a->count);
+    if (err == MATRIX_OK) err = check_batch(b, a->type, a->count);
+    if (err == MATRIX_OK) err = check_batch(x, a->type, a->count);
+    if (err != MATRIX_OK) return err;
+    if (a->rows != a->cols || b->rows != a->rows || x->rows != b->rows || x->cols != b->cols) {
+        return MATRIX_ERROR_DIMENSION_MISMATCH;
+    }
+
+    BatchSource sa = batch_source(a), sb = batch_source(b), sx = batch_source(x);
+    return solve_sources(a->type, &sa, &sb, &sx, a->count, a->rows, b->cols, singular);
+}
+
+static MatrixError matrix_multiply_array_impl(const Matrix* const* a, const Matrix* const* b,
+                                              Matrix* const* c, size_t count) {
+    if (!a || !b || !c) return MATRIX_ERROR_NULL_POINTER;
+    if (count == 0) return MATRIX_OK;
+    if (!a[0] || !b[0]) return MATRIX_ERROR_NULL_POINTER;
+    const FieldInfo* type = a[0]->type;
+    if (!batch_type_supported(type)) return MATRIX_ERROR_TYPE_MISMATCH;
+    size_t m = a[0]->rows, k = a[0]->cols, n = b[0]->cols;
+    if (b[0]->rows != k) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    MatrixError err = check_array(a, count, type, m, k);
+    if (err == MATRIX_OK) err = check_array(b, count, type, k, n);
+    if (err == MATRIX_OK) err = check_array((const Matrix* const*)c, count, type, m, n);
+    if (err == MATRIX_OK) err = make_array_writable(c, count);
+    if (err != MATRIX_OK) return err;
+
+    BatchSource sa = array_source(a), sb = array_source(b), sc = array_source((const Matrix* const*)c);
+    return multiply_sources(type, &sa, &sb, &sc, count, m, k, n);
+}
+
+static MatrixError matrix_solve_array_impl(const Matrix* const* a, const Matrix* const* b,
+                                           Matrix* const* x, size_t count, bool* singular) {
+    if (!a || !b || !x) return MATRIX_ERROR_NULL_POINTER;
+    if (count == 0) return MATRIX_OK;
+    if (!a[0] || !b[0]) return MATRIX_ERROR_NULL_POINTER;
+    const FieldInfo* type = a[0]->type;
+    if (!batch_type_supported(type)) return MATRIX_ERROR_TYPE_MISMATCH;
+    size_t n = a[0]->rows, r = b[0]->cols;
+
+    MatrixError err = check_array(a, count, type, n, n);
+    if (err == MATRIX_OK) err = check_array(b, count, type, n, r);
+    if (err == MATRIX_OK) err = check_array((const Matrix* const*)x, count, type, n, r);
+    if (err == MATRIX_OK) err = make_array_writable(x, count);
+    if (err != MATRIX_OK) return err;
+
+    BatchSource sa = array_source(a), sb = array_source(b), sx = array_source((const Matrix* const*)x);
+    return solve_sources(type, &sa, &sb, &sx, count, n, r, singular);
+}
+
+#define BATCH_MULTIPLY_FLOPS(count, m, k, n) (2ULL * (count) * (m) * (k) * (n))
+#define BATCH_SOLVE_FLOPS(count, n, r) ((count) * (2ULL * (n) * (n) * (n) / 3 + 2ULL * (n) * (n) * (r)))
+
+//Публичные функции
+MatrixError Matrix_MultiplyBatch(const MatrixBatch* a, const MatrixBatch* b, MatrixBatch* c) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MULTIPLY_BATCH);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MULTIPLY_BATCH), a ? a->rows : 0, a ? a->cols : 0);
+    MatrixError err = matrix_multiply_batch_impl(a, b, c);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? BATCH_MULTIPLY_FLOPS(a->count, a->rows, a->cols, b->cols) : 0);
+    return err;
+}
+
+MatrixError Matrix_SolveBatch(const MatrixBatch* a, const MatrixBatch* b, MatrixBatch* x, bool* singular) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_SOLVE_BATCH);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_SOLVE_BATCH), a ? a->rows : 0, a ? a->cols : 0);
+    MatrixError err = matrix_solve_batch_impl(a, b, x, singular);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? BATCH_SOLVE_FLOPS(a->count, a->rows, b->cols) : 0);
+    return err;
+}
+
+MatrixError Matrix_MultiplyArray(const Matrix* const* a, const Matrix* const* b, Matrix* const* c, size_t count) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MULTIPLY_BATCH);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MULTIPLY_BATCH), count, 1);
+    MatrixError err = matrix_multiply_array_impl(a, b, c, count);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK && count > 0 ? BATCH_MULTIPLY_FLOPS(count, a[0]->rows, a[0]->cols, b[0]->cols) : 0);
+    return err;
+}
+
+MatrixError Matrix_SolveArray(const Matrix* const* a, const Matrix* const* b, Matrix* const* x,
+                              size_t count, bool* singular) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_SOLVE_BATCH);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_SOLVE_BATCH), count, 1);
+    MatrixError err = matrix_solve_array_impl(a, b, x, count, singular);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK && count > 0 ? BATCH_SOLVE_FLOPS(count, a[0]->rows, b[0]->cols) : 0);
+    return err;
+}
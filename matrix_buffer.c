@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include "matrix.h"
+#include "matrix_buffer.h"
+#include "matrix_stats.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define MATRIX_HAVE_MMAP 1
+#endif
+
+struct MatrixBuffer {
+    atomic_size_t refs;
+    size_t bytes;
+    bool writable;
+    void* mapping;      //начало отображения файла, NULL для памяти из кучи
+};
+
+//Данные начинаются после заголовка с тем же выравниванием, что дает malloc
+#define BUFFER_HEADER ((sizeof(MatrixBuffer) + 63) & ~(size_t)63)
+
+MatrixBuffer* matrix_buffer_create(size_t bytes, void** data) {
+    MatrixBuffer* b = (MatrixBuffer*)malloc(BUFFER_HEADER + bytes);
+    if (!b) return NULL;
+    atomic_init(&b->refs, 1);
+    b->bytes = bytes;
+    b->writable = true;
+    b->mapping = NULL;
+    *data = (char*)b + BUFFER_HEADER;
+    MATRIX_STATS_ALLOC(bytes);
+    return b;
+}
+
+#ifdef MATRIX_HAVE_MMAP
+
+MatrixBuffer* matrix_buffer_map(const char* path, size_t bytes, void** data, MatrixError* error) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        *error = MATRIX_ERROR_IO;
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < bytes) {
+        close(fd);
+        *error = MATRIX_ERROR_INVALID_SIZE;
+        return NULL;
+    }
+
+    void* mapping = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        *error = MATRIX_ERROR_IO;
+        return NULL;
+    }
+
+    MatrixBuffer* b = (MatrixBuffer*)malloc(sizeof(MatrixBuffer));
+    if (!b) {
+        munmap(mapping, bytes);
+        *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    atomic_init(&b->refs, 1);
+    b->bytes = bytes;
+    b->writable = false;
+    b->mapping = mapping;
+    *data = mapping;
+    return b;
+}
+
+#else
+
+//Без mmap файл читается в кучу целиком; дальше буфер ведет себя как обычный
+MatrixBuffer* matrix_buffer_map(const char* path, size_t bytes, void** data, MatrixError* error) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        *error = MATRIX_ERROR_IO;
+        return NULL;
+    }
+    MatrixBuffer* b = matrix_buffer_create(bytes, data);
+    if (!b) {
+        fclose(f);
+        *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    size_t got = fread(*data, 1, bytes, f);
+    fclose(f);
+    if (got != bytes) {
+        matrix_buffer_release(b);
+        *error = MATRIX_ERROR_INVALID_SIZE;
+        return NULL;
+    }
+    return b;
+}
+
+#endif
+
+void matrix_buffer_retain(MatrixBuffer* b) {
+    atomic_fetch_add_explicit(&b->refs, 1, memory_order_relaxed);
+}
+
+void matrix_buffer_release(MatrixBuffer* b) {
+    if (!b || atomic_fetch_sub_explicit(&b->refs, 1, memory_order_acq_rel) != 1) return;
+#ifdef MATRIX_HAVE_MMAP
+    if (b->mapping) {
+        munmap(b->mapping, b->bytes);
+        free(b);
+        return;
+    }
+#endif
+    MATRIX_STATS_FREE(b->bytes);
+    free(b);
+}
+
+//Единственный владелец пишет на месте. Иначе копируется только область этой
+//матрицы (у представления - ее строки), а старый буфер остается остальным
+MatrixError matrix_make_writable(Matrix* m) {
+    MatrixBuffer* b = m->buffer;
+    if (b->writable && atomic_load_explicit(&b->refs, memory_order_acquire) == 1) return MATRIX_OK;
+
+    size_t bytes = m->rows * m->cols * m->type->size;
+    void* data = NULL;
+    MatrixBuffer* own = matrix_buffer_create(bytes, &data);
+    if (!own) return MATRIX_ERROR_MEMORY;
+    memcpy(data, m->data, bytes);
+    m->data = data;
+    m->buffer = own;
+    matrix_buffer_release(b);
+    return MATRIX_OK;
+}
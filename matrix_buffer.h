@@ -0,0 +1,18 @@
+#ifndef MATRIX_BUFFER_H
+#define MATRIX_BUFFER_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+//Буфер данных со счетчиком ссылок. Заголовок и данные - одно выделение памяти;
+//отображенный файл доступен только для чтения и копируется при первой записи
+MatrixBuffer* matrix_buffer_create(size_t bytes, void** data);
+MatrixBuffer* matrix_buffer_map(const char* path, size_t bytes, void** data, MatrixError* error);
+void matrix_buffer_retain(MatrixBuffer* b);
+void matrix_buffer_release(MatrixBuffer* b);
+
+//Вызывается перед любой записью в m->data: если буфер разделен с другой матрицей
+//или не допускает записи, m получает собственную копию своих элементов
+MatrixError matrix_make_writable(Matrix* m);
+
+#endif
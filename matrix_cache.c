@@ -0,0 +1,394 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "matrix.h"
+#include "matrix_cache.h"
+#include "matrix_trace.h"
+
+#define HASH_LANES 8
+#define HASH_STRIPE (HASH_LANES * sizeof(uint64_t))
+//Перемешивание дорожек через каждые 1 КБ, чтобы сумма не теряла старшие биты
+#define HASH_STRIPES_PER_SCRAMBLE 16
+#define HASH_PRIME32 0x9E3779B1u
+#define HASH_PRIME64 0x9E3779B185EBCA87ULL
+
+#define CACHE_INITIAL_BUCKETS 64
+
+static const uint64_t g_hash_key[HASH_LANES] = {
+    0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+    0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL
+};
+
+//Соседняя дорожка получает сами данные: нулевая половина в произведении не теряет вход
+static inline void hash_stripe(uint64_t* acc, const unsigned char* p) {
+    uint64_t w[HASH_LANES];
+    memcpy(w, p, sizeof(w));
+    for (int l = 0; l < HASH_LANES; l++) {
+        uint64_t d = w[l] ^ g_hash_key[l];
+        acc[l ^ 1] += w[l];
+        acc[l] += (d & 0xFFFFFFFFu) * (d >> 32);
+    }
+}
+
+static inline void hash_scramble(uint64_t* acc) {
+    for (int l = 0; l < HASH_LANES; l++) {
+        uint64_t v = acc[l] ^ (acc[l] >> 47) ^ g_hash_key[l];
+        acc[l] = v * HASH_PRIME32;
+    }
+}
+
+static inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t matrix_hash_bytes(const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t acc[HASH_LANES];
+    for (int l = 0; l < HASH_LANES; l++) acc[l] = g_hash_key[HASH_LANES - 1 - l];
+
+    size_t stripes = bytes / HASH_STRIPE;
+    for (size_t s = 0; s < stripes; s++) {
+        hash_stripe(acc, p + s * HASH_STRIPE);
+        if ((s + 1) % HASH_STRIPES_PER_SCRAMBLE == 0) hash_scramble(acc);
+    }
+    size_t tail = bytes - stripes * HASH_STRIPE;
+    if (tail > 0) {
+        unsigned char last[HASH_STRIPE] = {0};
+        memcpy(last, p + stripes * HASH_STRIPE, tail);
+        hash_stripe(acc, last);
+    }
+
+    uint64_t h = (uint64_t)bytes * HASH_PRIME64;
+    for (int l = 0; l < HASH_LANES; l++) h = (h ^ hash_mix(acc[l])) * HASH_PRIME64;
+    return hash_mix(h);
+}
+
+typedef struct CacheEntry {
+    MatrixCacheKey key;                 //key.data указывает на operands
+    void* operands[2];                  //копии байтов операндов для проверки совпадения
+    Matrix* value;
+    size_t* perm;
+    size_t bytes;
+    size_t refs;                        //читатели, сравнивающие операнды вне блокировки
+    bool linked;                        //false после вытеснения; освобождает последний читатель
+    struct CacheEntry* newer;           //список LRU: g_newest ... g_oldest
+    struct CacheEntry* older;
+    struct CacheEntry* next_in_bucket;
+} CacheEntry;
+
+//Таблица и список меняются под спин-блокировкой: под ней только поиск по хешу и
+//заголовку ключа, счетчик ссылок записи и перестановка указателей. Хеширование,
+//сравнение байтов операндов, клон и вычисления идут снаружи
+static atomic_flag g_cache_lock = ATOMIC_FLAG_INIT;
+static atomic_bool g_cache_enabled;
+static size_t g_budget;
+static size_t g_bytes;
+static size_t g_entries;
+static CacheEntry** g_buckets;
+static size_t g_bucket_count;
+static CacheEntry* g_newest;
+static CacheEntry* g_oldest;
+
+static _Atomic uint64_t g_hits;
+static _Atomic uint64_t g_misses;
+static _Atomic uint64_t g_evictions;
+
+static void cache_lock(void) {
+    while (atomic_flag_test_and_set_explicit(&g_cache_lock, memory_order_acquire)) {
+    }
+}
+
+static void cache_unlock(void) {
+    atomic_flag_clear_explicit(&g_cache_lock, memory_order_release);
+}
+
+bool matrix_cache_key(MatrixCacheKey* key, MatrixCacheKind kind, const Matrix* a, const Matrix* b) {
+    if (!atomic_load_explicit(&g_cache_enabled, memory_order_relaxed)) return false;
+    //Без номера тип нельзя сравнить по значению
+    if (a->type->id == FIELD_ID_NONE || (b && b->type->id == FIELD_ID_NONE)) return false;
+
+    memset(key, 0, sizeof(*key));
+    key->kind = kind;
+    uint64_t h = hash_mix((uint64_t)kind + 1);
+    const Matrix* operands[2] = { a, b };
+    MATRIX_TRACE_BEGIN(span, "cache_hash", a->rows, a->cols);
+    for (int i = 0; i < 2 && operands[i]; i++) {
+        const Matrix* m = operands[i];
+        key->present[i] = true;
+        key->type_id[i] = m->type->id;
+        key->modulus[i] = m->type->modulus;
+        key->rows[i] = m->rows;
+        key->cols[i] = m->cols;
+        key->data[i] = m->data;
+        key->bytes[i] = m->rows * m->cols * m->type->size;
+        key->content[i] = matrix_hash_bytes(m->data, key->bytes[i]);
+        h = hash_mix(h ^ m->type->id ^ ((uint64_t)m->type->modulus << 32));
+        h = hash_mix(h ^ m->rows ^ ((uint64_t)m->cols << 32));
+        h = hash_mix(h ^ key->content[i]);
+    }
+    MATRIX_TRACE_END(span);
+    key->hash = h;
+    return true;
+}
+
+//Сравнение без байтов операндов: O(1), годится для вызова под блокировкой
+static bool keys_match(const MatrixCacheKey* a, const MatrixCacheKey* b) {
+    if (a->hash != b->hash || a->kind != b->kind) return false;
+    for (int i = 0; i < 2; i++) {
+        if (a->present[i] != b->present[i] || a->type_id[i] != b->type_id[i]) return false;
+        if (a->modulus[i] != b->modulus[i]) return false;
+        if (a->rows[i] != b->rows[i] || a->cols[i] != b->cols[i] || a->content[i] != b->content[i]) return false;
+    }
+    return true;
+}
+
+//Совпадение хеша еще не равенство: коллизия вернула бы результат другой матрицы.
+//O(n^2), вызывается без блокировки, пока запись удерживается ссылкой
+static bool operands_equal(const CacheEntry* e, const MatrixCacheKey* key) {
+    for (int i = 0; i < 2; i++) {
+        if (key->present[i] && memcmp(e->key.data[i], key->data[i], key->bytes[i]) != 0) return false;
+    }
+    return true;
+}
+
+static CacheEntry** bucket_of(uint64_t hash) {
+    return &g_buckets[hash & (g_bucket_count - 1)];
+}
+
+static CacheEntry* lookup(const MatrixCacheKey* key) {
+    if (!g_buckets) return NULL;
+    for (CacheEntry* e = *bucket_of(key->hash); e; e = e->next_in_bucket) {
+        if (keys_match(&e->key, key)) return e;
+    }
+    return NULL;
+}
+
+static void lru_unlink(CacheEntry* e) {
+    if (e->newer) e->newer->older = e->older; else g_newest = e->older;
+    if (e->older) e->older->newer = e->newer; else g_oldest = e->newer;
+    e->newer = e->older = NULL;
+}
+
+static void lru_push(CacheEntry* e) {
+    e->older = g_newest;
+    e->newer = NULL;
+    if (g_newest) g_newest->newer = e; else g_oldest = e;
+    g_newest = e;
+}
+
+//Запись убирается из таблицы и списка; освобождает ее вызывающий, уже без блокировки
+static void unlink_entry(CacheEntry* e) {
+    CacheEntry** p = bucket_of(e->key.hash);
+    while (*p != e) p = &(*p)->next_in_bucket;
+    *p = e->next_in_bucket;
+    lru_unlink(e);
+    e->linked = false;
+    g_bytes -= e->bytes;
+    g_entries--;
+}
+
+//Убранная запись идет в список на освобождение, если ее не держит читатель
+static void retire_entry(CacheEntry* e, CacheEntry** list) {
+    if (e->refs > 0) return;
+    e->next_in_bucket = *list;
+    *list = e;
+}
+
+static void free_entries(CacheEntry* list) {
+    while (list) {
+        CacheEntry* next = list->next_in_bucket;
+        Matrix_Destroy(list->value);
+        free(list->operands[0]);
+        free(list->operands[1]);
+        free(list->perm);
+        free(list);
+        list = next;
+    }
+}
+
+//Вытесняет самые старые записи, пока не освободится need байт; возвращает их список
+static CacheEntry* evict_for(size_t need) {
+    CacheEntry* evicted = NULL;
+    while (g_oldest && g_bytes + need > g_budget) {
+        CacheEntry* e = g_oldest;
+        unlink_entry(e);
+        retire_entry(e, &evicted);
+        atomic_fetch_add_explicit(&g_evictions, 1, memory_order_relaxed);
+    }
+    return evicted;
+}
+
+static void grow_buckets(void) {
+    size_t count = g_bucket_count ? g_bucket_count * 2 : CACHE_INITIAL_BUCKETS;
+    CacheEntry** buckets = (CacheEntry**)calloc(count, sizeof(CacheEntry*));
+    if (!buckets) return;
+    for (size_t i = 0; i < g_bucket_count; i++) {
+        CacheEntry* e = g_buckets[i];
+        while (e) {
+            CacheEntry* next = e->next_in_bucket;
+            CacheEntry** slot = &buckets[e->key.hash & (count - 1)];
+            e->next_in_bucket = *slot;
+            *slot = e;
+            e = next;
+        }
+    }
+    free(g_buckets);
+    g_buckets = buckets;
+    g_bucket_count = count;
+}
+
+//Кандидат по хешу удерживается ссылкой, байты сравниваются без блокировки.
+//Коллизия хеша с отличающимися байтами - промах (и store такую запись не заменит)
+Matrix* matrix_cache_find(const MatrixCacheKey* key, const FieldInfo* type, size_t* perm) {
+    Matrix* result = NULL;
+    cache_lock();
+    CacheEntry* e = lookup(key);
+    if (e) e->refs++;
+    cache_unlock();
+    if (!e) {
+        atomic_fetch_add_explicit(&g_misses, 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    //value и perm записи не меняются, пока она существует
+    if (operands_equal(e, key)) {
+        result = Matrix_Clone(e->value, NULL);
+        if (result) {
+            //Описание, с которым запись сохранена, могло быть уже удалено
+            result->type = type;
+            if (e->perm) memcpy(perm, e->perm, key->rows[0] * sizeof(size_t));
+        }
+    }
+
+    cache_lock();
+    if (result && e->linked) {
+        lru_unlink(e);
+        lru_push(e);
+    }
+    bool release = --e->refs == 0 && !e->linked;
+    cache_unlock();
+    if (release) {
+        e->next_in_bucket = NULL;
+        free_entries(e);
+    }
+    atomic_fetch_add_explicit(result ? &g_hits : &g_misses, 1, memory_order_relaxed);
+    return result;
+}
+
+void matrix_cache_store(const MatrixCacheKey* key, const Matrix* value, const size_t* perm) {
+    size_t perm_bytes = perm ? key->rows[0] * sizeof(size_t) : 0;
+    size_t bytes = sizeof(CacheEntry) + value->rows * value->cols * value->type->size + perm_bytes +
+                   key->bytes[0] + key->bytes[1];
+
+    CacheEntry* e = (CacheEntry*)calloc(1, sizeof(CacheEntry));
+    Matrix* clone = Matrix_Clone(value, NULL);
+    size_t* perm_copy = perm ? (size_t*)malloc(perm_bytes) : NULL;
+    //Копии, а не клоны операндов: клон делит буфер, и прямая запись в data
+    //изменила бы и образец для сравнения
+    void* first = malloc(key->bytes[0]);
+    void* second = key->present[1] ? malloc(key->bytes[1]) : NULL;
+    if (!e || !clone || (perm && !perm_copy) || !first || (key->present[1] && !second)) {
+        free(e);
+        Matrix_Destroy(clone);
+        free(perm_copy);
+        free(first);
+        free(second);
+        return;
+    }
+    if (perm) memcpy(perm_copy, perm, perm_bytes);
+    memcpy(first, key->data[0], key->bytes[0]);
+    if (second) memcpy(second, key->data[1], key->bytes[1]);
+    e->key = *key;
+    e->key.data[0] = e->operands[0] = first;
+    e->key.data[1] = e->operands[1] = second;
+    e->value = clone;
+    e->perm = perm_copy;
+    e->bytes = bytes;
+    e->linked = true;
+
+    CacheEntry* evicted = NULL;
+    cache_lock();
+    //Кэш мог быть выключен или запись добавлена другим потоком, пока шли вычисления
+    bool insert = atomic_load_explicit(&g_cache_enabled, memory_order_relaxed) &&
+                  bytes <= g_budget && !lookup(key);
+    if (insert) {
+        evicted = evict_for(bytes);
+        if (g_entries >= g_bucket_count) grow_buckets();
+        insert = g_buckets != NULL;
+    }
+    if (insert) {
+        CacheEntry** slot = bucket_of(key->hash);
+        e->next_in_bucket = *slot;
+        *slot = e;
+        lru_push(e);
+        g_bytes += bytes;
+        g_entries++;
+        e = NULL;
+    }
+    cache_unlock();
+
+    free_entries(evicted);
+    if (e) {
+        e->next_in_bucket = NULL;
+        free_entries(e);
+    }
+}
+
+//Публичные функции
+MatrixError Matrix_CacheEnable(size_t budget_bytes) {
+    if (budget_bytes == 0) return MATRIX_ERROR_INVALID_SIZE;
+    cache_lock();
+    g_budget = budget_bytes;
+    CacheEntry* evicted = evict_for(0);
+    atomic_store_explicit(&g_cache_enabled, true, memory_order_relaxed);
+    cache_unlock();
+    free_entries(evicted);
+    return MATRIX_OK;
+}
+
+void Matrix_CacheClear(void) {
+    cache_lock();
+    CacheEntry* list = NULL;
+    while (g_oldest) {
+        CacheEntry* e = g_oldest;
+        unlink_entry(e);
+        retire_entry(e, &list);
+    }
+    cache_unlock();
+    free_entries(list);
+}
+
+void Matrix_CacheDisable(void) {
+    atomic_store_explicit(&g_cache_enabled, false, memory_order_relaxed);
+    Matrix_CacheClear();
+    cache_lock();
+    free(g_buckets);
+    g_buckets = NULL;
+    g_bucket_count = 0;
+    cache_unlock();
+}
+
+MatrixError Matrix_GetCacheStats(MatrixCacheStats* out) {
+    if (!out) return MATRIX_ERROR_NULL_POINTER;
+    cache_lock();
+    out->enabled = atomic_load_explicit(&g_cache_enabled, memory_order_relaxed);
+    out->entries = g_entries;
+    out->bytes = g_bytes;
+    out->budget_bytes = g_budget;
+    cache_unlock();
+    out->hits = atomic_load_explicit(&g_hits, memory_order_relaxed);
+    out->misses = atomic_load_explicit(&g_misses, memory_order_relaxed);
+    out->evictions = atomic_load_explicit(&g_evictions, memory_order_relaxed);
+    return MATRIX_OK;
+}
+
+void Matrix_ResetCacheStats(void) {
+    atomic_store_explicit(&g_hits, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_misses, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_evictions, 0, memory_order_relaxed);
+}
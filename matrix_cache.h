@@ -0,0 +1,47 @@
+#ifndef MATRIX_CACHE_H
+#define MATRIX_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "matrix.h"
+
+//Результат, который хранится в кэше: произведение A * B или множители LU матрицы A
+typedef enum {
+    MATRIX_CACHE_PRODUCT = 0,
+    MATRIX_CACHE_LU
+} MatrixCacheKind;
+
+//Ключ: вид результата, тип, размеры и хеш содержимого каждого операнда. Тип
+//хранится значениями (номер и модуль): описание GF(p) может быть удалено,
+//пока запись остается в кэше. data указывает на байты операнда: у ключа
+//вызывающего - на m->data, у записи кэша - на ее собственную копию; совпадение
+//хешей подтверждается сравнением этих байтов
+typedef struct {
+    MatrixCacheKind kind;
+    bool present[2];
+    uint32_t type_id[2];
+    uint32_t modulus[2];
+    size_t rows[2];
+    size_t cols[2];
+    uint64_t content[2];
+    const void* data[2];
+    size_t bytes[2];
+    uint64_t hash;
+} MatrixCacheKey;
+
+//Хеш байтов: 8 независимых 64-битных дорожек с умножением 32 x 32 -> 64,
+//цикл векторизуется (pmuludq)
+uint64_t matrix_hash_bytes(const void* data, size_t bytes);
+
+//false, если кэш выключен или тип операнда не зарегистрирован (ключ не
+//заполняется); b = NULL для одного операнда. Содержимое хешируется при каждом
+//вызове: прямую запись в m->data версия буфера не отражает. Ключ ссылается на
+//данные операндов и годен, пока они не меняются
+bool matrix_cache_key(MatrixCacheKey* key, MatrixCacheKind kind, const Matrix* a, const Matrix* b);
+//Найденный результат возвращается клоном (O(1), буфер общий с кэшем) с типом
+//type - типом результата у вызывающего (для произведения - продвинутым типом
+//операндов); perm (для LU, a->rows элементов) копируется в массив вызывающего
+Matrix* matrix_cache_find(const MatrixCacheKey* key, const FieldInfo* type, size_t* perm);
+void matrix_cache_store(const MatrixCacheKey* key, const Matrix* value, const size_t* perm);
+
+#endif
@@ -0,0 +1,332 @@
+#include <stdlib.h>
+#include <string.h>
+#include "matrix.h"
+#include "float_field.h"
+#include "matrix_multiply.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Подцепочки дешевле этого числа умножений-сложений считаются одновременно:
+//для них одно ядро на поток выгоднее распараллеливания внутри умножения
+#define CHAIN_CONCURRENT_MAX (1ULL << 22)
+
+//Промежуточные результаты: буфер после использования возвращается в пул и
+//берется следующим умножением, которому хватает его емкости
+typedef struct {
+    Matrix* m;
+    size_t rows;        //размеры при создании, восстанавливаются перед удалением
+    size_t cols;
+    bool in_use;
+} ChainBuffer;
+
+typedef struct {
+    const Matrix* const* inputs;
+    const MatrixChainPlan* plan;
+    const unsigned long long* cost;
+    const FieldInfo* type;
+    ChainBuffer* buffers;
+    size_t buffer_count;
+} ChainContext;
+
+static MatrixError check_chain(const Matrix* const* matrices, size_t count) {
+    if (!matrices) return MATRIX_ERROR_NULL_POINTER;
+    if (count == 0) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    for (size_t i = 0; i < count; i++) {
+        if (!matrices[i]) return MATRIX_ERROR_NULL_POINTER;
+        if (!FieldInfo_Equals(matrices[i]->type, matrices[0]->type)) return MATRIX_ERROR_TYPE_MISMATCH;
+        if (i > 0 && matrices[i - 1]->cols != matrices[i]->rows) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    }
+    return MATRIX_OK;
+}
+
+//Классическое ДП по длине отрезка: cost[i][j] - минимум умножений-сложений для A_i..A_j
+static MatrixChainPlan* plan_chain(const Matrix* const* matrices, size_t count, unsigned long long** cost_out) {
+    MatrixChainPlan* plan = (MatrixChainPlan*)malloc(sizeof(MatrixChainPlan));
+    size_t* split = (size_t*)calloc(count * count, sizeof(size_t));
+    unsigned long long* cost = (unsigned long long*)calloc(count * count, sizeof(unsigned long long));
+    size_t* dims = (size_t*)malloc((count + 1) * sizeof(size_t));
+    if (!plan || !split || !cost || !dims) {
+        free(plan);
+        free(split);
+        free(cost);
+        free(dims);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) dims[i] = matrices[i]->rows;
+    dims[count] = matrices[count - 1]->cols;
+
+    for (size_t len = 2; len <= count; len++) {
+        for (size_t i = 0; i + len <= count; i++) {
+            size_t j = i + len - 1;
+            unsigned long long best = ~0ULL;
+            for (size_t s = i; s < j; s++) {
+                unsigned long long c = cost[i * count + s] + cost[(s + 1) * count + j] +
+                                       (unsigned long long)dims[i] * dims[s + 1] * dims[j + 1];
+                if (c < best) {
+                    best = c;
+                    split[i * count + j] = s;
+                }
+            }
+            cost[i * count + j] = best;
+        }
+    }
+
+    unsigned long long naive = 0;
+    for (size_t j = 1; j < count; j++) naive += (unsigned long long)dims[0] * dims[j] * dims[j + 1];
+
+    plan->count = count;
+    plan->split = split;
+    plan->flops = 2 * cost[count - 1];
+    plan->naive_flops = 2 * naive;
+    free(dims);
+
+    if (cost_out) {
+        *cost_out = cost;
+    } else {
+        free(cost);
+    }
+    return plan;
+}
+
+static Matrix* acquire_buffer(ChainContext* ctx, size_t rows, size_t cols) {
+    Matrix* result = NULL;
+    #pragma omp critical(matrix_chain_pool)
+    {
+        ChainBuffer* best = NULL;
+        for (size_t i = 0; i < ctx->buffer_count; i++) {
+            ChainBuffer* b = &ctx->buffers[i];
+            if (b->in_use || b->rows * b->cols < rows * cols) continue;
+            if (!best || b->rows * b->cols < best->rows * best->cols) best = b;
+        }
+        if (!best) {
+            Matrix* m = Matrix_Create(rows, cols, ctx->type);
+            if (m) {
+                best = &ctx->buffers[ctx->buffer_count++];
+                best->m = m;
+                best->rows = rows;
+                best->cols = cols;
+            }
+        }
+        if (best) {
+            best->in_use = true;
+            best->m->rows = rows;
+            best->m->cols = cols;
+            result = best->m;
+        }
+    }
+    return result;
+}
+
+static void release_buffer(ChainContext* ctx, Matrix* m) {
+    #pragma omp critical(matrix_chain_pool)
+    {
+        for (size_t i = 0; i < ctx->buffer_count; i++) {
+            if (ctx->buffers[i].m == m) ctx->buffers[i].in_use = false;
+        }
+    }
+}
+
+//Произведение A_i..A_j. Корень пишется в новую матрицу точного размера, остальные
+//узлы - в буферы пула; входные матрицы не копируются
+static bool chain_eval(ChainContext* ctx, size_t i, size_t j, bool root, Matrix** out) {
+    if (i == j) {
+        *out = (Matrix*)ctx->inputs[i];
+        return true;
+    }
+
+    size_t count = ctx->plan->count;
+    size_t s = ctx->plan->split[i * count + j];
+    Matrix* left = NULL;
+    Matrix* right = NULL;
+    bool left_ok = true, right_ok = true;
+
+    bool concurrent = s > i && s + 1 < j &&
+                      ctx->cost[i * count + s] < CHAIN_CONCURRENT_MAX &&
+                      ctx->cost[(s + 1) * count + j] < CHAIN_CONCURRENT_MAX;
+    if (concurrent) {
+        #pragma omp parallel sections num_threads(2)
+        {
+            #pragma omp section
+            left_ok = chain_eval(ctx, i, s, false, &left);
+            #pragma omp section
+            right_ok = chain_eval(ctx, s + 1, j, false, &right);
+        }
+    } else {
+        left_ok = chain_eval(ctx, i, s, false, &left);
+        right_ok = left_ok && chain_eval(ctx, s + 1, j, false, &right);
+    }
+
+    bool ok = left_ok && right_ok;
+    Matrix* c = NULL;
+    if (ok) {
+        size_t rows = ctx->inputs[i]->rows, cols = ctx->inputs[j]->cols;
+        c = root ? Matrix_Create(rows, cols, ctx->type) : acquire_buffer(ctx, rows, cols);
+        ok = c && matrix_multiply_into(left, right, c);
+    }
+
+    if (left && s > i) release_buffer(ctx, left);
+    if (right && s + 1 < j) release_buffer(ctx, right);
+    if (!ok) {
+        if (root) {
+            Matrix_Destroy(c);
+        } else if (c) {
+            release_buffer(ctx, c);
+        }
+        return false;
+    }
+    *out = c;
+    return true;
+}
+
+//half и bfloat16 умножаются во float, результат округляется один раз
+static Matrix* chain_to_float(const Matrix* m) {
+    Matrix* f = Matrix_Create(m->rows, m->cols, GetFloatFieldInfo());
+    if (f) m->type->to_float((float*)f->data, m->data, m->rows * m->cols);
+    return f;
+}
+
+static Matrix* multiply_chain(const Matrix* const* matrices, size_t count, const MatrixChainPlan* plan,
+                              const unsigned long long* cost, MatrixError* error) {
+    const FieldInfo* type = matrices[0]->type;
+    bool widen = type != GetFloatFieldInfo() && type->to_float && type->from_float;
+
+    Matrix** converted = NULL;
+    const Matrix* const* inputs = matrices;
+    if (widen) {
+        converted = (Matrix**)calloc(count, sizeof(Matrix*));
+        bool ok = converted != NULL;
+        for (size_t i = 0; ok && i < count; i++) ok = (converted[i] = chain_to_float(matrices[i])) != NULL;
+        if (!ok) {
+            for (size_t i = 0; converted && i < count; i++) Matrix_Destroy(converted[i]);
+            free(converted);
+            if (error) *error = MATRIX_ERROR_MEMORY;
+            return NULL;
+        }
+        inputs = (const Matrix* const*)converted;
+    }
+
+    //Промежуточных результатов не больше count - 2
+    ChainContext ctx = { inputs, plan, cost, widen ? GetFloatFieldInfo() : type, NULL, 0 };
+    ctx.buffers = (ChainBuffer*)calloc(count, sizeof(ChainBuffer));
+    Matrix* result = NULL;
+    bool ok = ctx.buffers != NULL;
+    if (ok) {
+        MATRIX_TRACE_BEGIN(eval_span, "chain_evaluate", count, 1);
+        ok = chain_eval(&ctx, 0, count - 1, true, &result);
+        MATRIX_TRACE_END(eval_span);
+    }
+
+    for (size_t i = 0; i < ctx.buffer_count; i++) {
+        ctx.buffers[i].m->rows = ctx.buffers[i].rows;
+        ctx.buffers[i].m->cols = ctx.buffers[i].cols;
+        Matrix_Destroy(ctx.buffers[i].m);
+    }
+    free(ctx.buffers);
+
+    if (ok && widen) {
+        Matrix* narrowed = Matrix_Create(result->rows, result->cols, type);
+        if (narrowed) type->from_float(narrowed->data, (const float*)result->data, result->rows * result->cols);
+        Matrix_Destroy(result);
+        result = narrowed;
+        ok = result != NULL;
+    }
+    if (converted) {
+        for (size_t i = 0; i < count; i++) Matrix_Destroy(converted[i]);
+        free(converted);
+    }
+
+    if (!ok) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+    return result;
+}
+
+static MatrixChainPlan* matrix_plan_chain_impl(const Matrix* const* matrices, size_t count, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    MatrixError err = check_chain(matrices, count);
+    if (err != MATRIX_OK) {
+        if (error) *error = err;
+        return NULL;
+    }
+
+    MatrixChainPlan* plan = plan_chain(matrices, count, NULL);
+    if (!plan && error) *error = MATRIX_ERROR_MEMORY;
+    return plan;
+}
+
+static Matrix* matrix_multiply_chain_impl(const Matrix* const* matrices, size_t count,
+                                          unsigned long long* flops, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    *flops = 0;
+
+    MatrixError err = check_chain(matrices, count);
+    if (err != MATRIX_OK) {
+        if (error) *error = err;
+        return NULL;
+    }
+
+    if (count == 1) return Matrix_Clone(matrices[0], error);
+
+    unsigned long long* cost = NULL;
+    MatrixChainPlan* plan = plan_chain(matrices, count, &cost);
+    if (!plan) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    Matrix* result = multiply_chain(matrices, count, plan, cost, error);
+    if (result) *flops = plan->flops;
+    free(cost);
+    MatrixChainPlan_Destroy(plan);
+    return result;
+}
+
+static void print_plan(const MatrixChainPlan* plan, size_t i, size_t j, FILE* output) {
+    if (i == j) {
+        fprintf(output, "A%zu", i);
+        return;
+    }
+    size_t s = plan->split[i * plan->count + j];
+    fprintf(output, "(");
+    print_plan(plan, i, s, output);
+    fprintf(output, " ");
+    print_plan(plan, s + 1, j, output);
+    fprintf(output, ")");
+}
+
+//Публичные функции
+MatrixChainPlan* Matrix_PlanChain(const Matrix* const* matrices, size_t count, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_PLAN_CHAIN);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_PLAN_CHAIN), count, 1);
+    MatrixChainPlan* plan = matrix_plan_chain_impl(matrices, count, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return plan;
+}
+
+MatrixError MatrixChainPlan_Print(const MatrixChainPlan* plan, FILE* output) {
+    if (!plan || !output) return MATRIX_ERROR_NULL_POINTER;
+    print_plan(plan, 0, plan->count - 1, output);
+    fprintf(output, "\n");
+    return MATRIX_OK;
+}
+
+void MatrixChainPlan_Destroy(MatrixChainPlan* plan) {
+    if (plan) {
+        free(plan->split);
+        free(plan);
+    }
+}
+
+Matrix* Matrix_MultiplyChain(const Matrix* const* matrices, size_t count, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MULTIPLY_CHAIN);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MULTIPLY_CHAIN), count, 1);
+    unsigned long long flops = 0;
+    Matrix* result = matrix_multiply_chain_impl(matrices, count, &flops, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(flops);
+    return result;
+}
@@ -0,0 +1,345 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "matrix.h"
+#include "float_field.h"
+#include "complex_field.h"
+#include "matrix_complex.h"
+#include "matrix_buffer.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define COMPLEX_HAVE_AVX_DISPATCH 1
+#endif
+
+//y += s * x для n комплексных чисел
+typedef void (*ComplexAxpyFunc)(ComplexFloat* y, ComplexFloat s, const ComplexFloat* x, size_t n);
+
+static void complex_axpy_scalar(ComplexFloat* y, ComplexFloat s, const ComplexFloat* x, size_t n) {
+    for (size_t j = 0; j < n; j++) {
+        float re = s.re * x[j].re - s.im * x[j].im;
+        float im = s.re * x[j].im + s.im * x[j].re;
+        y[j].re += re;
+        y[j].im += im;
+    }
+}
+
+#ifdef COMPLEX_HAVE_AVX_DISPATCH
+
+//Четыре комплексных числа в регистре: s.re * (xr, xi) и s.im * (xi, xr),
+//addsub вычитает в четных позициях и складывает в нечетных
+__attribute__((target("avx")))
+static void complex_axpy_avx(ComplexFloat* y, ComplexFloat s, const ComplexFloat* x, size_t n) {
+    __m256 sr = _mm256_set1_ps(s.re);
+    __m256 si = _mm256_set1_ps(s.im);
+    float* fy = (float*)y;
+    const float* fx = (const float*)x;
+
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256 vx = _mm256_loadu_ps(fx + 2 * j);
+        __m256 swapped = _mm256_permute_ps(vx, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 prod = _mm256_addsub_ps(_mm256_mul_ps(sr, vx), _mm256_mul_ps(si, swapped));
+        _mm256_storeu_ps(fy + 2 * j, _mm256_add_ps(_mm256_loadu_ps(fy + 2 * j), prod));
+    }
+    complex_axpy_scalar(y + j, s, x + j, n - j);
+}
+
+#endif
+
+static ComplexAxpyFunc select_complex_axpy(void) {
+#ifdef COMPLEX_HAVE_AVX_DISPATCH
+    if (__builtin_cpu_supports("avx")) return complex_axpy_avx;
+#endif
+    return complex_axpy_scalar;
+}
+
+static float complex_norm2(ComplexFloat z) {
+    return z.re * z.re + z.im * z.im;
+}
+
+static ComplexFloat complex_mul(ComplexFloat a, ComplexFloat b) {
+    ComplexFloat r = {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+    return r;
+}
+
+//1 / z по Смиту, z != 0
+static ComplexFloat complex_reciprocal(ComplexFloat z) {
+    ComplexFloat r;
+    if (fabsf(z.re) >= fabsf(z.im)) {
+        float t = z.im / z.re;
+        float d = z.re + z.im * t;
+        r.re = 1.0f / d;
+        r.im = -t / d;
+    } else {
+        float t = z.re / z.im;
+        float d = z.re * t + z.im;
+        r.re = t / d;
+        r.im = -1.0f / d;
+    }
+    return r;
+}
+
+//Порядок i-k-j: строка C накапливает a_ip * (строка p матрицы B)
+void complex_gemm(const ComplexFloat* a, const ComplexFloat* b, ComplexFloat* c,
+                  size_t m, size_t k, size_t n) {
+    ComplexAxpyFunc axpy = select_complex_axpy();
+    memset(c, 0, m * n * sizeof(ComplexFloat));
+
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long)m; i++) {
+        ComplexFloat* c_row = c + (size_t)i * n;
+        for (size_t p = 0; p < k; p++) {
+            //Без пропуска нулей: 0 * Inf и 0 * NaN из B должны дать NaN
+            ComplexFloat a_ip = a[(size_t)i * k + p];
+            axpy(c_row, a_ip, b + p * n, n);
+        }
+    }
+}
+
+//Главный элемент - наибольший |z|; сравниваются квадраты модулей, без sqrt.
+//Порог вырожденности тот же, что у float: |z| < 1e-10
+MatrixError complex_gauss_solve(const ComplexFloat* a, const ComplexFloat* b, ComplexFloat* x, size_t n) {
+    size_t cols = n + 1;
+    ComplexFloat* w = (ComplexFloat*)malloc(n * cols * sizeof(ComplexFloat));
+    if (!w) return MATRIX_ERROR_MEMORY;
+
+    MATRIX_TRACE_BEGIN(augment_span, "gauss_augment", n, cols);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(w + i * cols, a + i * n, n * sizeof(ComplexFloat));
+        w[i * cols + n] = b[i];
+    }
+    MATRIX_TRACE_END(augment_span);
+
+    ComplexAxpyFunc axpy = select_complex_axpy();
+
+    for (size_t k = 0; k < n; k++) {
+        MATRIX_TRACE_BEGIN(pivot_span, "gauss_pivot_search", n - k, 1);
+        size_t max_row = k;
+        float max_norm = complex_norm2(w[k * cols + k]);
+        for (size_t i = k + 1; i < n; i++) {
+            float cur = complex_norm2(w[i * cols + k]);
+            if (cur > max_norm) {
+                max_norm = cur;
+                max_row = i;
+            }
+        }
+        MATRIX_TRACE_END(pivot_span);
+
+        if (!(max_norm >= 1e-20f)) {
+            free(w);
+            return MATRIX_ERROR_SINGULAR_MATRIX;
+        }
+
+        if (max_row != k) {
+            for (size_t j = k; j < cols; j++) {
+                ComplexFloat t = w[k * cols + j];
+                w[k * cols + j] = w[max_row * cols + j];
+                w[max_row * cols + j] = t;
+            }
+        }
+
+        const ComplexFloat* pivot_row = w + k * cols;
+        ComplexFloat inv_pivot = complex_reciprocal(pivot_row[k]);
+
+        MATRIX_TRACE_BEGIN(eliminate_span, "gauss_eliminate", n - k - 1, cols - k);
+        #pragma omp parallel for schedule(static)
+        for (long i = (long)k + 1; i < (long)n; i++) {
+            ComplexFloat* row = w + (size_t)i * cols;
+            if (row[k].re == 0.0f && row[k].im == 0.0f) continue;
+            ComplexFloat factor = complex_mul(row[k], inv_pivot);
+            factor.re = -factor.re;
+            factor.im = -factor.im;
+            axpy(row + k + 1, factor, pivot_row + k + 1, cols - k - 1);
+            row[k].re = 0.0f;
+            row[k].im = 0.0f;
+        }
+        MATRIX_TRACE_END(eliminate_span);
+    }
+
+    MATRIX_TRACE_BEGIN(back_span, "gauss_back_substitution", n, 1);
+    for (size_t i = n; i-- > 0; ) {
+        const ComplexFloat* row = w + i * cols;
+        ComplexFloat acc = row[n];
+        for (size_t j = i + 1; j < n; j++) {
+            ComplexFloat t = complex_mul(row[j], x[j]);
+            acc.re -= t.re;
+            acc.im -= t.im;
+        }
+        x[i] = complex_mul(acc, complex_reciprocal(row[i]));
+    }
+    MATRIX_TRACE_END(back_span);
+
+    free(w);
+    return MATRIX_OK;
+}
+
+//Раздельное хранение
+static SplitComplexMatrix* split_create(size_t rows, size_t cols) {
+    SplitComplexMatrix* s = (SplitComplexMatrix*)malloc(sizeof(SplitComplexMatrix));
+    if (!s) return NULL;
+    s->re = Matrix_Create(rows, cols, GetFloatFieldInfo());
+    s->im = Matrix_Create(rows, cols, GetFloatFieldInfo());
+    if (!s->re || !s->im) {
+        SplitComplexMatrix_Destroy(s);
+        return NULL;
+    }
+    return s;
+}
+
+static bool split_valid(const SplitComplexMatrix* s) {
+    return s && s->re && s->im &&
+           s->re->type == GetFloatFieldInfo() && s->im->type == GetFloatFieldInfo() &&
+           s->re->rows == s->im->rows && s->re->cols == s->im->cols;
+}
+
+static SplitComplexMatrix* matrix_to_split_complex_impl(const Matrix* m, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    if (m->type != GetComplexFieldInfo()) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    SplitComplexMatrix* s = split_create(m->rows, m->cols);
+    if (!s) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    const ComplexFloat* src = (const ComplexFloat*)m->data;
+    float* re = (float*)s->re->data;
+    float* im = (float*)s->im->data;
+    for (size_t i = 0; i < m->rows * m->cols; i++) {
+        re[i] = src[i].re;
+        im[i] = src[i].im;
+    }
+    return s;
+}
+
+static Matrix* split_complex_to_matrix_impl(const SplitComplexMatrix* s, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    if (!s) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    if (!split_valid(s)) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    Matrix* m = Matrix_Create(s->re->rows, s->re->cols, GetComplexFieldInfo());
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    ComplexFloat* dst = (ComplexFloat*)m->data;
+    const float* re = (const float*)s->re->data;
+    const float* im = (const float*)s->im->data;
+    for (size_t i = 0; i < m->rows * m->cols; i++) {
+        dst[i].re = re[i];
+        dst[i].im = im[i];
+    }
+    return m;
+}
+
+//Умножение 3M: T1 = Ar Br, T2 = Ai Bi, T3 = (Ar + Ai)(Br + Bi),
+//Re = T1 - T2, Im = T3 - T1 - T2. Три вещественных умножения вместо четырех;
+//мнимая часть теряет точность при сильном сокращении в T3 - T1 - T2
+static SplitComplexMatrix* split_complex_multiply_impl(const SplitComplexMatrix* a, const SplitComplexMatrix* b,
+                                                       MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+    if (!a || !b) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+    if (!split_valid(a) || !split_valid(b)) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+    if (a->re->cols != b->re->rows) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+
+    Matrix* sum_a = Matrix_Add(a->re, a->im, NULL);
+    Matrix* sum_b = Matrix_Add(b->re, b->im, NULL);
+    Matrix* t1 = Matrix_Multiply(a->re, b->re, NULL);
+    Matrix* t2 = Matrix_Multiply(a->im, b->im, NULL);
+    Matrix* t3 = (sum_a && sum_b) ? Matrix_Multiply(sum_a, sum_b, NULL) : NULL;
+    Matrix_Destroy(sum_a);
+    Matrix_Destroy(sum_b);
+
+    //Произведение из кэша делит буфер с записью кэша (а t1 и t2 - друг с другом,
+    //если совпали): T1 и T3 перезаписываются на месте, поэтому нужны свои копии
+    bool writable = t1 && t2 && t3 && matrix_make_writable(t1) == MATRIX_OK &&
+                    matrix_make_writable(t3) == MATRIX_OK;
+    SplitComplexMatrix* result = writable ? (SplitComplexMatrix*)malloc(sizeof(SplitComplexMatrix)) : NULL;
+    if (!result) {
+        Matrix_Destroy(t1);
+        Matrix_Destroy(t2);
+        Matrix_Destroy(t3);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    MATRIX_TRACE_BEGIN(combine_span, "split_complex_combine", t1->rows, t1->cols);
+    float* p1 = (float*)t1->data;
+    const float* p2 = (const float*)t2->data;
+    float* p3 = (float*)t3->data;
+    for (size_t i = 0; i < t1->rows * t1->cols; i++) {
+        p3[i] -= p1[i] + p2[i];
+        p1[i] -= p2[i];
+    }
+    MATRIX_TRACE_END(combine_span);
+
+    Matrix_Destroy(t2);
+    result->re = t1;
+    result->im = t3;
+    return result;
+}
+
+//Публичные функции
+SplitComplexMatrix* Matrix_ToSplitComplex(const Matrix* m, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_TO_SPLIT_COMPLEX);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_TO_SPLIT_COMPLEX), m ? m->rows : 0, m ? m->cols : 0);
+    SplitComplexMatrix* s = matrix_to_split_complex_impl(m, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return s;
+}
+
+Matrix* SplitComplexMatrix_ToMatrix(const SplitComplexMatrix* s, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_FROM_SPLIT_COMPLEX);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_FROM_SPLIT_COMPLEX),
+                       s && s->re ? s->re->rows : 0, s && s->re ? s->re->cols : 0);
+    Matrix* m = split_complex_to_matrix_impl(s, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return m;
+}
+
+SplitComplexMatrix* SplitComplexMatrix_Multiply(const SplitComplexMatrix* a, const SplitComplexMatrix* b,
+                                                MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_SPLIT_COMPLEX_MULTIPLY);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_SPLIT_COMPLEX_MULTIPLY),
+                       a && a->re ? a->re->rows : 0, b && b->re ? b->re->cols : 0);
+    SplitComplexMatrix* result = split_complex_multiply_impl(a, b, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 6 * a->re->rows * a->re->cols * b->re->cols : 0);
+    return result;
+}
+
+void SplitComplexMatrix_Destroy(SplitComplexMatrix* s) {
+    if (s) {
+        Matrix_Destroy(s->re);
+        Matrix_Destroy(s->im);
+        free(s);
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef MATRIX_COMPLEX_H
+#define MATRIX_COMPLEX_H
+
+#include <stddef.h>
+#include "matrix.h"
+#include "complex_field.h"
+
+//Ядра для чередующегося хранения (re, im); C перезаписывается.
+//Умножение 4M: четыре вещественных умножения на элемент, без потери точности
+void complex_gemm(const ComplexFloat* a, const ComplexFloat* b, ComplexFloat* c,
+                  size_t m, size_t k, size_t n);
+//Гаусс с выбором главного элемента по модулю; a и b не изменяются
+MatrixError complex_gauss_solve(const ComplexFloat* a, const ComplexFloat* b, ComplexFloat* x, size_t n);
+
+#endif
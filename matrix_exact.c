@@ -0,0 +1,327 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "matrix.h"
+#include "int_field.h"
+#include "modular_field.h"
+#include "matrix_modular.h"
+#include "bigint.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+//Восстановление по КТО: values[i] в [0, modulus), модуль - произведение нечетных
+//простых, half = (modulus - 1) / 2. stable - сколько простых подряд не изменили ни
+//одного значения в симметричном представлении (-M/2, M/2]: в [0, M) отрицательное
+//значение меняется с каждым новым простым
+typedef struct {
+    size_t count;
+    BigInt* values;
+    BigInt modulus;
+    BigInt half;
+    size_t stable;
+} CrtState;
+
+static bool crt_init(CrtState* s, size_t count) {
+    s->count = count;
+    s->stable = 0;
+    BigInt_Init(&s->modulus);
+    BigInt_Init(&s->half);
+    s->values = (BigInt*)malloc(count * sizeof(BigInt));
+    if (!s->values) return false;
+    for (size_t i = 0; i < count; i++) BigInt_Init(&s->values[i]);
+    return bigint_set_u32(&s->modulus, 1);
+}
+
+static void crt_free(CrtState* s) {
+    if (s->values) {
+        for (size_t i = 0; i < s->count; i++) BigInt_Free(&s->values[i]);
+        free(s->values);
+    }
+    BigInt_Free(&s->modulus);
+    BigInt_Free(&s->half);
+}
+
+//Шаг Гарнера: v += M * ((r - v) * M^-1 mod p), M *= p. Симметричное значение
+//s = v - M при v > M/2 не меняется, если r = s mod p
+static bool crt_add(CrtState* s, const FieldInfo* field, const uint32_t* residues) {
+    const ModularFieldInfo* f = modular_info(field);
+    uint32_t p = field->modulus;
+    uint32_t m_mod = bigint_mod_u32(&s->modulus, p);
+    uint32_t m_inv = ModularInverse(m_mod, p);
+
+    bool unchanged = true;
+    for (size_t i = 0; i < s->count; i++) {
+        uint32_t v = bigint_mod_u32(&s->values[i], p);
+        uint32_t symmetric = v;
+        if (bigint_cmp_abs(&s->values[i], &s->half) > 0) symmetric = v >= m_mod ? v - m_mod : v + p - m_mod;
+        if (symmetric != residues[i]) unchanged = false;
+        if (v == residues[i]) continue;
+        uint32_t diff = residues[i] >= v ? residues[i] - v : residues[i] + p - v;
+        if (!bigint_add_mul_u32(&s->values[i], &s->modulus, modular_mul(f, diff, m_inv))) return false;
+    }
+    s->stable = unchanged ? s->stable + 1 : 0;
+    //(M p - 1) / 2 = half p + (p - 1) / 2 для нечетных M и p
+    return bigint_mul_u32(&s->modulus, p) && bigint_mul_u32(&s->half, p) &&
+           bigint_add_u32(&s->half, (p - 1) / 2);
+}
+
+//Перевод из [0, M) в симметричный диапазон (-M/2, M/2]
+static bool crt_finish(CrtState* s) {
+    BigInt rest;
+    BigInt_Init(&rest);
+    for (size_t i = 0; i < s->count; i++) {
+        if (!bigint_copy(&rest, &s->values[i]) || !bigint_rsub_abs(&rest, &s->modulus)) {
+            BigInt_Free(&rest);
+            return false;
+        }
+        if (bigint_cmp_abs(&s->values[i], &rest) > 0) {
+            BigInt tmp = s->values[i];
+            s->values[i] = rest;
+            s->values[i].negative = true;
+            rest = tmp;
+        }
+    }
+    BigInt_Free(&rest);
+    return true;
+}
+
+static double log2_norm(double sum_squares) {
+    return 0.5 * log2(sum_squares > 1.0 ? sum_squares : 1.0);
+}
+
+//Оценки Адамара (log2): det_bits - для |det A|, num_bits - для числителей
+//Крамера det(A_i), где столбец i заменен на b. Нулевые нормы заменяются
+//единицей: у ненулевого целого столбца норма не меньше 1.
+static MatrixError hadamard_bounds(const Matrix* a, const Matrix* b, double* det_bits, double* num_bits) {
+    size_t n = a->rows;
+    const int* data = (const int*)a->data;
+    double* col_sq = (double*)calloc(n, sizeof(double));
+    if (!col_sq) return MATRIX_ERROR_MEMORY;
+
+    double rows_log = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double row_sq = 0.0;
+        for (size_t j = 0; j < n; j++) {
+            double v = data[i * n + j];
+            row_sq += v * v;
+            col_sq[j] += v * v;
+        }
+        rows_log += log2_norm(row_sq);
+    }
+
+    double cols_log = 0.0;
+    double min_col_log = 0.0;
+    for (size_t j = 0; j < n; j++) {
+        double l = log2_norm(col_sq[j]);
+        cols_log += l;
+        if (j == 0 || l < min_col_log) min_col_log = l;
+    }
+
+    *det_bits = cols_log < rows_log ? cols_log : rows_log;
+    *num_bits = *det_bits;
+    if (b) {
+        double b_sq = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            double v = ((const int*)b->data)[i];
+            b_sq += v * v;
+        }
+        double bound = cols_log - min_col_log + log2_norm(b_sq);
+        if (bound > *num_bits) *num_bits = bound;
+    }
+    free(col_sq);
+    return MATRIX_OK;
+}
+
+//Следующее простое меньше start (простые выше 2^30)
+static const FieldInfo* next_prime_field(uint32_t* start) {
+    while (*start > (1u << 30)) {
+        *start -= 2;
+        const FieldInfo* field = CreateModularFieldInfo(*start);
+        if (field) return field;
+    }
+    return NULL;
+}
+
+//Остатки для одного простого: det mod p и, если есть b, det * x mod p.
+//1 - успешно, 0 - A вырождена по модулю p, -1 - нехватка памяти.
+static int residues_for_prime(const Matrix* a, const Matrix* b, const FieldInfo* field, uint32_t* out) {
+    size_t n = a->rows;
+    size_t cols = b ? n + 1 : n;
+    uint32_t p = field->modulus;
+    const ModularFieldInfo* f = modular_info(field);
+
+    uint32_t* work = (uint32_t*)malloc(n * cols * sizeof(uint32_t));
+    uint32_t* x = b ? (uint32_t*)malloc(n * sizeof(uint32_t)) : NULL;
+    if (!work || (b && !x)) {
+        free(work);
+        free(x);
+        return -1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            int v = (j < n) ? ((const int*)a->data)[i * n + j] : ((const int*)b->data)[i];
+            int64_t r = (int64_t)v % p;
+            work[i * cols + j] = (uint32_t)(r < 0 ? r + p : r);
+        }
+    }
+
+    MATRIX_TRACE_BEGIN(span, "exact_prime", n, cols);
+    uint32_t det = 0;
+    size_t rank = modular_eliminate(f, work, n, cols, n, &det);
+    int status = 1;
+    if (rank == (size_t)-1) {
+        status = -1;
+    } else if (b && rank < n) {
+        status = 0;
+    } else if (b) {
+        modular_back_substitute(f, work, n, x);
+        for (size_t i = 0; i < n; i++) out[1 + i] = modular_mul(f, det, x[i]);
+    }
+    out[0] = det;
+    MATRIX_TRACE_END(span);
+
+    free(work);
+    free(x);
+    return status;
+}
+
+//Многомодульное исключение: простые обрабатываются пачками по числу потоков,
+//остановка по оценке Адамара или когда значения не меняются два простых подряд
+static MatrixError exact_via_crt(const Matrix* a, const Matrix* b, CrtState* crt) {
+    size_t n = a->rows;
+    size_t count = b ? n + 1 : 1;
+
+    //Состояние КТО инициализируется первым: вызывающий освобождает его при любой ошибке
+    bool crt_ok = crt_init(crt, count);
+    double det_bits = 0.0, num_bits = 0.0;
+    MatrixError err = crt_ok ? hadamard_bounds(a, b, &det_bits, &num_bits) : MATRIX_ERROR_MEMORY;
+    if (err != MATRIX_OK) return err;
+    //+1 бит на знак; каждое простое дает больше 30 бит
+    size_t needed = (size_t)ceil((num_bits + 1.0) / 30.0) + 1;
+    size_t unlucky_limit = (size_t)ceil(det_bits / 30.0);
+
+    size_t batch = 1;
+#ifdef _OPENMP
+    batch = (size_t)omp_get_max_threads();
+#endif
+
+    const FieldInfo** fields = (const FieldInfo**)calloc(batch, sizeof(FieldInfo*));
+    uint32_t* residues = (uint32_t*)malloc(batch * count * sizeof(uint32_t));
+    int* status = (int*)malloc(batch * sizeof(int));
+    if (!fields || !residues || !status) {
+        free(fields);
+        free(residues);
+        free(status);
+        return MATRIX_ERROR_MEMORY;
+    }
+
+    uint32_t candidate = 2147483647u + 2u;
+    size_t used = 0;
+    size_t unlucky = 0;
+
+    while (err == MATRIX_OK && used < needed && crt->stable < 2) {
+        size_t jobs = 0;
+        while (jobs < batch && jobs < needed - used) {
+            fields[jobs] = next_prime_field(&candidate);
+            if (!fields[jobs]) break;
+            jobs++;
+        }
+        if (jobs == 0) {
+            err = MATRIX_ERROR_MEMORY;
+            break;
+        }
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (long t = 0; t < (long)jobs; t++) {
+            status[t] = residues_for_prime(a, b, fields[t], residues + t * count);
+        }
+
+        for (size_t t = 0; t < jobs; t++) {
+            if (err != MATRIX_OK || used >= needed || crt->stable >= 2) break;
+            if (status[t] < 0) {
+                err = MATRIX_ERROR_MEMORY;
+            } else if (status[t] == 0) {
+                //Простых больше 2^30, делящих ненулевой det, не больше det_bits / 30
+                if (++unlucky > unlucky_limit) err = MATRIX_ERROR_SINGULAR_MATRIX;
+            } else if (!crt_add(crt, fields[t], residues + t * count)) {
+                err = MATRIX_ERROR_MEMORY;
+            } else {
+                used++;
+            }
+        }
+
+        for (size_t t = 0; t < jobs; t++) DestroyModularFieldInfo(fields[t]);
+    }
+
+    if (err == MATRIX_OK && !crt_finish(crt)) err = MATRIX_ERROR_MEMORY;
+
+    free(fields);
+    free(residues);
+    free(status);
+    return err;
+}
+
+static MatrixError matrix_determinant_exact_impl(const Matrix* m, BigInt* det) {
+    if (!m || !det) return MATRIX_ERROR_NULL_POINTER;
+    if (m->type != GetIntFieldInfo()) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (m->rows != m->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    CrtState crt;
+    MatrixError err = exact_via_crt(m, NULL, &crt);
+    if (err == MATRIX_OK) {
+        BigInt_Free(det);
+        *det = crt.values[0];
+        BigInt_Init(&crt.values[0]);
+    }
+    crt_free(&crt);
+    return err;
+}
+
+//x = numerators / denominator по правилу Крамера: denominator = |det A|
+static MatrixError matrix_solve_exact_impl(const Matrix* a, const Matrix* b,
+                                           BigInt* numerators, BigInt* denominator) {
+    if (!a || !b || !numerators || !denominator) return MATRIX_ERROR_NULL_POINTER;
+    if (a->type != GetIntFieldInfo() || b->type != GetIntFieldInfo()) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (a->rows != a->cols || b->rows != a->rows || b->cols != 1) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    CrtState crt;
+    MatrixError err = exact_via_crt(a, b, &crt);
+    if (err == MATRIX_OK && crt.values[0].size == 0) err = MATRIX_ERROR_SINGULAR_MATRIX;
+    if (err == MATRIX_OK) {
+        bool flip = crt.values[0].negative;
+        for (size_t i = 0; i <= a->rows; i++) {
+            BigInt* dest = (i == 0) ? denominator : &numerators[i - 1];
+            BigInt_Free(dest);
+            *dest = crt.values[i];
+            if (flip && dest->size) dest->negative = !dest->negative;
+            BigInt_Init(&crt.values[i]);
+        }
+    }
+    crt_free(&crt);
+    return err;
+}
+
+//Публичные функции. Число простых заранее неизвестно, FLOP не учитываются
+MatrixError Matrix_DeterminantExact(const Matrix* m, BigInt* det) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_DETERMINANT_EXACT);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_DETERMINANT_EXACT), m ? m->rows : 0, m ? m->cols : 0);
+    MatrixError err = matrix_determinant_exact_impl(m, det);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
+
+MatrixError Matrix_SolveExact(const Matrix* a, const Matrix* b, BigInt* numerators, BigInt* denominator) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_SOLVE_EXACT);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_SOLVE_EXACT), a ? a->rows : 0, a ? a->cols : 0);
+    MatrixError err = matrix_solve_exact_impl(a, b, numerators, denominator);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(0);
+    return err;
+}
@@ -0,0 +1,230 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "matrix.h"
+#include "matrix_lu.h"
+#include "matrix_wide.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Копия матрицы в double: double и целые напрямую, остальные через to_float
+static MatrixError load_double(const Matrix* m, double* out) {
+    size_t count = m->rows * m->cols;
+    switch (m->type->id) {
+        case FIELD_ID_DOUBLE:
+            memcpy(out, m->data, count * sizeof(double));
+            return MATRIX_OK;
+        case FIELD_ID_INT:
+            for (size_t i = 0; i < count; i++) out[i] = ((const int*)m->data)[i];
+            return MATRIX_OK;
+        case FIELD_ID_INT64:
+            for (size_t i = 0; i < count; i++) out[i] = (double)((const int64_t*)m->data)[i];
+            return MATRIX_OK;
+        case FIELD_ID_INT8:
+            for (size_t i = 0; i < count; i++) out[i] = ((const int8_t*)m->data)[i];
+            return MATRIX_OK;
+        default:
+            break;
+    }
+    if (!m->type->to_float) return MATRIX_ERROR_TYPE_MISMATCH;
+    float* tmp = (float*)malloc(count * sizeof(float));
+    if (!tmp) return MATRIX_ERROR_MEMORY;
+    m->type->to_float(tmp, m->data, count);
+    for (size_t i = 0; i < count; i++) out[i] = tmp[i];
+    free(tmp);
+    return MATRIX_OK;
+}
+
+static MatrixError store_double(Matrix* m, const double* values) {
+    size_t count = m->rows * m->cols;
+    if (m->type->id == FIELD_ID_DOUBLE) {
+        memcpy(m->data, values, count * sizeof(double));
+        return MATRIX_OK;
+    }
+    float* tmp = (float*)malloc(count * sizeof(float));
+    if (!tmp) return MATRIX_ERROR_MEMORY;
+    for (size_t i = 0; i < count; i++) tmp[i] = (float)values[i];
+    m->type->from_float(m->data, tmp, count);
+    free(tmp);
+    return MATRIX_OK;
+}
+
+//Четность перестановки: n минус число циклов
+static MatrixError permutation_sign(const size_t* perm, size_t n, int* sign) {
+    bool* seen = (bool*)calloc(n, sizeof(bool));
+    if (!seen) return MATRIX_ERROR_MEMORY;
+    size_t cycles = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (seen[i]) continue;
+        cycles++;
+        for (size_t j = i; !seen[j]; j = perm[j]) seen[j] = true;
+    }
+    free(seen);
+    *sign = ((n - cycles) % 2) ? -1 : 1;
+    return MATRIX_OK;
+}
+
+//Строка i матрицы X = U^-1 из x_i U = e_i: прямой ход по столбцам с обновлением
+//строкой U, строки независимы. Работа убывает с i, поэтому распределение динамическое
+static void upper_inverse(const double* lu, double* x, size_t n) {
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (long ii = 0; ii < (long)n; ii++) {
+        size_t i = (size_t)ii;
+        double* xi = x + i * n;
+        memset(xi, 0, n * sizeof(double));
+        xi[i] = 1.0;
+        for (size_t k = i; k < n; k++) {
+            const double* u = lu + k * n;
+            double v = xi[k] / u[k];
+            xi[k] = v;
+            if (v == 0.0) continue;
+            for (size_t j = k + 1; j < n; j++) xi[j] -= v * u[j];
+        }
+    }
+}
+
+//Строка i матрицы Y = L^-1 из y_i L = e_i (единичная диагональ): обратный ход
+static void lower_inverse(const double* lu, double* y, size_t n) {
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (long ii = 0; ii < (long)n; ii++) {
+        size_t i = (size_t)ii;
+        double* yi = y + i * n;
+        memset(yi, 0, n * sizeof(double));
+        yi[i] = 1.0;
+        for (size_t k = i + 1; k-- > 0; ) {
+            const double* l = lu + k * n;
+            double v = yi[k];
+            if (v == 0.0) continue;
+            for (size_t j = 0; j < k; j++) yi[j] -= v * l[j];
+        }
+    }
+}
+
+static MatrixError matrix_determinant_impl(const Matrix* m, int* sign, double* log_abs) {
+    if (!m || !sign || !log_abs) return MATRIX_ERROR_NULL_POINTER;
+    if (m->rows != m->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    size_t n = m->rows;
+    double* lu = (double*)malloc(n * n * sizeof(double));
+    size_t* perm = (size_t*)malloc(n * sizeof(size_t));
+    if (!lu || !perm) {
+        free(lu);
+        free(perm);
+        return MATRIX_ERROR_MEMORY;
+    }
+
+    MatrixError err = load_double(m, lu);
+    if (err == MATRIX_OK) err = double_lu_factor(lu, n, perm);
+    if (err == MATRIX_ERROR_SINGULAR_MATRIX) {
+        *sign = 0;
+        *log_abs = -INFINITY;
+        err = MATRIX_OK;
+    } else if (err == MATRIX_OK) {
+        err = permutation_sign(perm, n, sign);
+        //Сумма логарифмов вместо произведения: без переполнения при любом n
+        double sum = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            double u = lu[k * n + k];
+            if (u < 0.0) *sign = -*sign;
+            sum += log(fabs(u));
+        }
+        *log_abs = sum;
+    }
+
+    free(lu);
+    free(perm);
+    return err;
+}
+
+//PA = LU, значит A^-1 = U^-1 L^-1 P: два треугольных обращения и одно умножение,
+//затем перестановка столбцов
+static Matrix* matrix_inverse_impl(const Matrix* m, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+
+    if (m->type->id != FIELD_ID_DOUBLE && (!m->type->to_float || !m->type->from_float)) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    if (m->rows != m->cols) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+
+    size_t n = m->rows;
+    Matrix* result = Matrix_Create(n, n, m->type);
+    double* lu = (double*)malloc(n * n * sizeof(double));
+    double* u_inv = (double*)malloc(n * n * sizeof(double));
+    double* l_inv = (double*)malloc(n * n * sizeof(double));
+    size_t* perm = (size_t*)malloc(n * sizeof(size_t));
+    if (!result || !lu || !u_inv || !l_inv || !perm) {
+        Matrix_Destroy(result);
+        free(lu);
+        free(u_inv);
+        free(l_inv);
+        free(perm);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    MatrixError err = load_double(m, lu);
+    if (err == MATRIX_OK) {
+        MATRIX_TRACE_BEGIN(factor_span, "inverse_lu", n, n);
+        err = double_lu_factor(lu, n, perm);
+        MATRIX_TRACE_END(factor_span);
+    }
+    if (err == MATRIX_OK) {
+        MATRIX_TRACE_BEGIN(tri_span, "inverse_triangular", n, n);
+        upper_inverse(lu, u_inv, n);
+        lower_inverse(lu, l_inv, n);
+        MATRIX_TRACE_END(tri_span);
+
+        //Произведение пишется в lu, затем столбец k переходит на место perm[k]
+        MATRIX_TRACE_BEGIN(gemm_span, "inverse_gemm", n, n);
+        double_gemm(u_inv, l_inv, lu, n, n, n);
+        MATRIX_TRACE_END(gemm_span);
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < (long)n; i++) {
+            const double* src = lu + (size_t)i * n;
+            double* dst = u_inv + (size_t)i * n;
+            for (size_t k = 0; k < n; k++) dst[perm[k]] = src[k];
+        }
+        err = store_double(result, u_inv);
+    }
+
+    free(lu);
+    free(u_inv);
+    free(l_inv);
+    free(perm);
+    if (err != MATRIX_OK) {
+        Matrix_Destroy(result);
+        if (error) *error = err;
+        return NULL;
+    }
+    return result;
+}
+
+//Публичные функции
+MatrixError Matrix_Determinant(const Matrix* m, int* sign, double* log_abs) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_DETERMINANT);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_DETERMINANT), m ? m->rows : 0, m ? m->cols : 0);
+    MatrixError err = matrix_determinant_impl(m, sign, log_abs);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * m->rows * m->rows * m->rows / 3 : 0);
+    return err;
+}
+
+Matrix* Matrix_Inverse(const Matrix* m, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_INVERSE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_INVERSE), m ? m->rows : 0, m ? m->cols : 0);
+    Matrix* result = matrix_inverse_impl(m, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * result->rows * result->rows * result->rows : 0);
+    return result;
+}
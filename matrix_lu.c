@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "matrix.h"
+#include "matrix_lu.h"
+#include "matrix_trace.h"
+
+//Шаг исключения меньше этого числа умножений-сложений идет в одном потоке без
+//параллельной области: ее запуск на каждый столбец (даже с ложным if) дороже
+//самой работы на малых системах
+#define LU_PARALLEL_MIN_WORK (1 << 15)
+
+//Строка хвоста: множитель L на место row[k], внутренний цикл векторизуется
+static inline void float_eliminate_row(float* row, const float* pivot_row, float inv_pivot, size_t k, size_t n) {
+    float l = row[k] * inv_pivot;
+    row[k] = l;
+    if (l == 0.0f) return;
+    for (size_t j = k + 1; j < n; j++) row[j] -= l * pivot_row[j];
+}
+
+static inline void double_eliminate_row(double* row, const double* pivot_row, double inv_pivot, size_t k,
+                                        size_t end) {
+    double l = row[k] * inv_pivot;
+    row[k] = l;
+    if (l == 0.0) return;
+    for (size_t j = k + 1; j < end; j++) row[j] -= l * pivot_row[j];
+}
+
+MatrixError float_lu_factor(float* a, size_t n, size_t* perm) {
+    for (size_t i = 0; i < n; i++) perm[i] = i;
+
+    for (size_t k = 0; k < n; k++) {
+        MATRIX_TRACE_BEGIN(pivot_span, "lu_pivot_search", n - k, 1);
+        size_t max_row = k;
+        float max_val = fabsf(a[k * n + k]);
+        for (size_t i = k + 1; i < n; i++) {
+            float cur = fabsf(a[i * n + k]);
+            if (cur > max_val) {
+                max_val = cur;
+                max_row = i;
+            }
+        }
+        MATRIX_TRACE_END(pivot_span);
+
+        if (!(max_val >= 1e-10f)) return MATRIX_ERROR_SINGULAR_MATRIX;
+
+        if (max_row != k) {
+            for (size_t j = 0; j < n; j++) {
+                float t = a[k * n + j];
+                a[k * n + j] = a[max_row * n + j];
+                a[max_row * n + j] = t;
+            }
+            size_t t = perm[k];
+            perm[k] = perm[max_row];
+            perm[max_row] = t;
+        }
+
+        const float* pivot_row = a + k * n;
+        float inv_pivot = 1.0f / pivot_row[k];
+
+        //Обновление хвоста: строки независимы
+        MATRIX_TRACE_BEGIN(eliminate_span, "lu_eliminate", n - k - 1, n - k);
+        if ((n - k - 1) * (n - k) >= LU_PARALLEL_MIN_WORK) {
+            #pragma omp parallel for schedule(static)
+            for (long i = (long)k + 1; i < (long)n; i++) {
+                float_eliminate_row(a + (size_t)i * n, pivot_row, inv_pivot, k, n);
+            }
+        } else {
+            for (size_t i = k + 1; i < n; i++) float_eliminate_row(a + i * n, pivot_row, inv_pivot, k, n);
+        }
+        MATRIX_TRACE_END(eliminate_span);
+    }
+    return MATRIX_OK;
+}
+
+//Прямой ход Ly = Pb, затем обратный Ux = y; y хранится в x
+void float_lu_solve(const float* lu, const size_t* perm, size_t n, const float* b, float* x) {
+    for (size_t i = 0; i < n; i++) {
+        const float* row = lu + i * n;
+        float acc = b[perm[i]];
+        for (size_t j = 0; j < i; j++) acc -= row[j] * x[j];
+        x[i] = acc;
+    }
+    for (size_t i = n; i-- > 0; ) {
+        const float* row = lu + i * n;
+        float acc = x[i];
+        for (size_t j = i + 1; j < n; j++) acc -= row[j] * x[j];
+        x[i] = acc / row[i];
+    }
+}
+
+#define LU_BLOCK 64
+
+//Панель - столбцы k0..k1-1 строк k0..n-1; строки переставляются целиком
+static MatrixError double_lu_panel(double* a, size_t n, size_t k0, size_t k1, size_t* perm,
+                                   double threshold) {
+    for (size_t k = k0; k < k1; k++) {
+        size_t max_row = k;
+        double max_val = fabs(a[k * n + k]);
+        for (size_t i = k + 1; i < n; i++) {
+            double cur = fabs(a[i * n + k]);
+            if (cur > max_val) {
+                max_val = cur;
+                max_row = i;
+            }
+        }
+        if (!(max_val > threshold)) return MATRIX_ERROR_SINGULAR_MATRIX;
+
+        if (max_row != k) {
+            for (size_t j = 0; j < n; j++) {
+                double t = a[k * n + j];
+                a[k * n + j] = a[max_row * n + j];
+                a[max_row * n + j] = t;
+            }
+            size_t t = perm[k];
+            perm[k] = perm[max_row];
+            perm[max_row] = t;
+        }
+
+        const double* pivot_row = a + k * n;
+        double inv_pivot = 1.0 / pivot_row[k];
+
+        if ((n - k - 1) * (k1 - k) >= LU_PARALLEL_MIN_WORK) {
+            #pragma omp parallel for schedule(static)
+            for (long i = (long)k + 1; i < (long)n; i++) {
+                double_eliminate_row(a + (size_t)i * n, pivot_row, inv_pivot, k, k1);
+            }
+        } else {
+            for (size_t i = k + 1; i < n; i++) double_eliminate_row(a + i * n, pivot_row, inv_pivot, k, k1);
+        }
+    }
+    return MATRIX_OK;
+}
+
+MatrixError double_lu_factor(double* a, size_t n, size_t* perm) {
+    double max_abs = 0.0;
+    for (size_t i = 0; i < n * n; i++) max_abs = fmax(max_abs, fabs(a[i]));
+    double threshold = (double)n * DBL_EPSILON * max_abs;
+
+    for (size_t i = 0; i < n; i++) perm[i] = i;
+
+    for (size_t k0 = 0; k0 < n; k0 += LU_BLOCK) {
+        size_t k1 = k0 + LU_BLOCK < n ? k0 + LU_BLOCK : n;
+
+        MATRIX_TRACE_BEGIN(panel_span, "lu_panel", n - k0, k1 - k0);
+        MatrixError err = double_lu_panel(a, n, k0, k1, perm, threshold);
+        MATRIX_TRACE_END(panel_span);
+        if (err != MATRIX_OK) return err;
+        if (k1 == n) break;
+
+        //U12 = L11^-1 A12: строки блока правее панели
+        MATRIX_TRACE_BEGIN(trsm_span, "lu_block_row", k1 - k0, n - k1);
+        for (size_t i = k0 + 1; i < k1; i++) {
+            double* row = a + i * n;
+            for (size_t p = k0; p < i; p++) {
+                double l = row[p];
+                if (l == 0.0) continue;
+                const double* u = a + p * n;
+                for (size_t j = k1; j < n; j++) row[j] -= l * u[j];
+            }
+        }
+        MATRIX_TRACE_END(trsm_span);
+
+        //A22 -= L21 U12: строки независимы
+        MATRIX_TRACE_BEGIN(update_span, "lu_trailing_update", n - k1, n - k1);
+        #pragma omp parallel for schedule(static)
+        for (long i = (long)k1; i < (long)n; i++) {
+            double* row = a + (size_t)i * n;
+            for (size_t p = k0; p < k1; p++) {
+                double l = row[p];
+                if (l == 0.0) continue;
+                const double* u = a + p * n;
+                for (size_t j = k1; j < n; j++) row[j] -= l * u[j];
+            }
+        }
+        MATRIX_TRACE_END(update_span);
+    }
+    return MATRIX_OK;
+}
+
+void double_lu_solve(const double* lu, const size_t* perm, size_t n, const double* b, double* x) {
+    for (size_t i = 0; i < n; i++) {
+        const double* row = lu + i * n;
+        double acc = b[perm[i]];
+        for (size_t j = 0; j < i; j++) acc -= row[j] * x[j];
+        x[i] = acc;
+    }
+    for (size_t i = n; i-- > 0; ) {
+        const double* row = lu + i * n;
+        double acc = x[i];
+        for (size_t j = i + 1; j < n; j++) acc -= row[j] * x[j];
+        x[i] = acc / row[i];
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef MATRIX_LU_H
+#define MATRIX_LU_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+//LU-разложение с выбором главного элемента по столбцу: PA = LU на месте a
+//(L с единичной диагональю под диагональю, U - на диагонали и выше),
+//perm[i] - исходный номер i-й строки. Порог вырожденности |pivot| < 1e-10, как у Гаусса
+MatrixError float_lu_factor(float* a, size_t n, size_t* perm);
+//x = A^-1 b по готовым множителям; x и b - разные массивы
+void float_lu_solve(const float* lu, const size_t* perm, size_t n, const float* b, float* x);
+
+//То же в double, блоками по LU_BLOCK столбцов: панель раскладывается по столбцам,
+//хвост обновляется одним параллельным проходом на блок. Порог n * eps * max|A|,
+//как в double_gauss_solve
+MatrixError double_lu_factor(double* a, size_t n, size_t* perm);
+void double_lu_solve(const double* lu, const size_t* perm, size_t n, const double* b, double* x);
+
+#endif
@@ -0,0 +1,175 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "modular_field.h"
+#include "matrix_modular.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Порядок i-k-j: строка C копится в uint64 и редуцируется раз в delay шагов по k
+bool modular_gemm(const ModularFieldInfo* f, const uint32_t* a, const uint32_t* b, uint32_t* c,
+                  size_t m, size_t k, size_t n) {
+    uint64_t* acc = (uint64_t*)malloc(n * sizeof(uint64_t));
+    if (!acc) return false;
+
+    for (size_t i = 0; i < m; i++) {
+        memset(acc, 0, n * sizeof(uint64_t));
+        size_t pending = 0;
+        for (size_t p = 0; p < k; p++) {
+            if (pending == f->delay) {
+                for (size_t j = 0; j < n; j++) acc[j] = modular_reduce(f, acc[j]);
+                pending = 0;
+            }
+            uint64_t a_ip = a[i * k + p];
+            if (a_ip == 0) continue;
+            const uint32_t* b_row = b + p * n;
+            for (size_t j = 0; j < n; j++) {
+                acc[j] += a_ip * b_row[j];
+            }
+            pending++;
+        }
+        for (size_t j = 0; j < n; j++) c[i * n + j] = modular_reduce(f, acc[j]);
+    }
+
+    free(acc);
+    return true;
+}
+
+//Рабочая копия в uint64: строки под опорной обновляются без редукции,
+//пока число накопленных обновлений не достигнет delay. Опорная строка и
+//столбец текущего шага редуцируются перед использованием.
+size_t modular_eliminate(const ModularFieldInfo* f, uint32_t* data, size_t rows, size_t cols,
+                         size_t pivot_cols, uint32_t* det) {
+    uint64_t* w = (uint64_t*)malloc(rows * cols * sizeof(uint64_t));
+    if (!w) return (size_t)-1;
+    for (size_t i = 0; i < rows * cols; i++) w[i] = data[i];
+
+    uint32_t p = f->info.modulus;
+    uint32_t d = 1;
+    size_t rank = 0;
+    size_t pending = 0;
+
+    for (size_t col = 0; col < pivot_cols && rank < rows; col++) {
+        size_t pivot_row = rows;
+        for (size_t i = rank; i < rows; i++) {
+            w[i * cols + col] = modular_reduce(f, w[i * cols + col]);
+            if (pivot_row == rows && w[i * cols + col] != 0) pivot_row = i;
+        }
+        if (pivot_row == rows) {
+            d = 0;
+            continue;
+        }
+
+        uint64_t* pivot = w + rank * cols;
+        if (pivot_row != rank) {
+            uint64_t* other = w + pivot_row * cols;
+            for (size_t j = 0; j < cols; j++) {
+                uint64_t t = pivot[j];
+                pivot[j] = other[j];
+                other[j] = t;
+            }
+            d = d ? p - d : 0;
+        }
+        for (size_t j = col + 1; j < cols; j++) pivot[j] = modular_reduce(f, pivot[j]);
+
+        uint32_t pivot_val = (uint32_t)pivot[col];
+        d = modular_mul(f, d, pivot_val);
+        uint32_t inv = ModularInverse(pivot_val, p);
+
+        if (pending == f->delay) {
+            for (size_t i = rank + 1; i < rows; i++) {
+                for (size_t j = col + 1; j < cols; j++) {
+                    w[i * cols + j] = modular_reduce(f, w[i * cols + j]);
+                }
+            }
+            pending = 0;
+        }
+
+        for (size_t i = rank + 1; i < rows; i++) {
+            uint64_t* row = w + i * cols;
+            if (row[col] == 0) continue;
+            uint64_t factor = p - modular_mul(f, (uint32_t)row[col], inv);
+            row[col] = 0;
+            for (size_t j = col + 1; j < cols; j++) {
+                row[j] += factor * pivot[j];
+            }
+        }
+        pending++;
+        rank++;
+    }
+
+    for (size_t i = 0; i < rows * cols; i++) data[i] = modular_reduce(f, w[i]);
+    free(w);
+
+    if (det) *det = (rank == pivot_cols && rows == pivot_cols) ? d : 0;
+    return rank;
+}
+
+void modular_back_substitute(const ModularFieldInfo* f, const uint32_t* aug, size_t n, uint32_t* x) {
+    uint32_t p = f->info.modulus;
+    for (size_t i = n; i-- > 0; ) {
+        const uint32_t* row = aug + i * (n + 1);
+        uint64_t acc = 0;
+        size_t pending = 0;
+        for (size_t j = i + 1; j < n; j++) {
+            if (pending == f->delay) {
+                acc = modular_reduce(f, acc);
+                pending = 0;
+            }
+            acc += (uint64_t)row[j] * x[j];
+            pending++;
+        }
+        uint32_t sum = modular_reduce(f, acc);
+        uint32_t rhs = row[n] >= sum ? row[n] - sum : row[n] + p - sum;
+        x[i] = modular_mul(f, rhs, ModularInverse(row[i], p));
+    }
+}
+
+static MatrixError modular_eliminate_copy(const Matrix* m, size_t* rank, uint32_t* det) {
+    if (!m) return MATRIX_ERROR_NULL_POINTER;
+    if (!m->type || m->type->modulus == 0) return MATRIX_ERROR_TYPE_MISMATCH;
+
+    uint32_t* work = (uint32_t*)malloc(m->rows * m->cols * sizeof(uint32_t));
+    if (!work) return MATRIX_ERROR_MEMORY;
+    memcpy(work, m->data, m->rows * m->cols * sizeof(uint32_t));
+
+    MATRIX_TRACE_BEGIN(span, "modular_eliminate", m->rows, m->cols);
+    size_t r = modular_eliminate(modular_info(m->type), work, m->rows, m->cols, m->cols, det);
+    MATRIX_TRACE_END(span);
+    free(work);
+
+    if (r == (size_t)-1) return MATRIX_ERROR_MEMORY;
+    if (rank) *rank = r;
+    return MATRIX_OK;
+}
+
+static MatrixError matrix_modular_rank_impl(const Matrix* m, size_t* rank) {
+    if (!rank) return MATRIX_ERROR_NULL_POINTER;
+    return modular_eliminate_copy(m, rank, NULL);
+}
+
+static MatrixError matrix_modular_determinant_impl(const Matrix* m, uint32_t* det) {
+    if (!m || !det) return MATRIX_ERROR_NULL_POINTER;
+    if (m->rows != m->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    return modular_eliminate_copy(m, NULL, det);
+}
+
+//Публичные функции
+MatrixError Matrix_ModularRank(const Matrix* m, size_t* rank) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MODULAR_RANK);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MODULAR_RANK), m ? m->rows : 0, m ? m->cols : 0);
+    MatrixError err = matrix_modular_rank_impl(m, rank);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * m->rows * m->cols * m->cols / 3 : 0);
+    return err;
+}
+
+MatrixError Matrix_ModularDeterminant(const Matrix* m, uint32_t* det) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_MODULAR_DETERMINANT);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_MODULAR_DETERMINANT), m ? m->rows : 0, m ? m->cols : 0);
+    MatrixError err = matrix_modular_determinant_impl(m, det);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * m->rows * m->rows * m->rows / 3 : 0);
+    return err;
+}
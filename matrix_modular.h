@@ -0,0 +1,25 @@
+#ifndef MATRIX_MODULAR_H
+#define MATRIX_MODULAR_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "modular_field.h"
+
+//Ядра над GF(p). Произведения копятся в uint64 и редуцируются раз в f->delay
+//слагаемых вместо редукции после каждого умножения.
+
+//C = A * B; false при нехватке памяти
+bool modular_gemm(const ModularFieldInfo* f, const uint32_t* a, const uint32_t* b, uint32_t* c,
+                  size_t m, size_t k, size_t n);
+
+//Приведение к ступенчатому виду на месте по первым pivot_cols столбцам.
+//Возвращает ранг или (size_t)-1 при нехватке памяти; det (может быть NULL) -
+//определитель квадратной части rows x pivot_cols.
+size_t modular_eliminate(const ModularFieldInfo* f, uint32_t* data, size_t rows, size_t cols,
+                         size_t pivot_cols, uint32_t* det);
+
+//Обратный ход для верхнетреугольной [U|b] размера n x (n+1) с ненулевой диагональю
+void modular_back_substitute(const ModularFieldInfo* f, const uint32_t* aug, size_t n, uint32_t* x);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef MATRIX_MULTIPLY_H
+#define MATRIX_MULTIPLY_H
+
+#include <stdbool.h>
+#include "matrix.h"
+
+//C = A * B в готовый буфер C (не совпадает с A и B) для A и B одного типа:
+//специализированное ядро или общий цикл через операции типа. false при нехватке памяти
+bool matrix_multiply_into(const Matrix* a, const Matrix* b, Matrix* c);
+
+#endif
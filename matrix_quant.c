@@ -0,0 +1,292 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "matrix.h"
+#include "field.h"
+#include "float_field.h"
+#include "int8_field.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define QUANT_HAVE_AVX2_DISPATCH 1
+#endif
+
+typedef int32_t (*DotInt8Func)(const int8_t* a, const int8_t* b, size_t n);
+
+//Скалярное произведение int8 с накоплением в int32
+static int32_t dot_int8_scalar(const int8_t* a, const int8_t* b, size_t n) {
+    int32_t acc = 0;
+    for (size_t k = 0; k < n; k++) {
+        acc += (int32_t)a[k] * (int32_t)b[k];
+    }
+    return acc;
+}
+
+#ifdef QUANT_HAVE_AVX2_DISPATCH
+
+//Знаковое расширение до int16 и pmaddwd: точный результат без насыщения,
+//которое есть у pmaddubsw/VNNI для пары знаковых операндов
+__attribute__((target("avx2")))
+static int32_t dot_int8_avx2(const int8_t* a, const int8_t* b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(a + k)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(b + k)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    int32_t result = _mm_cvtsi128_si32(sum);
+
+    for (; k < n; k++) {
+        result += (int32_t)a[k] * (int32_t)b[k];
+    }
+    return result;
+}
+
+#endif
+
+static DotInt8Func select_dot_int8(void) {
+#ifdef QUANT_HAVE_AVX2_DISPATCH
+    if (__builtin_cpu_supports("avx2")) return dot_int8_avx2;
+#endif
+    return dot_int8_scalar;
+}
+
+static int8_t quantize_value(float value, float inv_scale, int zero_point) {
+    long q = lroundf(value * inv_scale) + zero_point;
+    if (q < -128) q = -128;
+    if (q > 127) q = 127;
+    return (int8_t)q;
+}
+
+//Асимметричное квантование: диапазон [min, max] (с нулем) отображается на [-128, 127]
+static void choose_params(float min_val, float max_val, float* scale, int* zero_point) {
+    if (min_val > 0.0f) min_val = 0.0f;
+    if (max_val < 0.0f) max_val = 0.0f;
+
+    float s = (max_val - min_val) / 255.0f;
+    if (s == 0.0f) s = 1.0f;
+
+    long zp = -128 - lroundf(min_val / s);
+    if (zp < -128) zp = -128;
+    if (zp > 127) zp = 127;
+
+    *scale = s;
+    *zero_point = (int)zp;
+}
+
+static QuantizedMatrix* matrix_quantize_impl(const Matrix* m, MatrixQuantAxis axis, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+
+    if (!m->type->to_float) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    size_t groups = (axis == MATRIX_QUANT_PER_ROW) ? m->rows : m->cols;
+    QuantizedMatrix* q = (QuantizedMatrix*)calloc(1, sizeof(QuantizedMatrix));
+    float* values = (float*)malloc(m->rows * m->cols * sizeof(float));
+    if (q) {
+        q->axis = axis;
+        q->values = Matrix_Create(m->rows, m->cols, GetInt8FieldInfo());
+        q->scales = (float*)malloc(groups * sizeof(float));
+        q->zero_points = (int*)malloc(groups * sizeof(int));
+    }
+
+    if (!q || !values || !q->values || !q->scales || !q->zero_points) {
+        QuantizedMatrix_Destroy(q);
+        free(values);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    m->type->to_float(values, m->data, m->rows * m->cols);
+    int8_t* out = (int8_t*)q->values->data;
+
+    for (size_t g = 0; g < groups; g++) {
+        size_t count = (axis == MATRIX_QUANT_PER_ROW) ? m->cols : m->rows;
+        size_t stride = (axis == MATRIX_QUANT_PER_ROW) ? 1 : m->cols;
+        size_t base = (axis == MATRIX_QUANT_PER_ROW) ? g * m->cols : g;
+
+        float min_val = values[base];
+        float max_val = values[base];
+        for (size_t t = 1; t < count; t++) {
+            float v = values[base + t * stride];
+            if (v < min_val) min_val = v;
+            if (v > max_val) max_val = v;
+        }
+
+        choose_params(min_val, max_val, &q->scales[g], &q->zero_points[g]);
+        float inv_scale = 1.0f / q->scales[g];
+        for (size_t t = 0; t < count; t++) {
+            size_t idx = base + t * stride;
+            out[idx] = quantize_value(values[idx], inv_scale, q->zero_points[g]);
+        }
+    }
+
+    free(values);
+    return q;
+}
+
+static Matrix* matrix_dequantize_impl(const QuantizedMatrix* q, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!q || !q->values) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+
+    Matrix* result = Matrix_Create(q->values->rows, q->values->cols, GetFloatFieldInfo());
+    if (!result) {
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    const int8_t* in = (const int8_t*)q->values->data;
+    float* out = (float*)result->data;
+    for (size_t i = 0; i < result->rows; i++) {
+        for (size_t j = 0; j < result->cols; j++) {
+            size_t g = (q->axis == MATRIX_QUANT_PER_ROW) ? i : j;
+            size_t idx = i * result->cols + j;
+            out[idx] = q->scales[g] * (float)((int)in[idx] - q->zero_points[g]);
+        }
+    }
+
+    return result;
+}
+
+//C[i][j] = sa[i] * sb[j] * sum_k (qa[i][k] - za[i]) * (qb[k][j] - zb[j])
+//Раскрываем скобки: сумма qa*qb считается в int32, поправки на нулевые
+//точки берутся из заранее посчитанных сумм строк A и столбцов B
+static Matrix* matrix_quantized_multiply_impl(const QuantizedMatrix* a, const QuantizedMatrix* b,
+                                              MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!a || !b || !a->values || !b->values) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+
+    //Масштаб должен выноситься за сумму по k
+    if (a->axis != MATRIX_QUANT_PER_ROW || b->axis != MATRIX_QUANT_PER_COL) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    size_t m = a->values->rows;
+    size_t k = a->values->cols;
+    size_t n = b->values->cols;
+    if (k != b->values->rows) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+
+    Matrix* result = Matrix_Create(m, n, GetFloatFieldInfo());
+    int8_t* b_packed = (int8_t*)malloc(k * n);
+    int32_t* a_sums = (int32_t*)malloc(m * sizeof(int32_t));
+    int32_t* b_sums = (int32_t*)malloc(n * sizeof(int32_t));
+    if (!result || !b_packed || !a_sums || !b_sums) {
+        Matrix_Destroy(result);
+        free(b_packed);
+        free(a_sums);
+        free(b_sums);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    const int8_t* qa = (const int8_t*)a->values->data;
+    const int8_t* qb = (const int8_t*)b->values->data;
+
+    //Упаковка B по столбцам, чтобы скалярные произведения шли подряд
+    MATRIX_TRACE_BEGIN(pack_span, "quantized_pack", k, n);
+    for (size_t j = 0; j < n; j++) {
+        int32_t sum = 0;
+        for (size_t p = 0; p < k; p++) {
+            int8_t v = qb[p * n + j];
+            b_packed[j * k + p] = v;
+            sum += v;
+        }
+        b_sums[j] = sum;
+    }
+    for (size_t i = 0; i < m; i++) {
+        int32_t sum = 0;
+        for (size_t p = 0; p < k; p++) sum += qa[i * k + p];
+        a_sums[i] = sum;
+    }
+    MATRIX_TRACE_END(pack_span);
+
+    DotInt8Func dot = select_dot_int8();
+    float* out = (float*)result->data;
+
+    MATRIX_TRACE_BEGIN(kernel_span, "quantized_kernel", m, n);
+    for (size_t i = 0; i < m; i++) {
+        const int8_t* a_row = qa + i * k;
+        int32_t za = a->zero_points[i];
+        float sa = a->scales[i];
+        for (size_t j = 0; j < n; j++) {
+            int32_t zb = b->zero_points[j];
+            int64_t acc = dot(a_row, b_packed + j * k, k);
+            acc -= (int64_t)zb * a_sums[i];
+            acc -= (int64_t)za * b_sums[j];
+            acc += (int64_t)k * za * zb;
+            out[i * n + j] = sa * b->scales[j] * (float)acc;
+        }
+    }
+    MATRIX_TRACE_END(kernel_span);
+
+    free(b_packed);
+    free(a_sums);
+    free(b_sums);
+    return result;
+}
+
+void QuantizedMatrix_Destroy(QuantizedMatrix* q) {
+    if (q) {
+        Matrix_Destroy(q->values);
+        free(q->scales);
+        free(q->zero_points);
+        free(q);
+    }
+}
+
+//Публичные функции
+QuantizedMatrix* Matrix_Quantize(const Matrix* m, MatrixQuantAxis axis, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_QUANTIZE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_QUANTIZE), m ? m->rows : 0, m ? m->cols : 0);
+    QuantizedMatrix* q = matrix_quantize_impl(m, axis, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(q ? 2 * m->rows * m->cols : 0);
+    return q;
+}
+
+Matrix* Matrix_Dequantize(const QuantizedMatrix* q, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_DEQUANTIZE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_DEQUANTIZE),
+                       q && q->values ? q->values->rows : 0, q && q->values ? q->values->cols : 0);
+    Matrix* result = matrix_dequantize_impl(q, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * result->rows * result->cols : 0);
+    return result;
+}
+
+Matrix* Matrix_QuantizedMultiply(const QuantizedMatrix* a, const QuantizedMatrix* b, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_QUANTIZED_MULTIPLY);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_QUANTIZED_MULTIPLY),
+                       a && a->values ? a->values->rows : 0, b && b->values ? b->values->cols : 0);
+    Matrix* result = matrix_quantized_multiply_impl(a, b, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * result->rows * result->cols * a->values->cols : 0);
+    return result;
+}
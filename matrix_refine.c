@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "matrix.h"
+#include "float_field.h"
+#include "double_field.h"
+#include "matrix_lu.h"
+#include "matrix_buffer.h"
+#include "matrix_wide.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+#define REFINE_MAX_ITERATIONS 30
+
+static double norm_inf(const double* v, size_t n) {
+    double m = 0.0;
+    for (size_t i = 0; i < n; i++) m = fmax(m, fabs(v[i]));
+    return m;
+}
+
+//Максимальная сумма модулей по строкам
+static double matrix_norm_inf(const double* a, size_t n) {
+    double m = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double s = 0.0;
+        for (size_t j = 0; j < n; j++) s += fabs(a[i * n + j]);
+        m = fmax(m, s);
+    }
+    return m;
+}
+
+//r = b - A x в double
+static void residual(const double* a, const double* b, const double* x, double* r, size_t n) {
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long)n; i++) {
+        const double* row = a + (size_t)i * n;
+        double acc = b[i];
+        for (size_t j = 0; j < n; j++) acc -= row[j] * x[j];
+        r[i] = acc;
+    }
+}
+
+//Хранение в типе множителей: значения проходят через его формат и обратно во float
+static bool round_through(const FieldInfo* type, float* values, size_t count) {
+    if (type == GetFloatFieldInfo()) return true;
+    void* tmp = malloc(count * type->size);
+    if (!tmp) return false;
+    type->from_float(tmp, values, count);
+    type->to_float(values, tmp, count);
+    free(tmp);
+    return true;
+}
+
+static double backward_error(const double* a, const double* b, const double* x, double* r,
+                             size_t n, double a_norm, double b_norm) {
+    residual(a, b, x, r, n);
+    double denom = a_norm * norm_inf(x, n) + b_norm;
+    return denom > 0.0 ? norm_inf(r, n) / denom : 0.0;
+}
+
+//Итерационное уточнение: x0 из дешевых множителей, затем x += A^-1 (b - A x)
+//с невязкой в double. Останов по обратной ошибке sqrt(n) * eps (как в LAPACK dsgesv);
+//если поправка перестала уменьшаться хотя бы вдвое - уточнение расходится
+static MatrixError matrix_solve_refined_impl(const Matrix* a, const Matrix* b, Matrix* x,
+                                             const FieldInfo* factor_type, MatrixRefineReport* report) {
+    if (report) memset(report, 0, sizeof(*report));
+    if (!a || !b || !x) return MATRIX_ERROR_NULL_POINTER;
+    if (!factor_type) factor_type = GetFloatFieldInfo();
+    if (a->type != GetDoubleFieldInfo() || b->type != a->type || x->type != a->type) {
+        return MATRIX_ERROR_TYPE_MISMATCH;
+    }
+    if (!factor_type->to_float || !factor_type->from_float) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (a->rows != a->cols || b->rows != a->rows || b->cols != 1 || x->rows != a->rows || x->cols != 1) {
+        return MATRIX_ERROR_DIMENSION_MISMATCH;
+    }
+    MatrixError writable = matrix_make_writable(x);
+    if (writable != MATRIX_OK) return writable;
+
+    size_t n = a->rows;
+    const double* ad = (const double*)a->data;
+    const double* bd = (const double*)b->data;
+    double* xd = (double*)x->data;
+
+    float* lu = (float*)malloc(n * n * sizeof(float));
+    size_t* perm = (size_t*)malloc(n * sizeof(size_t));
+    float* fr = (float*)malloc(n * sizeof(float));
+    float* fd = (float*)malloc(n * sizeof(float));
+    double* r = (double*)malloc(n * sizeof(double));
+    if (!lu || !perm || !fr || !fd || !r) {
+        free(lu);
+        free(perm);
+        free(fr);
+        free(fd);
+        free(r);
+        return MATRIX_ERROR_MEMORY;
+    }
+
+    MATRIX_TRACE_BEGIN(factor_span, "refine_factor", n, n);
+    for (size_t i = 0; i < n * n; i++) lu[i] = (float)ad[i];
+    bool factored = round_through(factor_type, lu, n * n) &&
+                    float_lu_factor(lu, n, perm) == MATRIX_OK &&
+                    round_through(factor_type, lu, n * n);
+    MATRIX_TRACE_END(factor_span);
+
+    double a_norm = matrix_norm_inf(ad, n);
+    double b_norm = norm_inf(bd, n);
+    double tolerance = sqrt((double)n) * DBL_EPSILON;
+    double berr = INFINITY;
+    size_t iterations = 0;
+    bool converged = false;
+
+    if (factored) {
+        for (size_t i = 0; i < n; i++) fr[i] = (float)bd[i];
+        float_lu_solve(lu, perm, n, fr, fd);
+        for (size_t i = 0; i < n; i++) xd[i] = fd[i];
+
+        double prev_step = INFINITY;
+        MATRIX_TRACE_BEGIN(refine_span, "refine_iterations", n, 1);
+        while (true) {
+            berr = backward_error(ad, bd, xd, r, n, a_norm, b_norm);
+            if (berr <= tolerance) {
+                converged = true;
+                break;
+            }
+            if (iterations == REFINE_MAX_ITERATIONS) break;
+
+            for (size_t i = 0; i < n; i++) fr[i] = (float)r[i];
+            float_lu_solve(lu, perm, n, fr, fd);
+            double step = 0.0;
+            for (size_t i = 0; i < n; i++) step = fmax(step, fabs((double)fd[i]));
+            if (!(step < 0.5 * prev_step)) break;
+
+            for (size_t i = 0; i < n; i++) xd[i] += fd[i];
+            prev_step = step;
+            iterations++;
+        }
+        MATRIX_TRACE_END(refine_span);
+    }
+
+    MatrixError err = MATRIX_OK;
+    if (!converged) {
+        MATRIX_TRACE_BEGIN(fallback_span, "refine_fallback", n, n);
+        err = double_gauss_solve(ad, bd, xd, n);
+        MATRIX_TRACE_END(fallback_span);
+        if (err == MATRIX_OK) berr = backward_error(ad, bd, xd, r, n, a_norm, b_norm);
+    }
+    if (report) {
+        report->iterations = iterations;
+        report->backward_error = berr;
+        report->fell_back = !converged;
+    }
+
+    free(lu);
+    free(perm);
+    free(fr);
+    free(fd);
+    free(r);
+    return err;
+}
+
+//Публичные функции
+MatrixError Matrix_SolveRefined(const Matrix* a, const Matrix* b, Matrix* x,
+                                const FieldInfo* factor_type, MatrixRefineReport* report) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_SOLVE_REFINED);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_SOLVE_REFINED), a ? a->rows : 0, a ? a->cols : 0);
+    MatrixError err = matrix_solve_refined_impl(a, b, x, factor_type, report);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * a->rows * a->rows * a->rows / 3 + 2 * a->rows * a->rows : 0);
+    return err;
+}
@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "matrix.h"
+#include "matrix_multiply.h"
+#include "matrix_buffer.h"
+#include "matrix_wide.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Все операции читают исходные строки, поэтому набор сводится к одному умножению:
+//D = C_T * M для t изменяемых строк T, затем M[T] += D. Строки C и D непрерывны,
+//умножение идет через специализированное ядро типа
+
+static bool row_is_zero(const Matrix* c, size_t row) {
+    const char* p = (const char*)c->data + row * c->cols * c->type->size;
+    for (size_t j = 0; j < c->cols; j++) {
+        if (!Field_EqualsZero(c->type, p + j * c->type->size)) return false;
+    }
+    return true;
+}
+
+//Строки D различны, поэтому обновляются параллельно
+static void add_rows(Matrix* m, const size_t* targets, const Matrix* delta) {
+    const FieldInfo* type = m->type;
+    size_t row_bytes = m->cols * type->size;
+
+    #pragma omp parallel for schedule(static)
+    for (long r = 0; r < (long)delta->rows; r++) {
+        char* dst = (char*)m->data + targets[r] * row_bytes;
+        const char* src = (const char*)delta->data + (size_t)r * row_bytes;
+        switch (type->id) {
+            case FIELD_ID_FLOAT:
+                for (size_t j = 0; j < m->cols; j++) ((float*)dst)[j] += ((const float*)src)[j];
+                break;
+            case FIELD_ID_DOUBLE:
+                double_add((const double*)dst, (const double*)src, (double*)dst, m->cols);
+                break;
+            case FIELD_ID_INT64:
+                int64_add((const int64_t*)dst, (const int64_t*)src, (int64_t*)dst, m->cols);
+                break;
+            default:
+                for (size_t j = 0; j < m->cols; j++) {
+                    type->add(type, dst + j * type->size, dst + j * type->size, src + j * type->size);
+                }
+                break;
+        }
+    }
+}
+
+//coeffs - t x rows, targets[r] - строка M, которую меняет строка r коэффициентов
+static MatrixError apply_rows(Matrix* m, const Matrix* coeffs, const size_t* targets) {
+    if (coeffs->rows == 0) return MATRIX_OK;
+
+    Matrix* delta = Matrix_Create(coeffs->rows, m->cols, m->type);
+    if (!delta) return MATRIX_ERROR_MEMORY;
+
+    MATRIX_TRACE_BEGIN(kernel_span, "row_ops_multiply", coeffs->rows, m->cols);
+    bool ok = matrix_multiply_into(coeffs, m, delta);
+    MATRIX_TRACE_END(kernel_span);
+
+    if (ok) {
+        MATRIX_TRACE_BEGIN(add_span, "row_ops_update", coeffs->rows, m->cols);
+        add_rows(m, targets, delta);
+        MATRIX_TRACE_END(add_span);
+    }
+
+    Matrix_Destroy(delta);
+    return ok ? MATRIX_OK : MATRIX_ERROR_MEMORY;
+}
+
+static MatrixError matrix_apply_row_ops_impl(Matrix* m, const Matrix* coeffs, size_t* changed) {
+    *changed = 0;
+    if (!m || !coeffs) return MATRIX_ERROR_NULL_POINTER;
+    if (!FieldInfo_Equals(m->type, coeffs->type)) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (coeffs->rows != m->rows || coeffs->cols != m->rows) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    MatrixError writable = matrix_make_writable(m);
+    if (writable != MATRIX_OK) return writable;
+
+    size_t n = m->rows;
+    size_t* targets = (size_t*)malloc(n * sizeof(size_t));
+    if (!targets) return MATRIX_ERROR_MEMORY;
+    size_t t = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!row_is_zero(coeffs, i)) targets[t++] = i;
+    }
+
+    MatrixError err = MATRIX_OK;
+    if (t == n) {
+        err = apply_rows(m, coeffs, targets);
+    } else if (t > 0) {
+        //Только ненулевые строки C
+        Matrix* selected = Matrix_Create(t, n, m->type);
+        if (!selected) {
+            err = MATRIX_ERROR_MEMORY;
+        } else {
+            size_t row_bytes = n * m->type->size;
+            for (size_t r = 0; r < t; r++) {
+                memcpy((char*)selected->data + r * row_bytes,
+                       (const char*)coeffs->data + targets[r] * row_bytes, row_bytes);
+            }
+            err = apply_rows(m, selected, targets);
+            Matrix_Destroy(selected);
+        }
+    }
+
+    if (err == MATRIX_OK) *changed = t;
+    free(targets);
+    return err;
+}
+
+//Операции с одной целевой строкой складываются в одну строку коэффициентов
+static MatrixError matrix_apply_row_op_list_impl(Matrix* m, const MatrixRowOp* ops, size_t count,
+                                                 size_t* changed) {
+    *changed = 0;
+    if (!m || (!ops && count > 0)) return MATRIX_ERROR_NULL_POINTER;
+    for (size_t k = 0; k < count; k++) {
+        if (!ops[k].alphas) return MATRIX_ERROR_NULL_POINTER;
+        if (ops[k].target >= m->rows) return MATRIX_ERROR_INVALID_INDEX;
+    }
+    if (count == 0) return MATRIX_OK;
+    MatrixError writable = matrix_make_writable(m);
+    if (writable != MATRIX_OK) return writable;
+
+    size_t n = m->rows;
+    const FieldInfo* type = m->type;
+    size_t* slot = (size_t*)malloc(n * sizeof(size_t));
+    size_t* targets = (size_t*)malloc(n * sizeof(size_t));
+    if (!slot || !targets) {
+        free(slot);
+        free(targets);
+        return MATRIX_ERROR_MEMORY;
+    }
+    size_t t = 0;
+    for (size_t i = 0; i < n; i++) slot[i] = SIZE_MAX;
+    for (size_t k = 0; k < count; k++) {
+        if (slot[ops[k].target] == SIZE_MAX) {
+            slot[ops[k].target] = t;
+            targets[t++] = ops[k].target;
+        }
+    }
+
+    Matrix* coeffs = Matrix_Create(t, n, type);
+    if (!coeffs) {
+        free(slot);
+        free(targets);
+        return MATRIX_ERROR_MEMORY;
+    }
+
+    //Matrix_Create заполняет нулем типа; коэффициент при самой целевой строке пропускается
+    size_t size = type->size;
+    for (size_t k = 0; k < count; k++) {
+        char* row = (char*)coeffs->data + slot[ops[k].target] * n * size;
+        const char* alphas = (const char*)ops[k].alphas;
+        for (size_t j = 0; j < n; j++) {
+            if (j == ops[k].target) continue;
+            type->add(type, row + j * size, row + j * size, alphas + j * size);
+        }
+    }
+
+    MatrixError err = apply_rows(m, coeffs, targets);
+    if (err == MATRIX_OK) *changed = t;
+
+    Matrix_Destroy(coeffs);
+    free(slot);
+    free(targets);
+    return err;
+}
+
+//Публичные функции
+MatrixError Matrix_ApplyRowOps(Matrix* m, const Matrix* coeffs) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_APPLY_ROW_OPS);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_APPLY_ROW_OPS), m ? m->rows : 0, m ? m->cols : 0);
+    size_t changed = 0;
+    MatrixError err = matrix_apply_row_ops_impl(m, coeffs, &changed);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * changed * m->rows * m->cols : 0);
+    return err;
+}
+
+MatrixError Matrix_ApplyRowOpList(Matrix* m, const MatrixRowOp* ops, size_t count) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_APPLY_ROW_OPS);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_APPLY_ROW_OPS), m ? m->rows : 0, m ? m->cols : 0);
+    size_t changed = 0;
+    MatrixError err = matrix_apply_row_op_list_impl(m, ops, count, &changed);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * changed * m->rows * m->cols : 0);
+    return err;
+}
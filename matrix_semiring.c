@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "matrix.h"
+#include "semiring_field.h"
+#include "matrix_semiring.h"
+#include "matrix_buffer.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Блоки по k и j, чтобы полоса B оставалась в кэше, пока по ней проходят все строки A
+#define SEMIRING_BLOCK_K 256
+#define SEMIRING_BLOCK_N 1024
+//Сторона блока Флойда-Уоршелла: три блока float по 64x64 занимают 48 КБ
+#define CLOSURE_BLOCK 64
+
+//Внутренний цикл без ветвлений (min через сравнение) векторизуется в minps
+void minplus_gemm(const float* a, const float* b, float* c, size_t m, size_t k, size_t n) {
+    for (size_t i = 0; i < m * n; i++) c[i] = INFINITY;
+
+    for (size_t jj = 0; jj < n; jj += SEMIRING_BLOCK_N) {
+        size_t j_end = jj + SEMIRING_BLOCK_N < n ? jj + SEMIRING_BLOCK_N : n;
+        for (size_t kk = 0; kk < k; kk += SEMIRING_BLOCK_K) {
+            size_t k_end = kk + SEMIRING_BLOCK_K < k ? kk + SEMIRING_BLOCK_K : k;
+
+            #pragma omp parallel for schedule(static)
+            for (long i = 0; i < (long)m; i++) {
+                float* c_row = c + (size_t)i * n;
+                for (size_t p = kk; p < k_end; p++) {
+                    float a_ip = a[(size_t)i * k + p];
+                    if (a_ip == INFINITY) continue;
+                    const float* b_row = b + p * n;
+                    for (size_t j = jj; j < j_end; j++) {
+                        float s = a_ip + b_row[j];
+                        c_row[j] = s < c_row[j] ? s : c_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+//Нулевые элементы A пропускаются, остальные дают OR строки B
+void bool_gemm(const uint8_t* a, const uint8_t* b, uint8_t* c, size_t m, size_t k, size_t n) {
+    memset(c, 0, m * n);
+
+    for (size_t jj = 0; jj < n; jj += SEMIRING_BLOCK_N) {
+        size_t j_end = jj + SEMIRING_BLOCK_N < n ? jj + SEMIRING_BLOCK_N : n;
+        for (size_t kk = 0; kk < k; kk += SEMIRING_BLOCK_K) {
+            size_t k_end = kk + SEMIRING_BLOCK_K < k ? kk + SEMIRING_BLOCK_K : k;
+
+            #pragma omp parallel for schedule(static)
+            for (long i = 0; i < (long)m; i++) {
+                uint8_t* c_row = c + (size_t)i * n;
+                for (size_t p = kk; p < k_end; p++) {
+                    if (!a[(size_t)i * k + p]) continue;
+                    const uint8_t* b_row = b + p * n;
+                    for (size_t j = jj; j < j_end; j++) c_row[j] |= b_row[j];
+                }
+            }
+        }
+    }
+}
+
+//Шаг Флойда-Уоршелла по блоку: D[I][J] = D[I][J] (+) D[I][K] (x) D[K][J]
+//для k внутри блока K. Цикл по k внешний, поэтому блок можно обновлять на месте
+//даже когда он совпадает с D[I][K] или D[K][J].
+typedef void (*ClosureBlockFunc)(void* d, size_t n, size_t ib, size_t jb, size_t kb);
+
+static size_t block_end(size_t start, size_t n) {
+    return start + CLOSURE_BLOCK < n ? start + CLOSURE_BLOCK : n;
+}
+
+static void minplus_closure_block(void* data, size_t n, size_t ib, size_t jb, size_t kb) {
+    float* d = (float*)data;
+    size_t i_end = block_end(ib, n), j_end = block_end(jb, n), k_end = block_end(kb, n);
+    for (size_t k = kb; k < k_end; k++) {
+        const float* d_k = d + k * n;
+        for (size_t i = ib; i < i_end; i++) {
+            float d_ik = d[i * n + k];
+            if (d_ik == INFINITY) continue;
+            float* d_i = d + i * n;
+            for (size_t j = jb; j < j_end; j++) {
+                float s = d_ik + d_k[j];
+                d_i[j] = s < d_i[j] ? s : d_i[j];
+            }
+        }
+    }
+}
+
+static void bool_closure_block(void* data, size_t n, size_t ib, size_t jb, size_t kb) {
+    uint8_t* d = (uint8_t*)data;
+    size_t i_end = block_end(ib, n), j_end = block_end(jb, n), k_end = block_end(kb, n);
+    for (size_t k = kb; k < k_end; k++) {
+        const uint8_t* d_k = d + k * n;
+        for (size_t i = ib; i < i_end; i++) {
+            if (!d[i * n + k]) continue;
+            uint8_t* d_i = d + i * n;
+            for (size_t j = jb; j < j_end; j++) d_i[j] |= d_k[j];
+        }
+    }
+}
+
+//Блочный Флойд-Уоршелл: диагональный блок, затем его строка и столбец,
+//затем все остальные блоки независимо друг от друга
+static void blocked_closure(void* d, size_t n, ClosureBlockFunc block) {
+    size_t blocks = (n + CLOSURE_BLOCK - 1) / CLOSURE_BLOCK;
+    for (size_t kb = 0; kb < blocks; kb++) {
+        size_t k0 = kb * CLOSURE_BLOCK;
+        block(d, n, k0, k0, k0);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (long t = 0; t < (long)blocks; t++) {
+            if ((size_t)t == kb) continue;
+            block(d, n, k0, (size_t)t * CLOSURE_BLOCK, k0);
+            block(d, n, (size_t)t * CLOSURE_BLOCK, k0, k0);
+        }
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (long t = 0; t < (long)(blocks * blocks); t++) {
+            size_t ib = (size_t)t / blocks, jb = (size_t)t % blocks;
+            if (ib == kb || jb == kb) continue;
+            block(d, n, ib * CLOSURE_BLOCK, jb * CLOSURE_BLOCK, k0);
+        }
+    }
+}
+
+//A* = I (+) A (+) A^2 (+) ...: кратчайшие пути для min-plus (без отрицательных
+//циклов), рефлексивно-транзитивное замыкание для bool
+static Matrix* matrix_closure_impl(const Matrix* m, MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!m) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+
+    ClosureBlockFunc block = NULL;
+    if (m->type == GetMinPlusFieldInfo()) block = minplus_closure_block;
+    if (m->type == GetBoolFieldInfo()) block = bool_closure_block;
+    if (!block) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    if (m->rows != m->cols) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+
+    Matrix* result = Matrix_Clone(m, error);
+    if (!result) return NULL;
+    if (matrix_make_writable(result) != MATRIX_OK) {
+        Matrix_Destroy(result);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    size_t n = m->rows;
+    for (size_t i = 0; i < n; i++) {
+        void* diag = (char*)result->data + (i * n + i) * m->type->size;
+        m->type->add(m->type, diag, diag, m->type->one);
+    }
+
+    MATRIX_TRACE_BEGIN(span, "closure_floyd_warshall", n, n);
+    blocked_closure(result->data, n, block);
+    MATRIX_TRACE_END(span);
+
+    return result;
+}
+
+//Публичные функции
+Matrix* Matrix_Closure(const Matrix* m, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_CLOSURE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_CLOSURE), m ? m->rows : 0, m ? m->cols : 0);
+    Matrix* result = matrix_closure_impl(m, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(result ? 2 * result->rows * result->rows * result->rows : 0);
+    return result;
+}
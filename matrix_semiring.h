@@ -0,0 +1,11 @@
+#ifndef MATRIX_SEMIRING_H
+#define MATRIX_SEMIRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Блочные ядра умножения для полуколец из semiring_field.c; C перезаписывается
+void minplus_gemm(const float* a, const float* b, float* c, size_t m, size_t k, size_t n);
+void bool_gemm(const uint8_t* a, const uint8_t* b, uint8_t* c, size_t m, size_t k, size_t n);
+
+#endif
@@ -0,0 +1,317 @@
+#include <stdlib.h>
+#include <string.h>
+#include "matrix.h"
+#include "matrix_stats.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+uint64_t matrix_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+const char* Matrix_OpName(MatrixOp op) {
+    switch (op) {
+        case MATRIX_OP_CREATE: return "Matrix_Create";
+        case MATRIX_OP_DESTROY: return "Matrix_Destroy";
+        case MATRIX_OP_GET: return "Matrix_Get";
+        case MATRIX_OP_SET: return "Matrix_Set";
+        case MATRIX_OP_ADD: return "Matrix_Add";
+        case MATRIX_OP_MULTIPLY: return "Matrix_Multiply";
+        case MATRIX_OP_MULTIPLY_CHECKED: return "Matrix_MultiplyChecked";
+        case MATRIX_OP_SCALAR_MULTIPLY: return "Matrix_ScalarMultiply";
+        case MATRIX_OP_ADD_LINEAR_COMBINATION: return "Matrix_AddLinearCombination";
+        case MATRIX_OP_CLONE: return "Matrix_Clone";
+        case MATRIX_OP_FILL: return "Matrix_Fill";
+        case MATRIX_OP_IDENTITY: return "Matrix_Identity";
+        case MATRIX_OP_PRINT: return "Matrix_Print";
+        case MATRIX_OP_READ: return "Matrix_Read";
+        case MATRIX_OP_GAUSS_SOLVE: return "Matrix_GaussSolve";
+        case MATRIX_OP_QUANTIZE: return "Matrix_Quantize";
+        case MATRIX_OP_DEQUANTIZE: return "Matrix_Dequantize";
+        case MATRIX_OP_QUANTIZED_MULTIPLY: return "Matrix_QuantizedMultiply";
+        case MATRIX_OP_MODULAR_RANK: return "Matrix_ModularRank";
+        case MATRIX_OP_MODULAR_DETERMINANT: return "Matrix_ModularDeterminant";
+        case MATRIX_OP_DETERMINANT_EXACT: return "Matrix_DeterminantExact";
+        case MATRIX_OP_SOLVE_EXACT: return "Matrix_SolveExact";
+        case MATRIX_OP_BAREISS_DETERMINANT: return "Matrix_BareissDeterminant";
+        case MATRIX_OP_BAREISS_SOLVE: return "Matrix_BareissSolve";
+        case MATRIX_OP_GF2_MULTIPLY: return "GF2Matrix_Multiply";
+        case MATRIX_OP_GF2_RANK: return "GF2Matrix_Rank";
+        case MATRIX_OP_GF2_SOLVE: return "GF2Matrix_Solve";
+        case MATRIX_OP_CLOSURE: return "Matrix_Closure";
+        case MATRIX_OP_SPLIT_COMPLEX_MULTIPLY: return "SplitComplexMatrix_Multiply";
+        case MATRIX_OP_TO_SPLIT_COMPLEX: return "Matrix_ToSplitComplex";
+        case MATRIX_OP_FROM_SPLIT_COMPLEX: return "SplitComplexMatrix_ToMatrix";
+        case MATRIX_OP_SOLVE_REFINED: return "Matrix_SolveRefined";
+        case MATRIX_OP_MULTIPLY_BATCH: return "Matrix_MultiplyBatch";
+        case MATRIX_OP_SOLVE_BATCH: return "Matrix_SolveBatch";
+        case MATRIX_OP_DETERMINANT: return "Matrix_Determinant";
+        case MATRIX_OP_INVERSE: return "Matrix_Inverse";
+        case MATRIX_OP_POWER: return "Matrix_Power";
+        case MATRIX_OP_MULTIPLY_CHAIN: return "Matrix_MultiplyChain";
+        case MATRIX_OP_PLAN_CHAIN: return "Matrix_PlanChain";
+        case MATRIX_OP_APPLY_ROW_OPS: return "Matrix_ApplyRowOps";
+        case MATRIX_OP_VIEW_ROWS: return "Matrix_ViewRows";
+        case MATRIX_OP_MAP_FILE: return "Matrix_MapFile";
+        case MATRIX_OP_MAKE_WRITABLE: return "Matrix_MakeWritable";
+        case MATRIX_OP_FACTORIZE: return "Matrix_Factorize";
+        case MATRIX_OP_FACTORIZATION_UPDATE: return "MatrixFactorization_Update";
+        case MATRIX_OP_FACTORIZATION_SOLVE: return "MatrixFactorization_Solve";
+        case MATRIX_OP_INVERSE_UPDATE: return "Matrix_InverseUpdate";
+        case MATRIX_OP_PRODUCT_REFRESH: return "Matrix_ProductRefresh";
+        default: return "unknown";
+    }
+}
+
+#ifdef MATRIX_ENABLE_STATS
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+
+//Счетчики одного потока. Пишет только поток-владелец (без lock-префикса),
+//остальные потоки только читают их в Matrix_GetStats.
+typedef struct {
+    _Atomic uint64_t calls;
+    _Atomic uint64_t total_ns;
+    _Atomic uint64_t max_ns;
+    _Atomic uint64_t flops;
+    _Atomic uint64_t bytes_allocated;
+} StatsCounters;
+
+//Блоки не удаляются из списка (Matrix_GetStats обходит его без блокировок):
+//при выходе потока блок освобождается и достается следующему новому потоку,
+//так что их число ограничено наибольшим числом одновременных потоков
+typedef struct StatsBlock {
+    _Atomic uint64_t generation;
+    atomic_bool owned;
+    StatsCounters ops[MATRIX_OP_COUNT];
+    struct StatsBlock* next;
+} StatsBlock;
+
+static _Atomic(StatsBlock*) g_blocks = NULL;
+static _Atomic uint64_t g_generation = 1;
+static _Atomic uint64_t g_live_bytes = 0;
+static _Atomic uint64_t g_peak_live_bytes = 0;
+
+static MATRIX_THREAD_LOCAL StatsBlock* t_block = NULL;
+static MATRIX_THREAD_LOCAL int t_depth = 0;
+static MATRIX_THREAD_LOCAL MatrixOp t_current_op = MATRIX_OP_CREATE;
+
+static void counter_add(_Atomic uint64_t* counter, uint64_t value) {
+    uint64_t old = atomic_load_explicit(counter, memory_order_relaxed);
+    atomic_store_explicit(counter, old + value, memory_order_relaxed);
+}
+
+static void counter_max(_Atomic uint64_t* counter, uint64_t value) {
+    if (value > atomic_load_explicit(counter, memory_order_relaxed)) {
+        atomic_store_explicit(counter, value, memory_order_relaxed);
+    }
+}
+
+//Счетчики вышедшего потока остаются в блоке и продолжают учитываться
+static void release_block(void* block) {
+    t_block = NULL;
+    atomic_store_explicit(&((StatsBlock*)block)->owned, false, memory_order_release);
+}
+
+#ifdef _WIN32
+
+static INIT_ONCE g_exit_once = INIT_ONCE_STATIC_INIT;
+static DWORD g_exit_slot = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI release_block_on_exit(PVOID block) {
+    if (block) release_block(block);
+}
+
+static BOOL CALLBACK create_exit_slot(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once;
+    (void)param;
+    (void)context;
+    g_exit_slot = FlsAlloc(release_block_on_exit);
+    return TRUE;
+}
+
+static void watch_thread_exit(StatsBlock* block) {
+    InitOnceExecuteOnce(&g_exit_once, create_exit_slot, NULL, NULL);
+    if (g_exit_slot != FLS_OUT_OF_INDEXES) FlsSetValue(g_exit_slot, block);
+}
+
+#else
+
+static pthread_once_t g_exit_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_exit_key;
+static bool g_exit_key_ok = false;
+
+static void create_exit_key(void) {
+    g_exit_key_ok = pthread_key_create(&g_exit_key, release_block) == 0;
+}
+
+static void watch_thread_exit(StatsBlock* block) {
+    pthread_once(&g_exit_once, create_exit_key);
+    if (g_exit_key_ok) pthread_setspecific(g_exit_key, block);
+}
+
+#endif
+
+//Свободный блок вышедшего потока или новый
+static StatsBlock* acquire_block(uint64_t generation) {
+    for (StatsBlock* block = atomic_load_explicit(&g_blocks, memory_order_acquire);
+         block; block = block->next) {
+        bool owned = false;
+        if (atomic_compare_exchange_strong_explicit(&block->owned, &owned, true,
+                                                    memory_order_acq_rel,
+                                                    memory_order_relaxed)) {
+            return block;
+        }
+    }
+
+    StatsBlock* block = (StatsBlock*)calloc(1, sizeof(StatsBlock));
+    if (!block) return NULL;
+    atomic_store_explicit(&block->generation, generation, memory_order_relaxed);
+    atomic_store_explicit(&block->owned, true, memory_order_relaxed);
+
+    StatsBlock* head = atomic_load_explicit(&g_blocks, memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_blocks, &head, block,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+    return block;
+}
+
+//Блок текущего потока; берется при первом вызове и сбрасывается
+//самим владельцем, если с тех пор был Matrix_ResetStats
+static StatsBlock* thread_block(void) {
+    uint64_t generation = atomic_load_explicit(&g_generation, memory_order_acquire);
+
+    if (!t_block) {
+        t_block = acquire_block(generation);
+        if (!t_block) return NULL;
+        watch_thread_exit(t_block);
+    }
+    if (atomic_load_explicit(&t_block->generation, memory_order_relaxed) != generation) {
+        for (int op = 0; op < MATRIX_OP_COUNT; op++) {
+            StatsCounters* c = &t_block->ops[op];
+            atomic_store_explicit(&c->calls, 0, memory_order_relaxed);
+            atomic_store_explicit(&c->total_ns, 0, memory_order_relaxed);
+            atomic_store_explicit(&c->max_ns, 0, memory_order_relaxed);
+            atomic_store_explicit(&c->flops, 0, memory_order_relaxed);
+            atomic_store_explicit(&c->bytes_allocated, 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&t_block->generation, generation, memory_order_release);
+    }
+
+    return t_block;
+}
+
+//Учитываются только внешние вызовы: публичная функция, вызванная внутри
+//другой (например, Matrix_Create внутри Matrix_Multiply), не считается
+//отдельно, ее время и память относятся к внешней
+MatrixStatsScope matrix_stats_begin(MatrixOp op) {
+    MatrixStatsScope scope;
+    scope.op = op;
+    scope.outer = (t_depth++ == 0);
+    scope.start_ns = 0;
+    if (scope.outer) {
+        t_current_op = op;
+        scope.start_ns = matrix_now_ns();
+    }
+    return scope;
+}
+
+void matrix_stats_end(const MatrixStatsScope* scope, uint64_t flops) {
+    t_depth--;
+    if (!scope->outer) return;
+
+    uint64_t elapsed = matrix_now_ns() - scope->start_ns;
+    StatsBlock* block = thread_block();
+    if (!block) return;
+
+    StatsCounters* c = &block->ops[scope->op];
+    counter_add(&c->calls, 1);
+    counter_add(&c->total_ns, elapsed);
+    counter_max(&c->max_ns, elapsed);
+    counter_add(&c->flops, flops);
+}
+
+void matrix_stats_alloc(size_t bytes) {
+    uint64_t live = atomic_fetch_add_explicit(&g_live_bytes, bytes, memory_order_relaxed) + bytes;
+    uint64_t peak = atomic_load_explicit(&g_peak_live_bytes, memory_order_relaxed);
+    while (live > peak &&
+           !atomic_compare_exchange_weak_explicit(&g_peak_live_bytes, &peak, live,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+
+    if (t_depth > 0) {
+        StatsBlock* block = thread_block();
+        if (block) counter_add(&block->ops[t_current_op].bytes_allocated, bytes);
+    }
+}
+
+void matrix_stats_free(size_t bytes) {
+    atomic_fetch_sub_explicit(&g_live_bytes, bytes, memory_order_relaxed);
+}
+
+MatrixError Matrix_GetStats(MatrixStats* out) {
+    if (!out) return MATRIX_ERROR_NULL_POINTER;
+    memset(out, 0, sizeof(*out));
+    out->enabled = 1;
+
+    uint64_t generation = atomic_load_explicit(&g_generation, memory_order_acquire);
+    for (StatsBlock* block = atomic_load_explicit(&g_blocks, memory_order_acquire);
+         block; block = block->next) {
+        if (atomic_load_explicit(&block->generation, memory_order_acquire) != generation) continue;
+
+        for (int op = 0; op < MATRIX_OP_COUNT; op++) {
+            StatsCounters* c = &block->ops[op];
+            MatrixOpStats* s = &out->ops[op];
+            s->calls += atomic_load_explicit(&c->calls, memory_order_relaxed);
+            s->total_ns += atomic_load_explicit(&c->total_ns, memory_order_relaxed);
+            s->flops += atomic_load_explicit(&c->flops, memory_order_relaxed);
+            s->bytes_allocated += atomic_load_explicit(&c->bytes_allocated, memory_order_relaxed);
+            uint64_t max_ns = atomic_load_explicit(&c->max_ns, memory_order_relaxed);
+            if (max_ns > s->max_ns) s->max_ns = max_ns;
+        }
+    }
+
+    out->live_bytes = atomic_load_explicit(&g_live_bytes, memory_order_relaxed);
+    out->peak_live_bytes = atomic_load_explicit(&g_peak_live_bytes, memory_order_relaxed);
+    return MATRIX_OK;
+}
+
+void Matrix_ResetStats(void) {
+    atomic_fetch_add_explicit(&g_generation, 1, memory_order_acq_rel);
+    atomic_store_explicit(&g_peak_live_bytes,
+                          atomic_load_explicit(&g_live_bytes, memory_order_relaxed),
+                          memory_order_relaxed);
+}
+
+#else
+
+MatrixError Matrix_GetStats(MatrixStats* out) {
+    if (!out) return MATRIX_ERROR_NULL_POINTER;
+    memset(out, 0, sizeof(*out));
+    return MATRIX_OK;
+}
+
+void Matrix_ResetStats(void) {
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MATRIX_STATS_H
+#define MATRIX_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+
+#if defined(_MSC_VER)
+    #define MATRIX_THREAD_LOCAL __declspec(thread)
+#else
+    #define MATRIX_THREAD_LOCAL _Thread_local
+#endif
+
+//Монотонное время в наносекундах
+uint64_t matrix_now_ns(void);
+
+#ifdef MATRIX_ENABLE_STATS
+
+typedef struct {
+    MatrixOp op;
+    uint64_t start_ns;
+    int outer;
+} MatrixStatsScope;
+
+MatrixStatsScope matrix_stats_begin(MatrixOp op);
+void matrix_stats_end(const MatrixStatsScope* scope, uint64_t flops);
+void matrix_stats_alloc(size_t bytes);
+void matrix_stats_free(size_t bytes);
+
+#define MATRIX_STATS_BEGIN(op) MatrixStatsScope stats_scope_ = matrix_stats_begin(op)
+#define MATRIX_STATS_END(flops) matrix_stats_end(&stats_scope_, (uint64_t)(flops))
+#define MATRIX_STATS_ALLOC(bytes) matrix_stats_alloc(bytes)
+#define MATRIX_STATS_FREE(bytes) matrix_stats_free(bytes)
+
+#else
+
+#define MATRIX_STATS_BEGIN(op) ((void)0)
+#define MATRIX_STATS_END(flops) ((void)0)
+#define MATRIX_STATS_ALLOC(bytes) ((void)0)
+#define MATRIX_STATS_FREE(bytes) ((void)0)
+
+#endif
+
+#endif
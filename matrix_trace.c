@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <string.h>
+#include "matrix.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+#ifdef MATRIX_ENABLE_TRACE
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+#define TRACE_RING_SIZE 65536
+
+typedef struct {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    size_t rows;
+    size_t cols;
+} TraceEvent;
+
+//Кольцо одного потока: пишет только владелец, head публикуется
+//с release, читатель отбрасывает записи, которые могли быть затерты. Слот
+//head % TRACE_RING_SIZE может писаться прямо сейчас, поэтому читаются не
+//больше TRACE_RING_SIZE - 1 последних событий.
+//Кольца не удаляются из списка: при выходе потока кольцо освобождается и
+//достается следующему новому потоку вместе с номером дорожки thread_id, так
+//что их число ограничено наибольшим числом одновременных потоков. События
+//прежнего владельца остаются в кольце и по времени идут раньше новых
+typedef struct TraceRing {
+    _Atomic uint64_t head;
+    _Atomic uint64_t tail;
+    atomic_bool owned;
+    unsigned thread_id;
+    struct TraceRing* next;
+    TraceEvent events[TRACE_RING_SIZE];
+} TraceRing;
+
+static _Atomic(TraceRing*) g_rings = NULL;
+static _Atomic unsigned g_next_thread_id = 1;
+
+static MATRIX_THREAD_LOCAL TraceRing* t_ring = NULL;
+
+static void release_ring(void* ring) {
+    t_ring = NULL;
+    atomic_store_explicit(&((TraceRing*)ring)->owned, false, memory_order_release);
+}
+
+#ifdef _WIN32
+
+static INIT_ONCE g_exit_once = INIT_ONCE_STATIC_INIT;
+static DWORD g_exit_slot = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI release_ring_on_exit(PVOID ring) {
+    if (ring) release_ring(ring);
+}
+
+static BOOL CALLBACK create_exit_slot(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once;
+    (void)param;
+    (void)context;
+    g_exit_slot = FlsAlloc(release_ring_on_exit);
+    return TRUE;
+}
+
+static void watch_thread_exit(TraceRing* ring) {
+    InitOnceExecuteOnce(&g_exit_once, create_exit_slot, NULL, NULL);
+    if (g_exit_slot != FLS_OUT_OF_INDEXES) FlsSetValue(g_exit_slot, ring);
+}
+
+#else
+
+static pthread_once_t g_exit_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_exit_key;
+static bool g_exit_key_ok = false;
+
+static void create_exit_key(void) {
+    g_exit_key_ok = pthread_key_create(&g_exit_key, release_ring) == 0;
+}
+
+static void watch_thread_exit(TraceRing* ring) {
+    pthread_once(&g_exit_once, create_exit_key);
+    if (g_exit_key_ok) pthread_setspecific(g_exit_key, ring);
+}
+
+#endif
+
+//Свободное кольцо вышедшего потока или новое
+static TraceRing* acquire_ring(void) {
+    for (TraceRing* ring = atomic_load_explicit(&g_rings, memory_order_acquire);
+         ring; ring = ring->next) {
+        bool owned = false;
+        if (atomic_compare_exchange_strong_explicit(&ring->owned, &owned, true,
+                                                    memory_order_acq_rel,
+                                                    memory_order_relaxed)) {
+            return ring;
+        }
+    }
+
+    TraceRing* ring = (TraceRing*)calloc(1, sizeof(TraceRing));
+    if (!ring) return NULL;
+    ring->thread_id = atomic_fetch_add_explicit(&g_next_thread_id, 1, memory_order_relaxed);
+    atomic_store_explicit(&ring->owned, true, memory_order_relaxed);
+
+    TraceRing* head = atomic_load_explicit(&g_rings, memory_order_relaxed);
+    do {
+        ring->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_rings, &head, ring,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+    return ring;
+}
+
+static TraceRing* thread_ring(void) {
+    if (t_ring) return t_ring;
+
+    t_ring = acquire_ring();
+    if (t_ring) watch_thread_exit(t_ring);
+    return t_ring;
+}
+
+MatrixTraceSpan matrix_trace_begin(const char* name, size_t rows, size_t cols) {
+    MatrixTraceSpan span;
+    span.name = name;
+    span.rows = rows;
+    span.cols = cols;
+    span.start_ns = matrix_now_ns();
+    return span;
+}
+
+void matrix_trace_end(const MatrixTraceSpan* span) {
+    uint64_t end_ns = matrix_now_ns();
+    TraceRing* ring = thread_ring();
+    if (!ring) return;
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    TraceEvent* e = &ring->events[head % TRACE_RING_SIZE];
+    e->name = span->name;
+    e->start_ns = span->start_ns;
+    e->duration_ns = end_ns - span->start_ns;
+    e->rows = span->rows;
+    e->cols = span->cols;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+MatrixError Matrix_TraceDump(FILE* output) {
+    if (!output) return MATRIX_ERROR_NULL_POINTER;
+
+    //Временные метки считаются от самого раннего события
+    uint64_t epoch = UINT64_MAX;
+    for (TraceRing* ring = atomic_load_explicit(&g_rings, memory_order_acquire);
+         ring; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        if (head - tail >= TRACE_RING_SIZE) tail = head - TRACE_RING_SIZE + 1;
+        if (head > tail && ring->events[tail % TRACE_RING_SIZE].start_ns < epoch) {
+            epoch = ring->events[tail % TRACE_RING_SIZE].start_ns;
+        }
+    }
+    if (epoch == UINT64_MAX) epoch = 0;
+
+    fprintf(output, "{\"traceEvents\":[\n");
+    int first = 1;
+    for (TraceRing* ring = atomic_load_explicit(&g_rings, memory_order_acquire);
+         ring; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        if (head - tail >= TRACE_RING_SIZE) tail = head - TRACE_RING_SIZE + 1;
+
+        fprintf(output, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":\"matrix thread %u\"}}",
+                first ? "" : ",\n", ring->thread_id, ring->thread_id);
+        first = 0;
+
+        for (uint64_t i = tail; i < head; i++) {
+            TraceEvent e = ring->events[i % TRACE_RING_SIZE];
+
+            //Запись могла быть перезаписана владельцем во время чтения: слот i
+            //свободен, пока new_head - i < TRACE_RING_SIZE
+            atomic_thread_fence(memory_order_acquire);
+            uint64_t new_head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+            if (new_head - i >= TRACE_RING_SIZE) continue;
+
+            uint64_t start = e.start_ns >= epoch ? e.start_ns - epoch : 0;
+            fprintf(output, ",\n{\"name\":\"%s\",\"cat\":\"matrix\",\"ph\":\"X\","
+                    "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"rows\":%zu,\"cols\":%zu}}",
+                    e.name, (double)start / 1000.0, (double)e.duration_ns / 1000.0,
+                    ring->thread_id, e.rows, e.cols);
+        }
+    }
+    fprintf(output, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return MATRIX_OK;
+}
+
+void Matrix_TraceClear(void) {
+    for (TraceRing* ring = atomic_load_explicit(&g_rings, memory_order_acquire);
+         ring; ring = ring->next) {
+        atomic_store_explicit(&ring->tail,
+                              atomic_load_explicit(&ring->head, memory_order_acquire),
+                              memory_order_relaxed);
+    }
+}
+
+#else
+
+MatrixError Matrix_TraceDump(FILE* output) {
+    if (!output) return MATRIX_ERROR_NULL_POINTER;
+    fprintf(output, "{\"traceEvents\":[]}\n");
+    return MATRIX_OK;
+}
+
+void Matrix_TraceClear(void) {
+}
+
+#endif
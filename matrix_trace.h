@@ -0,0 +1,34 @@
+#ifndef MATRIX_TRACE_H
+#define MATRIX_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Трассировка в формате Chrome trace-event (сборка с -DMATRIX_ENABLE_TRACE).
+//Каждый поток пишет завершенные интервалы в свой кольцевой буфер без
+//блокировок; Matrix_TraceDump выгружает их в JSON для Perfetto.
+
+#ifdef MATRIX_ENABLE_TRACE
+
+typedef struct {
+    const char* name;
+    uint64_t start_ns;
+    size_t rows;
+    size_t cols;
+} MatrixTraceSpan;
+
+MatrixTraceSpan matrix_trace_begin(const char* name, size_t rows, size_t cols);
+void matrix_trace_end(const MatrixTraceSpan* span);
+
+#define MATRIX_TRACE_BEGIN(span, name, rows, cols) \
+    MatrixTraceSpan span = matrix_trace_begin((name), (rows), (cols))
+#define MATRIX_TRACE_END(span) matrix_trace_end(&span)
+
+#else
+
+#define MATRIX_TRACE_BEGIN(span, name, rows, cols) ((void)0)
+#define MATRIX_TRACE_END(span) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,726 @@
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "matrix.h"
+#include "float_field.h"
+#include "double_field.h"
+#include "matrix_lu.h"
+#include "matrix_wide.h"
+#include "matrix_multiply.h"
+#include "matrix_buffer.h"
+#include "matrix_stats.h"
+#include "matrix_trace.h"
+
+//Ранг поправки по умолчанию: решение стоит O(n^2 + n K), и после K обновлений
+//ранга 1 дешевле разложить A заново
+#define UPDATE_DEFAULT_RANK 32
+//Допуск обратной ошибки по умолчанию: UPDATE_DRIFT_FACTOR * sqrt(n) * eps
+#define UPDATE_DRIFT_FACTOR 64.0
+
+//A = A0 + U V^T: LU хранится для A0, поправка учитывается формулой
+//Шермана-Моррисона-Вудбери x = y - Z (I + V^T Z)^-1 V^T y, где y = A0^-1 b, Z = A0^-1 U
+struct MatrixFactorization {
+    size_t n;
+    size_t max_rank;
+    double tolerance;
+    double* a;              //текущая A, n x n
+    double* a_next;         //A после поправки, пока она не принята
+    double a_norm;
+    double* lu;             //LU(A0)
+    size_t* perm;
+    bool factored;          //false, если A0 вырождена
+    size_t rank;
+    double* z;              //столбцы A0^-1 u_j подряд, по n элементов
+    double* v;              //столбцы v_j
+    double* cap;            //LU(I + V^T Z), rank x rank
+    size_t* cap_perm;
+    double* cap_next;       //то же после поправки, пока она не принята
+    size_t* cap_perm_next;
+    MatrixUpdateReport report;
+};
+
+static double default_tolerance(size_t n) {
+    return UPDATE_DRIFT_FACTOR * sqrt((double)n) * DBL_EPSILON;
+}
+
+static double norm_inf(const double* v, size_t n) {
+    double m = 0.0;
+    for (size_t i = 0; i < n; i++) m = fmax(m, fabs(v[i]));
+    return m;
+}
+
+//Максимальная сумма модулей по строкам
+static double matrix_norm_inf(const double* a, size_t n) {
+    double m = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double s = 0.0;
+        for (size_t j = 0; j < n; j++) s += fabs(a[i * n + j]);
+        m = fmax(m, s);
+    }
+    return m;
+}
+
+//||b - A x|| / (||A|| ||x|| + ||b||), норма max; r - рабочий массив из n элементов
+static double backward_error(const double* a, double a_norm, const double* b, const double* x,
+                             double* r, size_t n) {
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long)n; i++) {
+        const double* row = a + (size_t)i * n;
+        double acc = b[i];
+        for (size_t j = 0; j < n; j++) acc -= row[j] * x[j];
+        r[i] = acc;
+    }
+    double denom = a_norm * norm_inf(x, n) + norm_inf(b, n);
+    return denom > 0.0 ? norm_inf(r, n) / denom : 0.0;
+}
+
+//A += U V^T; столбцы u_t и v_t лежат подряд по n элементов
+static void add_outer(double* a, const double* u, const double* v, size_t n, size_t k) {
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long)n; i++) {
+        double* row = a + (size_t)i * n;
+        for (size_t t = 0; t < k; t++) {
+            double s = u[t * n + (size_t)i];
+            if (s == 0.0) continue;
+            const double* vt = v + t * n;
+            for (size_t j = 0; j < n; j++) row[j] += s * vt[j];
+        }
+    }
+}
+
+//Столбцы матрицы n x k подряд: для A0^-1 u_j и скалярных произведений
+static double* columns_of(const Matrix* m) {
+    size_t n = m->rows, k = m->cols;
+    double* out = (double*)malloc(n * k * sizeof(double));
+    if (!out) return NULL;
+    const double* src = (const double*)m->data;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t t = 0; t < k; t++) out[t * n + i] = src[i * k + t];
+    }
+    return out;
+}
+
+static MatrixError factor_dense(const double* a, double* lu, size_t* perm, size_t n) {
+    memcpy(lu, a, n * n * sizeof(double));
+    MATRIX_TRACE_BEGIN(span, "update_refactor", n, n);
+    MatrixError err = double_lu_factor(lu, n, perm);
+    MATRIX_TRACE_END(span);
+    return err;
+}
+
+static MatrixError refactor(MatrixFactorization* f) {
+    MatrixError err = factor_dense(f->a, f->lu, f->perm, f->n);
+    f->factored = err == MATRIX_OK;
+    f->rank = 0;
+    f->report.rank = 0;
+    f->report.refactorizations++;
+    return err;
+}
+
+//LU(I + V^T Z) для первых r столбцов Z и V: r^2 скалярных произведений длины n
+static MatrixError factor_capacitance(const MatrixFactorization* f, size_t r, double* cap, size_t* cap_perm) {
+    size_t n = f->n;
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long)r; i++) {
+        const double* vi = f->v + (size_t)i * n;
+        for (size_t j = 0; j < r; j++) {
+            const double* zj = f->z + j * n;
+            double acc = (size_t)i == j ? 1.0 : 0.0;
+            for (size_t p = 0; p < n; p++) acc += vi[p] * zj[p];
+            cap[(size_t)i * r + j] = acc;
+        }
+    }
+    return double_lu_factor(cap, r, cap_perm);
+}
+
+static void swap_doubles(double** a, double** b) {
+    double* t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void swap_indices(size_t** a, size_t** b) {
+    size_t* t = *a;
+    *a = *b;
+    *b = t;
+}
+
+//Поправка ранга k: новая A считается в a_next, к Z добавляются k решений с
+//LU(A0) (столбцы за rank свободны), I + V^T Z раскладывается в cap_next. Сверх
+//max_rank или при вырожденной I + V^T Z - полное разложение новой A в отдельный
+//буфер. f меняется только при успехе: после ошибки остаются прежние A и LU
+static MatrixError apply_updates(MatrixFactorization* f, const double* u, const double* v, size_t k,
+                                 unsigned long long* flops) {
+    size_t n = f->n;
+    memcpy(f->a_next, f->a, n * n * sizeof(double));
+    add_outer(f->a_next, u, v, n, k);
+
+    MatrixError err = MATRIX_ERROR_SINGULAR_MATRIX;
+    if (f->factored && f->rank + k <= f->max_rank) {
+        size_t r = f->rank + k;
+        MATRIX_TRACE_BEGIN(span, "update_woodbury", n, k);
+        for (size_t t = 0; t < k; t++) {
+            double_lu_solve(f->lu, f->perm, n, u + t * n, f->z + (f->rank + t) * n);
+            memcpy(f->v + (f->rank + t) * n, v + t * n, n * sizeof(double));
+        }
+        err = factor_capacitance(f, r, f->cap_next, f->cap_perm_next);
+        MATRIX_TRACE_END(span);
+        if (err == MATRIX_OK) {
+            swap_doubles(&f->cap, &f->cap_next);
+            swap_indices(&f->cap_perm, &f->cap_perm_next);
+            f->rank = r;
+            f->report.rank = r;
+            *flops = 4ULL * n * n * k + 2ULL * n * r * r;
+        }
+    }
+
+    if (err != MATRIX_OK) {
+        *flops = 2ULL * n * n * n / 3;
+        double* lu = (double*)malloc(n * n * sizeof(double));
+        size_t* perm = (size_t*)malloc(n * sizeof(size_t));
+        err = lu && perm ? factor_dense(f->a_next, lu, perm, n) : MATRIX_ERROR_MEMORY;
+        if (err == MATRIX_OK) {
+            swap_doubles(&f->lu, &lu);
+            swap_indices(&f->perm, &perm);
+            f->factored = true;
+            f->rank = 0;
+            f->report.rank = 0;
+            f->report.refactorizations++;
+        }
+        free(lu);
+        free(perm);
+        if (err != MATRIX_OK) return err;
+    }
+
+    swap_doubles(&f->a, &f->a_next);
+    f->a_norm = matrix_norm_inf(f->a, n);
+    f->report.updates += k;
+    return MATRIX_OK;
+}
+
+//y = A0^-1 b с поправкой Вудбери; w и t - рабочие массивы из rank элементов
+static void woodbury_solve(const MatrixFactorization* f, const double* b, double* y, double* w, double* t) {
+    size_t n = f->n, r = f->rank;
+    double_lu_solve(f->lu, f->perm, n, b, y);
+    if (r == 0) return;
+
+    for (size_t i = 0; i < r; i++) {
+        const double* vi = f->v + i * n;
+        double acc = 0.0;
+        for (size_t p = 0; p < n; p++) acc += vi[p] * y[p];
+        w[i] = acc;
+    }
+    double_lu_solve(f->cap, f->cap_perm, r, w, t);
+    for (size_t j = 0; j < r; j++) {
+        const double* zj = f->z + j * n;
+        double s = t[j];
+        for (size_t p = 0; p < n; p++) y[p] -= s * zj[p];
+    }
+}
+
+static void factorization_free(MatrixFactorization* f) {
+    if (!f) return;
+    free(f->a);
+    free(f->a_next);
+    free(f->lu);
+    free(f->perm);
+    free(f->z);
+    free(f->v);
+    free(f->cap);
+    free(f->cap_perm);
+    free(f->cap_next);
+    free(f->cap_perm_next);
+    free(f);
+}
+
+static MatrixFactorization* matrix_factorize_impl(const Matrix* a, size_t max_rank, double tolerance,
+                                                  MatrixError* error) {
+    if (error) *error = MATRIX_OK;
+
+    if (!a) {
+        if (error) *error = MATRIX_ERROR_NULL_POINTER;
+        return NULL;
+    }
+
+    if (a->type != GetDoubleFieldInfo()) {
+        if (error) *error = MATRIX_ERROR_TYPE_MISMATCH;
+        return NULL;
+    }
+
+    if (a->rows != a->cols) {
+        if (error) *error = MATRIX_ERROR_DIMENSION_MISMATCH;
+        return NULL;
+    }
+
+    size_t n = a->rows;
+    if (max_rank == 0) max_rank = UPDATE_DEFAULT_RANK;
+    if (max_rank > n) max_rank = n;
+
+    MatrixFactorization* f = (MatrixFactorization*)calloc(1, sizeof(MatrixFactorization));
+    if (f) {
+        f->a = (double*)malloc(n * n * sizeof(double));
+        f->a_next = (double*)malloc(n * n * sizeof(double));
+        f->lu = (double*)malloc(n * n * sizeof(double));
+        f->perm = (size_t*)malloc(n * sizeof(size_t));
+        f->z = (double*)malloc(max_rank * n * sizeof(double));
+        f->v = (double*)malloc(max_rank * n * sizeof(double));
+        f->cap = (double*)malloc(max_rank * max_rank * sizeof(double));
+        f->cap_perm = (size_t*)malloc(max_rank * sizeof(size_t));
+        f->cap_next = (double*)malloc(max_rank * max_rank * sizeof(double));
+        f->cap_perm_next = (size_t*)malloc(max_rank * sizeof(size_t));
+    }
+    if (!f || !f->a || !f->a_next || !f->lu || !f->perm || !f->z || !f->v || !f->cap || !f->cap_perm ||
+        !f->cap_next || !f->cap_perm_next) {
+        factorization_free(f);
+        if (error) *error = MATRIX_ERROR_MEMORY;
+        return NULL;
+    }
+
+    f->n = n;
+    f->max_rank = max_rank;
+    f->tolerance = tolerance > 0.0 ? tolerance : default_tolerance(n);
+    memcpy(f->a, a->data, n * n * sizeof(double));
+    f->a_norm = matrix_norm_inf(f->a, n);
+
+    MatrixError err = refactor(f);
+    if (err != MATRIX_OK) {
+        factorization_free(f);
+        if (error) *error = err;
+        return NULL;
+    }
+    return f;
+}
+
+static MatrixError factorization_update_impl(MatrixFactorization* f, const Matrix* u, const Matrix* v,
+                                             unsigned long long* flops) {
+    *flops = 0;
+    if (!f || !u || !v) return MATRIX_ERROR_NULL_POINTER;
+    if (u->type != GetDoubleFieldInfo() || v->type != GetDoubleFieldInfo()) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (u->rows != f->n || v->rows != f->n || u->cols != v->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+
+    double* uc = columns_of(u);
+    double* vc = columns_of(v);
+    MatrixError err = MATRIX_ERROR_MEMORY;
+    if (uc && vc) err = apply_updates(f, uc, vc, u->cols, flops);
+    free(uc);
+    free(vc);
+    return err;
+}
+
+//A[row][col] = value - поправка ранга 1: (value - A[row][col]) e_row e_col^T
+static MatrixError factorization_set_impl(MatrixFactorization* f, size_t row, size_t col, double value,
+                                          unsigned long long* flops) {
+    *flops = 0;
+    if (!f) return MATRIX_ERROR_NULL_POINTER;
+    if (row >= f->n || col >= f->n) return MATRIX_ERROR_INVALID_INDEX;
+
+    size_t n = f->n;
+    double delta = value - f->a[row * n + col];
+    if (delta == 0.0) return MATRIX_OK;
+
+    double* u = (double*)calloc(2 * n, sizeof(double));
+    if (!u) return MATRIX_ERROR_MEMORY;
+    double* v = u + n;
+    u[row] = delta;
+    v[col] = 1.0;
+    MatrixError err = apply_updates(f, u, v, 1, flops);
+    free(u);
+    return err;
+}
+
+//Проверка дрейфа: обратная ошибка решения по текущей A. Выше допуска - полное
+//разложение и повторное решение
+static MatrixError factorization_solve_impl(MatrixFactorization* f, const Matrix* b, Matrix* x) {
+    if (!f || !b || !x) return MATRIX_ERROR_NULL_POINTER;
+    if (b->type != GetDoubleFieldInfo() || x->type != GetDoubleFieldInfo()) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (b->rows != f->n || b->cols != 1 || x->rows != f->n || x->cols != 1) {
+        return MATRIX_ERROR_DIMENSION_MISMATCH;
+    }
+    if (!f->factored) return MATRIX_ERROR_SINGULAR_MATRIX;
+    MatrixError err = matrix_make_writable(x);
+    if (err != MATRIX_OK) return err;
+
+    size_t n = f->n;
+    double* y = (double*)malloc((2 * n + 2 * f->max_rank) * sizeof(double));
+    if (!y) return MATRIX_ERROR_MEMORY;
+    double* r = y + n;
+    double* w = r + n;
+    double* t = w + f->max_rank;
+    const double* bd = (const double*)b->data;
+
+    woodbury_solve(f, bd, y, w, t);
+    double be = backward_error(f->a, f->a_norm, bd, y, r, n);
+    if (!(be <= f->tolerance) && f->rank > 0) {
+        err = refactor(f);
+        if (err == MATRIX_OK) {
+            woodbury_solve(f, bd, y, w, t);
+            be = backward_error(f->a, f->a_norm, bd, y, r, n);
+        }
+    }
+
+    if (err == MATRIX_OK) {
+        f->report.backward_error = be;
+        memcpy(x->data, y, n * sizeof(double));
+    }
+    free(y);
+    return err;
+}
+
+//inv -= P (I + V^T P)^-1 V^T inv, P = inv U; vt - столбцы V подряд (то есть V^T).
+//false, если I + V^T P вырождена
+static bool woodbury_inverse(double* inv, const double* u, const double* vt, size_t n, size_t k,
+                             bool* ok) {
+    double* p = (double*)malloc(n * k * sizeof(double));
+    double* q = (double*)malloc(k * n * sizeof(double));
+    double* tq = (double*)malloc(k * n * sizeof(double));
+    double* cap = (double*)malloc(k * k * sizeof(double));
+    double* work = (double*)malloc(2 * k * sizeof(double));
+    size_t* cap_perm = (size_t*)malloc(k * sizeof(size_t));
+    bool woodbury = false;
+    *ok = p && q && tq && cap && work && cap_perm;
+    if (*ok) {
+        double_gemm(inv, u, p, n, n, k);
+        double_gemm(vt, inv, q, k, n, n);
+        double_gemm(vt, p, cap, k, n, k);
+        for (size_t i = 0; i < k; i++) cap[i * k + i] += 1.0;
+        woodbury = double_lu_factor(cap, k, cap_perm) == MATRIX_OK;
+    }
+    if (woodbury) {
+        //T = (I + V^T P)^-1 Q по столбцам Q
+        for (size_t j = 0; j < n; j++) {
+            for (size_t i = 0; i < k; i++) work[i] = q[i * n + j];
+            double_lu_solve(cap, cap_perm, k, work, work + k);
+            for (size_t i = 0; i < k; i++) tq[i * n + j] = work[k + i];
+        }
+
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < (long)n; i++) {
+            double* row = inv + (size_t)i * n;
+            for (size_t t = 0; t < k; t++) {
+                double s = p[(size_t)i * k + t];
+                if (s == 0.0) continue;
+                const double* tt = tq + t * n;
+                for (size_t j = 0; j < n; j++) row[j] -= s * tt[j];
+            }
+        }
+    }
+    free(p);
+    free(q);
+    free(tq);
+    free(cap);
+    free(work);
+    free(cap_perm);
+    return woodbury;
+}
+
+//Обратная ошибка A (inv z) = z для пробного вектора z: O(n^2) вместо проверки A inv = I
+static double inverse_drift(const double* inv, const double* a, size_t n, bool* ok) {
+    double* z = (double*)calloc(3 * n, sizeof(double));
+    *ok = z != NULL;
+    if (!z) return 0.0;
+    double* y = z + n;
+    double* r = y + n;
+    for (size_t i = 0; i < n; i++) z[i] = 1.0 + (double)(i % 7) / 8.0;
+
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < (long)n; i++) {
+        const double* row = inv + (size_t)i * n;
+        double acc = 0.0;
+        for (size_t j = 0; j < n; j++) acc += row[j] * z[j];
+        y[i] = acc;
+    }
+    double be = backward_error(a, matrix_norm_inf(a, n), z, y, r, n);
+    free(z);
+    return be;
+}
+
+//A += U V^T и обновление A^-1 по Вудбери. Если поправка вырождена или дрейф
+//выше допуска, A^-1 считается заново по новой A. Новые A и A^-1 строятся в
+//отдельных матрицах и копируются в a и inv только при успехе
+static MatrixError matrix_inverse_update_impl(Matrix* inv, Matrix* a, const Matrix* u, const Matrix* v) {
+    if (!inv || !a || !u || !v) return MATRIX_ERROR_NULL_POINTER;
+    const FieldInfo* d = GetDoubleFieldInfo();
+    if (inv->type != d || a->type != d || u->type != d || v->type != d) return MATRIX_ERROR_TYPE_MISMATCH;
+    size_t n = a->rows, k = u->cols;
+    if (a->cols != n || inv->rows != n || inv->cols != n || u->rows != n || v->rows != n || v->cols != k) {
+        return MATRIX_ERROR_DIMENSION_MISMATCH;
+    }
+    MatrixError err = matrix_make_writable(inv);
+    if (err == MATRIX_OK) err = matrix_make_writable(a);
+    if (err != MATRIX_OK) return err;
+
+    size_t bytes = n * n * sizeof(double);
+    double* uc = columns_of(u);
+    double* vt = columns_of(v);
+    Matrix* a_next = Matrix_Create(n, n, d);
+    Matrix* inv_next = Matrix_Create(n, n, d);
+    bool ok = uc && vt && a_next && inv_next;
+    bool woodbury = false;
+    if (ok) {
+        memcpy(a_next->data, a->data, bytes);
+        memcpy(inv_next->data, inv->data, bytes);
+        MATRIX_TRACE_BEGIN(span, "inverse_update_woodbury", n, k);
+        woodbury = woodbury_inverse((double*)inv_next->data, (const double*)u->data, vt, n, k, &ok);
+        if (ok) add_outer((double*)a_next->data, uc, vt, n, k);
+        MATRIX_TRACE_END(span);
+    }
+    free(uc);
+    free(vt);
+
+    double drift = 0.0;
+    if (ok && woodbury) drift = inverse_drift((const double*)inv_next->data, (const double*)a_next->data, n, &ok);
+    err = ok ? MATRIX_OK : MATRIX_ERROR_MEMORY;
+    if (ok && (!woodbury || !(drift <= default_tolerance(n)))) {
+        Matrix* fresh = Matrix_Inverse(a_next, &err);
+        if (fresh) memcpy(inv_next->data, fresh->data, bytes);
+        Matrix_Destroy(fresh);
+    }
+    if (err == MATRIX_OK) {
+        memcpy(a->data, a_next->data, bytes);
+        memcpy(inv->data, inv_next->data, bytes);
+    }
+    Matrix_Destroy(a_next);
+    Matrix_Destroy(inv_next);
+    return err;
+}
+
+//half и bfloat16 умножаются во float с одним округлением, как в Matrix_Multiply
+static bool widened(const FieldInfo* type) {
+    return type->to_float && type->from_float && type != GetFloatFieldInfo();
+}
+
+static Matrix* to_float_matrix(const Matrix* m) {
+    Matrix* f = Matrix_Create(m->rows, m->cols, GetFloatFieldInfo());
+    if (f) m->type->to_float((float*)f->data, m->data, m->rows * m->cols);
+    return f;
+}
+
+//C = A B в готовый C того же типа
+static bool product_into(const Matrix* a, const Matrix* b, Matrix* c) {
+    if (!widened(a->type)) return matrix_multiply_into(a, b, c);
+
+    Matrix* fa = to_float_matrix(a);
+    Matrix* fb = to_float_matrix(b);
+    Matrix* fc = Matrix_Create(c->rows, c->cols, GetFloatFieldInfo());
+    bool ok = fa && fb && fc && matrix_multiply_into(fa, fb, fc);
+    if (ok) c->type->from_float(c->data, (const float*)fc->data, c->rows * c->cols);
+    Matrix_Destroy(fa);
+    Matrix_Destroy(fb);
+    Matrix_Destroy(fc);
+    return ok;
+}
+
+//Строка row матрицы m как матрица 1 x cols без копирования
+static Matrix row_of(const Matrix* m, size_t row) {
+    Matrix r = *m;
+    r.rows = 1;
+    r.data = (char*)m->data + row * m->cols * m->type->size;
+    return r;
+}
+
+static MatrixError check_product(const Matrix* c, const Matrix* a, const Matrix* b) {
+    if (!c || !a || !b) return MATRIX_ERROR_NULL_POINTER;
+    if (!FieldInfo_Equals(a->type, b->type) || !FieldInfo_Equals(a->type, c->type)) return MATRIX_ERROR_TYPE_MISMATCH;
+    if (a->cols != b->rows || c->rows != a->rows || c->cols != b->cols) return MATRIX_ERROR_DIMENSION_MISMATCH;
+    return MATRIX_OK;
+}
+
+static MatrixError matrix_product_refresh_row_impl(Matrix* c, const Matrix* a, const Matrix* b, size_t row) {
+    MatrixError err = check_product(c, a, b);
+    if (err != MATRIX_OK) return err;
+    if (row >= a->rows) return MATRIX_ERROR_INVALID_INDEX;
+    err = matrix_make_writable(c);
+    if (err != MATRIX_OK) return err;
+
+    Matrix a_row = row_of(a, row);
+    Matrix c_row = row_of(c, row);
+    return product_into(&a_row, b, &c_row) ? MATRIX_OK : MATRIX_ERROR_MEMORY;
+}
+
+//c[i] += (a[i][col] - old[i]) * b[col]; возвращает строку с наибольшим изменением
+#define COLUMN_UPDATE(T, S, ABS)                                                                 \
+static size_t S##_column_update(T* c, const T* a, const T* b, const T* old,                     \
+                                size_t m, size_t k, size_t n, size_t col) {                     \
+    const T* b_row = b + col * n;                                                               \
+    size_t worst = 0;                                                                           \
+    T worst_delta = 0;                                                                          \
+    for (size_t i = 0; i < m; i++) {                                                            \
+        T d = ABS(a[i * k + col] - old[i]);                                                     \
+        if (d > worst_delta) {                                                                  \
+            worst_delta = d;                                                                    \
+            worst = i;                                                                          \
+        }                                                                                       \
+    }                                                                                           \
+    _Pragma("omp parallel for schedule(static)")                                                \
+    for (long i = 0; i < (long)m; i++) {                                                        \
+        T d = a[(size_t)i * k + col] - old[i];                                                  \
+        if (d == 0) continue;                                                                   \
+        T* row = c + (size_t)i * n;                                                             \
+        for (size_t j = 0; j < n; j++) row[j] += d * b_row[j];                                  \
+    }                                                                                           \
+    return worst;                                                                               \
+}                                                                                               \
+                                                                                                \
+/*Расхождение обновленной строки с пересчитанной относительно ее величины*/                   \
+static bool S##_row_drifted(const T* updated, const T* exact, size_t n, size_t k, T eps) {      \
+    T diff = 0, scale = 0;                                                                      \
+    for (size_t j = 0; j < n; j++) {                                                            \
+        T d = ABS(updated[j] - exact[j]);                                                       \
+        if (d > diff) diff = d;                                                                 \
+        if (ABS(exact[j]) > scale) scale = ABS(exact[j]);                                       \
+    }                                                                                           \
+    return diff > (T)UPDATE_DRIFT_FACTOR * (T)sqrt((double)k) * eps * scale;                    \
+}
+
+COLUMN_UPDATE(float, float, fabsf)
+COLUMN_UPDATE(double, double, fabs)
+
+//Точные типы (целые, GF(p)): обновление через операции типа, дрейфа нет
+static bool exact_column_update(Matrix* c, const Matrix* a, const Matrix* b, const void* old, size_t col) {
+    const FieldInfo* type = a->type;
+    size_t size = type->size, k = a->cols, n = b->cols;
+    char* delta = (char*)malloc(2 * size);
+    if (!delta) return false;
+    char* term = delta + size;
+    const char* b_row = (const char*)b->data + col * n * size;
+    for (size_t i = 0; i < a->rows; i++) {
+        type->sub(type, delta, (const char*)a->data + (i * k + col) * size, (const char*)old + i * size);
+        if (Field_EqualsZero(type, delta)) continue;
+        char* row = (char*)c->data + i * n * size;
+        for (size_t j = 0; j < n; j++) {
+            type->mul(type, term, delta, b_row + j * size);
+            type->add(type, row + j * size, row + j * size, term);
+        }
+    }
+    free(delta);
+    return true;
+}
+
+//Ранг 1 для float и double с проверкой по строке, изменившейся сильнее всех; для
+//точных типов - через операции типа; полукольца (нет вычитания), half, bfloat16 и
+//комплексные C считаются целиком. recomputed - C посчитана заново
+static MatrixError matrix_product_refresh_column_impl(Matrix* c, const Matrix* a, const Matrix* b, size_t col,
+                                                      const void* old_column, bool* recomputed) {
+    *recomputed = false;
+    MatrixError err = check_product(c, a, b);
+    if (err != MATRIX_OK) return err;
+    if (!old_column) return MATRIX_ERROR_NULL_POINTER;
+    if (col >= a->cols) return MATRIX_ERROR_INVALID_INDEX;
+    err = matrix_make_writable(c);
+    if (err != MATRIX_OK) return err;
+
+    size_t m = a->rows, k = a->cols, n = b->cols;
+    uint32_t id = a->type->id;
+    if (id == FIELD_ID_FLOAT || id == FIELD_ID_DOUBLE) {
+        size_t worst;
+        if (id == FIELD_ID_FLOAT) {
+            worst = float_column_update((float*)c->data, (const float*)a->data, (const float*)b->data,
+                                        (const float*)old_column, m, k, n, col);
+        } else {
+            worst = double_column_update((double*)c->data, (const double*)a->data, (const double*)b->data,
+                                         (const double*)old_column, m, k, n, col);
+        }
+
+        Matrix* exact = Matrix_Create(1, n, a->type);
+        if (!exact) return MATRIX_ERROR_MEMORY;
+        Matrix a_row = row_of(a, worst);
+        bool ok = matrix_multiply_into(&a_row, b, exact);
+        const void* updated = (const char*)c->data + worst * n * a->type->size;
+        if (ok) {
+            *recomputed = id == FIELD_ID_FLOAT
+                ? float_row_drifted((const float*)updated, (const float*)exact->data, n, k, FLT_EPSILON)
+                : double_row_drifted((const double*)updated, (const double*)exact->data, n, k, DBL_EPSILON);
+        }
+        Matrix_Destroy(exact);
+        if (!ok) return MATRIX_ERROR_MEMORY;
+        if (!*recomputed) return MATRIX_OK;
+    } else if (a->type->sub && !a->type->to_float && id != FIELD_ID_COMPLEX) {
+        return exact_column_update(c, a, b, old_column, col) ? MATRIX_OK : MATRIX_ERROR_MEMORY;
+    }
+
+    *recomputed = true;
+    MATRIX_TRACE_BEGIN(span, "product_recompute", m, n);
+    bool ok = product_into(a, b, c);
+    MATRIX_TRACE_END(span);
+    return ok ? MATRIX_OK : MATRIX_ERROR_MEMORY;
+}
+
+//Публичные функции
+MatrixFactorization* Matrix_Factorize(const Matrix* a, size_t max_rank, double tolerance, MatrixError* error) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_FACTORIZE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_FACTORIZE), a ? a->rows : 0, a ? a->cols : 0);
+    MatrixFactorization* f = matrix_factorize_impl(a, max_rank, tolerance, error);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(f ? 2 * f->n * f->n * f->n / 3 : 0);
+    return f;
+}
+
+MatrixError MatrixFactorization_Update(MatrixFactorization* f, const Matrix* u, const Matrix* v) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_FACTORIZATION_UPDATE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_FACTORIZATION_UPDATE), f ? f->n : 0, u ? u->cols : 0);
+    unsigned long long flops = 0;
+    MatrixError err = factorization_update_impl(f, u, v, &flops);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(flops);
+    return err;
+}
+
+MatrixError MatrixFactorization_Set(MatrixFactorization* f, size_t row, size_t col, double value) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_FACTORIZATION_UPDATE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_FACTORIZATION_UPDATE), f ? f->n : 0, 1);
+    unsigned long long flops = 0;
+    MatrixError err = factorization_set_impl(f, row, col, value, &flops);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(flops);
+    return err;
+}
+
+MatrixError MatrixFactorization_Solve(MatrixFactorization* f, const Matrix* b, Matrix* x) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_FACTORIZATION_SOLVE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_FACTORIZATION_SOLVE), f ? f->n : 0, 1);
+    MatrixError err = factorization_solve_impl(f, b, x);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 4 * f->n * f->n + 4 * f->n * f->rank : 0);
+    return err;
+}
+
+MatrixError MatrixFactorization_GetReport(const MatrixFactorization* f, MatrixUpdateReport* report) {
+    if (!f || !report) return MATRIX_ERROR_NULL_POINTER;
+    *report = f->report;
+    return MATRIX_OK;
+}
+
+void MatrixFactorization_Destroy(MatrixFactorization* f) {
+    factorization_free(f);
+}
+
+MatrixError Matrix_InverseUpdate(Matrix* inv, Matrix* a, const Matrix* u, const Matrix* v) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_INVERSE_UPDATE);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_INVERSE_UPDATE), a ? a->rows : 0, u ? u->cols : 0);
+    MatrixError err = matrix_inverse_update_impl(inv, a, u, v);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 6 * a->rows * a->rows * u->cols : 0);
+    return err;
+}
+
+MatrixError Matrix_ProductRefreshRow(Matrix* c, const Matrix* a, const Matrix* b, size_t row) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_PRODUCT_REFRESH);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_PRODUCT_REFRESH), 1, b ? b->cols : 0);
+    MatrixError err = matrix_product_refresh_row_impl(c, a, b, row);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err == MATRIX_OK ? 2 * a->cols * b->cols : 0);
+    return err;
+}
+
+MatrixError Matrix_ProductRefreshColumn(Matrix* c, const Matrix* a, const Matrix* b, size_t col,
+                                        const void* old_column) {
+    MATRIX_STATS_BEGIN(MATRIX_OP_PRODUCT_REFRESH);
+    MATRIX_TRACE_BEGIN(span, Matrix_OpName(MATRIX_OP_PRODUCT_REFRESH), a ? a->rows : 0, b ? b->cols : 0);
+    bool recomputed = false;
+    MatrixError err = matrix_product_refresh_column_impl(c, a, b, col, old_column, &recomputed);
+    MATRIX_TRACE_END(span);
+    MATRIX_STATS_END(err != MATRIX_OK ? 0 :
+                     recomputed ? 2 * a->rows * a->cols * b->cols : 2 * a->rows * b->cols + 2 * a->cols * b->cols);
+    return err;
+}
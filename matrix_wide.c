@@ -0,0 +1,219 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+#include "matrix.h"
+#include "matrix_wide.h"
+#include "matrix_trace.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define WIDE_HAVE_SIMD_DISPATCH 1
+#endif
+
+//Блоки по k и j: полоса B (256 x 512 по 8 байт = 1 МБ) остается в L2/L3
+#define WIDE_BLOCK_K 256
+#define WIDE_BLOCK_N 512
+//Шаг исключения меньше этого числа умножений-сложений идет в одном потоке без
+//параллельной области: ее запуск на каждый столбец дороже самой работы
+#define WIDE_PARALLEL_MIN_WORK (1 << 15)
+
+//y += s * x
+typedef void (*DoubleAxpyFunc)(double* y, double s, const double* x, size_t n);
+typedef void (*Int64AxpyFunc)(int64_t* y, int64_t s, const int64_t* x, size_t n);
+
+static void double_axpy_scalar(double* y, double s, const double* x, size_t n) {
+    for (size_t j = 0; j < n; j++) y[j] += s * x[j];
+}
+
+//Умножение по модулю 2^64 через uint64_t
+static void int64_axpy_scalar(int64_t* y, int64_t s, const int64_t* x, size_t n) {
+    uint64_t us = (uint64_t)s;
+    for (size_t j = 0; j < n; j++) y[j] = (int64_t)((uint64_t)y[j] + us * (uint64_t)x[j]);
+}
+
+#ifdef WIDE_HAVE_SIMD_DISPATCH
+
+__attribute__((target("avx2,fma")))
+static void double_axpy_fma(double* y, double s, const double* x, size_t n) {
+    __m256d vs = _mm256_set1_pd(s);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256d y0 = _mm256_fmadd_pd(vs, _mm256_loadu_pd(x + j), _mm256_loadu_pd(y + j));
+        __m256d y1 = _mm256_fmadd_pd(vs, _mm256_loadu_pd(x + j + 4), _mm256_loadu_pd(y + j + 4));
+        _mm256_storeu_pd(y + j, y0);
+        _mm256_storeu_pd(y + j + 4, y1);
+    }
+    double_axpy_scalar(y + j, s, x + j, n - j);
+}
+
+//В AVX2 нет 64-битного mullo; vpmullq появляется только в AVX-512DQ
+__attribute__((target("avx512f,avx512dq")))
+static void int64_axpy_avx512(int64_t* y, int64_t s, const int64_t* x, size_t n) {
+    __m512i vs = _mm512_set1_epi64(s);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m512i prod = _mm512_mullo_epi64(vs, _mm512_loadu_si512((const void*)(x + j)));
+        _mm512_storeu_si512((void*)(y + j), _mm512_add_epi64(_mm512_loadu_si512((const void*)(y + j)), prod));
+    }
+    int64_axpy_scalar(y + j, s, x + j, n - j);
+}
+
+#endif
+
+static DoubleAxpyFunc select_double_axpy(void) {
+#ifdef WIDE_HAVE_SIMD_DISPATCH
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return double_axpy_fma;
+#endif
+    return double_axpy_scalar;
+}
+
+static Int64AxpyFunc select_int64_axpy(void) {
+#ifdef WIDE_HAVE_SIMD_DISPATCH
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return int64_axpy_avx512;
+#endif
+    return int64_axpy_scalar;
+}
+
+void double_gemm(const double* a, const double* b, double* c, size_t m, size_t k, size_t n) {
+    DoubleAxpyFunc axpy = select_double_axpy();
+    memset(c, 0, m * n * sizeof(double));
+
+    for (size_t jj = 0; jj < n; jj += WIDE_BLOCK_N) {
+        size_t width = jj + WIDE_BLOCK_N < n ? WIDE_BLOCK_N : n - jj;
+        for (size_t kk = 0; kk < k; kk += WIDE_BLOCK_K) {
+            size_t k_end = kk + WIDE_BLOCK_K < k ? kk + WIDE_BLOCK_K : k;
+
+            #pragma omp parallel for schedule(static)
+            for (long i = 0; i < (long)m; i++) {
+                double* c_row = c + (size_t)i * n + jj;
+                for (size_t p = kk; p < k_end; p++) {
+                    //Без пропуска нулей: 0 * Inf и 0 * NaN из B должны дать NaN
+                    double a_ip = a[(size_t)i * k + p];
+                    axpy(c_row, a_ip, b + p * n + jj, width);
+                }
+            }
+        }
+    }
+}
+
+void int64_gemm(const int64_t* a, const int64_t* b, int64_t* c, size_t m, size_t k, size_t n) {
+    Int64AxpyFunc axpy = select_int64_axpy();
+    memset(c, 0, m * n * sizeof(int64_t));
+
+    for (size_t jj = 0; jj < n; jj += WIDE_BLOCK_N) {
+        size_t width = jj + WIDE_BLOCK_N < n ? WIDE_BLOCK_N : n - jj;
+        for (size_t kk = 0; kk < k; kk += WIDE_BLOCK_K) {
+            size_t k_end = kk + WIDE_BLOCK_K < k ? kk + WIDE_BLOCK_K : k;
+
+            #pragma omp parallel for schedule(static)
+            for (long i = 0; i < (long)m; i++) {
+                int64_t* c_row = c + (size_t)i * n + jj;
+                for (size_t p = kk; p < k_end; p++) {
+                    int64_t a_ip = a[(size_t)i * k + p];
+                    if (a_ip == 0) continue;
+                    axpy(c_row, a_ip, b + p * n + jj, width);
+                }
+            }
+        }
+    }
+}
+
+//Поэлементные циклы без зависимостей векторизуются компилятором
+void double_add(const double* a, const double* b, double* c, size_t count) {
+    for (size_t i = 0; i < count; i++) c[i] = a[i] + b[i];
+}
+
+void int64_add(const int64_t* a, const int64_t* b, int64_t* c, size_t count) {
+    for (size_t i = 0; i < count; i++) c[i] = (int64_t)((uint64_t)a[i] + (uint64_t)b[i]);
+}
+
+void double_scale(const double* a, double s, double* c, size_t count) {
+    for (size_t i = 0; i < count; i++) c[i] = a[i] * s;
+}
+
+void int64_scale(const int64_t* a, int64_t s, int64_t* c, size_t count) {
+    for (size_t i = 0; i < count; i++) c[i] = (int64_t)((uint64_t)a[i] * (uint64_t)s);
+}
+
+//Строка расширенной матрицы после главной: row[k] обнуляется, остаток - axpy
+static inline void gauss_eliminate_row(double* row, const double* pivot_row, double pivot, size_t k,
+                                       size_t cols, DoubleAxpyFunc axpy) {
+    if (row[k] == 0.0) return;
+    axpy(row + k + 1, -row[k] / pivot, pivot_row + k + 1, cols - k - 1);
+    row[k] = 0.0;
+}
+
+//Порог вырожденности относительный: n * eps * max|a_ij|, а не абсолютный 1e-10
+//как у float, иначе масштабированные системы в double ложно считаются вырожденными
+MatrixError double_gauss_solve(const double* a, const double* b, double* x, size_t n) {
+    size_t cols = n + 1;
+    double* w = (double*)malloc(n * cols * sizeof(double));
+    if (!w) return MATRIX_ERROR_MEMORY;
+
+    double max_abs = 0.0;
+    MATRIX_TRACE_BEGIN(augment_span, "gauss_augment", n, cols);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(w + i * cols, a + i * n, n * sizeof(double));
+        w[i * cols + n] = b[i];
+        for (size_t j = 0; j < n; j++) max_abs = fmax(max_abs, fabs(a[i * n + j]));
+    }
+    MATRIX_TRACE_END(augment_span);
+
+    double threshold = (double)n * DBL_EPSILON * max_abs;
+    DoubleAxpyFunc axpy = select_double_axpy();
+
+    for (size_t k = 0; k < n; k++) {
+        MATRIX_TRACE_BEGIN(pivot_span, "gauss_pivot_search", n - k, 1);
+        size_t max_row = k;
+        double max_val = fabs(w[k * cols + k]);
+        for (size_t i = k + 1; i < n; i++) {
+            double cur = fabs(w[i * cols + k]);
+            if (cur > max_val) {
+                max_val = cur;
+                max_row = i;
+            }
+        }
+        MATRIX_TRACE_END(pivot_span);
+
+        if (!(max_val > threshold)) {
+            free(w);
+            return MATRIX_ERROR_SINGULAR_MATRIX;
+        }
+
+        if (max_row != k) {
+            for (size_t j = k; j < cols; j++) {
+                double t = w[k * cols + j];
+                w[k * cols + j] = w[max_row * cols + j];
+                w[max_row * cols + j] = t;
+            }
+        }
+
+        const double* pivot_row = w + k * cols;
+        double pivot = pivot_row[k];
+
+        MATRIX_TRACE_BEGIN(eliminate_span, "gauss_eliminate", n - k - 1, cols - k);
+        if ((n - k - 1) * (cols - k) >= WIDE_PARALLEL_MIN_WORK) {
+            #pragma omp parallel for schedule(static)
+            for (long i = (long)k + 1; i < (long)n; i++) {
+                gauss_eliminate_row(w + (size_t)i * cols, pivot_row, pivot, k, cols, axpy);
+            }
+        } else {
+            for (size_t i = k + 1; i < n; i++) gauss_eliminate_row(w + i * cols, pivot_row, pivot, k, cols, axpy);
+        }
+        MATRIX_TRACE_END(eliminate_span);
+    }
+
+    MATRIX_TRACE_BEGIN(back_span, "gauss_back_substitution", n, 1);
+    for (size_t i = n; i-- > 0; ) {
+        const double* row = w + i * cols;
+        double acc = row[n];
+        for (size_t j = i + 1; j < n; j++) acc -= row[j] * x[j];
+        x[i] = acc / row[i];
+    }
+    MATRIX_TRACE_END(back_span);
+
+    free(w);
+    return MATRIX_OK;
+}
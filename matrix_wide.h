@@ -0,0 +1,20 @@
+#ifndef MATRIX_WIDE_H
+#define MATRIX_WIDE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+
+//Ядра для 64-битных типов (double_field.c, int64_field.c); C перезаписывается
+void double_gemm(const double* a, const double* b, double* c, size_t m, size_t k, size_t n);
+void int64_gemm(const int64_t* a, const int64_t* b, int64_t* c, size_t m, size_t k, size_t n);
+
+void double_add(const double* a, const double* b, double* c, size_t count);
+void int64_add(const int64_t* a, const int64_t* b, int64_t* c, size_t count);
+void double_scale(const double* a, double s, double* c, size_t count);
+void int64_scale(const int64_t* a, int64_t s, int64_t* c, size_t count);
+
+//Гаусс с выбором главного элемента по столбцу; a и b не изменяются
+MatrixError double_gauss_solve(const double* a, const double* b, double* x, size_t n);
+
+#endif
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "field.h"
+#include "modular_field.h"
+
+static const uint32_t g_modular_zero = 0;
+static const uint32_t g_modular_one = 1;
+
+static void ModularReader(const FieldInfo* field, void* dest, FILE* src) {
+    long long value = 0;
+    fscanf(src, "%lld", &value);
+    long long r = value % (long long)field->modulus;
+    *(uint32_t*)dest = (uint32_t)(r < 0 ? r + field->modulus : r);
+}
+
+static void ModularPrinter(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
+    fprintf(dest, "%u", (unsigned)*(const uint32_t*)data);
+}
+
+static void ModularAdder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    uint32_t sum = *(const uint32_t*)a + *(const uint32_t*)b;
+    *(uint32_t*)result = sum >= field->modulus ? sum - field->modulus : sum;
+}
+
+static void ModularSubtractor(const FieldInfo* field, void* result, const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    *(uint32_t*)result = x >= y ? x - y : x + field->modulus - y;
+}
+
+static void ModularMultiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    *(uint32_t*)result = modular_mul(modular_info(field), *(const uint32_t*)a, *(const uint32_t*)b);
+}
+
+//Деление - умножение на обратный; на ноль результат не меняется, как у int
+static void ModularDivider(const FieldInfo* field, void* result, const void* a, const void* b) {
+    uint32_t divisor = *(const uint32_t*)b;
+    if (divisor != 0) {
+        uint32_t inv = ModularInverse(divisor, field->modulus);
+        *(uint32_t*)result = modular_mul(modular_info(field), *(const uint32_t*)a, inv);
+    }
+}
+
+static int ModularIsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const uint32_t*)a == 0;
+}
+
+uint32_t ModularInverse(uint32_t a, uint32_t p) {
+    int64_t t = 0, new_t = 1;
+    int64_t r = p, new_r = a % p;
+    while (new_r != 0) {
+        int64_t q = r / new_r;
+        int64_t tmp = t - q * new_t;
+        t = new_t;
+        new_t = tmp;
+        tmp = r - q * new_r;
+        r = new_r;
+        new_r = tmp;
+    }
+    return (uint32_t)(t < 0 ? t + p : t);
+}
+
+static int is_prime(uint32_t p) {
+    if (p < 2) return 0;
+    if (p % 2 == 0) return p == 2;
+    for (uint32_t d = 3; d <= p / d; d += 2) {
+        if (p % d == 0) return 0;
+    }
+    return 1;
+}
+
+//Инициализация
+const FieldInfo* CreateModularFieldInfo(uint32_t p) {
+    if (p >= (1u << 31) || !is_prime(p)) return NULL;
+
+    ModularFieldInfo* info = (ModularFieldInfo*)malloc(sizeof(ModularFieldInfo));
+    if (!info) return NULL;
+
+    info->info.size = sizeof(uint32_t);
+    snprintf(info->info.name, sizeof(info->info.name), "gf%u", (unsigned)p);
+
+    info->info.read = ModularReader;
+    info->info.print = ModularPrinter;
+    info->info.add = ModularAdder;
+    info->info.sub = ModularSubtractor;
+    info->info.mul = ModularMultiplier;
+    info->info.div = ModularDivider;
+    //Порядка нет: главный элемент - любой ненулевой
+    info->info.abs = NULL;
+    info->info.is_zero = ModularIsZero;
+    info->info.to_float = NULL;
+    info->info.from_float = NULL;
+    info->info.modulus = p;
+    info->info.zero = &g_modular_zero;
+    info->info.one = &g_modular_one;
+    info->info.id = FIELD_ID_MODULAR;
+
+    info->barrett = UINT64_MAX / p + (UINT64_MAX % p == p - 1);
+    uint64_t max_product = (uint64_t)(p - 1) * (p - 1);
+    uint64_t delay = (UINT64_MAX - (p - 1)) / max_product;
+    info->delay = delay > SIZE_MAX ? SIZE_MAX : (size_t)delay;
+
+    return &info->info;
+}
+
+void DestroyModularFieldInfo(const FieldInfo* field) {
+    if (field && field->modulus) {
+        free((void*)modular_info(field));
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef MODULAR_FIELD_H
+#define MODULAR_FIELD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "field.h"
+
+//Поле вычетов GF(p) для простого p < 2^31; элементы хранятся как uint32_t в [0, p).
+//Каждый вызов создает отдельный тип, который освобождается после всех его матриц.
+const FieldInfo* CreateModularFieldInfo(uint32_t p);
+void DestroyModularFieldInfo(const FieldInfo* field);
+
+//Параметры редукции, общие для поэлементных операций и ядер в matrix_modular.c
+typedef struct {
+    FieldInfo info;
+    uint64_t barrett;   //floor(2^64 / p)
+    size_t delay;       //сколько произведений (p-1)^2 можно сложить к остатку без переполнения uint64
+} ModularFieldInfo;
+
+static inline const ModularFieldInfo* modular_info(const FieldInfo* field) {
+    return (const ModularFieldInfo*)field;
+}
+
+static inline uint64_t modular_mulhi(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+}
+
+//Редукция Барретта для любого x < 2^64: частное занижено не более чем на 1
+static inline uint32_t modular_reduce(const ModularFieldInfo* f, uint64_t x) {
+    uint64_t p = f->info.modulus;
+    uint64_t r = x - modular_mulhi(x, f->barrett) * p;
+    return (uint32_t)(r >= p ? r - p : r);
+}
+
+static inline uint32_t modular_mul(const ModularFieldInfo* f, uint32_t a, uint32_t b) {
+    return modular_reduce(f, (uint64_t)a * b);
+}
+
+//Обратный элемент по расширенному алгоритму Евклида (a != 0)
+uint32_t ModularInverse(uint32_t a, uint32_t p);
+
+#endif
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "field.h"
+#include "semiring_field.h"
+
+static const float g_minplus_zero = INFINITY;
+static const float g_minplus_one = 0.0f;
+static const uint8_t g_bool_zero = 0;
+static const uint8_t g_bool_one = 1;
+
+static void MinPlusReader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
+    fscanf(src, "%f", (float*)dest);
+}
+
+static void MinPlusPrinter(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
+    fprintf(dest, "%.2f", *(const float*)data);
+}
+
+static void MinPlusAdder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    float x = *(const float*)a;
+    float y = *(const float*)b;
+    *(float*)result = y < x ? y : x;
+}
+
+static void MinPlusMultiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(float*)result = *(const float*)a + *(const float*)b;
+}
+
+//Нуль min-plus - это +inf
+static int MinPlusIsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const float*)a == INFINITY;
+}
+
+static void BoolReader(const FieldInfo* field, void* dest, FILE* src) {
+    (void)field;
+    int value = 0;
+    fscanf(src, "%d", &value);
+    *(uint8_t*)dest = value != 0;
+}
+
+static void BoolPrinter(const FieldInfo* field, const void* data, FILE* dest) {
+    (void)field;
+    fprintf(dest, "%d", (int)*(const uint8_t*)data);
+}
+
+static void BoolAdder(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(uint8_t*)result = *(const uint8_t*)a | *(const uint8_t*)b;
+}
+
+static void BoolMultiplier(const FieldInfo* field, void* result, const void* a, const void* b) {
+    (void)field;
+    *(uint8_t*)result = *(const uint8_t*)a & *(const uint8_t*)b;
+}
+
+static int BoolIsZero(const FieldInfo* field, const void* a) {
+    (void)field;
+    return *(const uint8_t*)a == 0;
+}
+
+//Инициализация
+static const FieldInfo g_minplus_field_info = {
+    .size = sizeof(float),
+    .name = "minplus",
+    .read = MinPlusReader,
+    .print = MinPlusPrinter,
+    .add = MinPlusAdder,
+    .sub = NULL,
+    .mul = MinPlusMultiplier,
+    .div = NULL,
+    .abs = NULL,
+    .is_zero = MinPlusIsZero,
+    //Без to_float: иначе умножение ушло бы в обычное float-ядро
+    .to_float = NULL,
+    .from_float = NULL,
+    .modulus = 0,
+    .zero = &g_minplus_zero,
+    .one = &g_minplus_one,
+    .id = FIELD_ID_MINPLUS,
+};
+
+static const FieldInfo g_bool_field_info = {
+    .size = sizeof(uint8_t),
+    .name = "bool",
+    .read = BoolReader,
+    .print = BoolPrinter,
+    .add = BoolAdder,
+    .sub = NULL,
+    .mul = BoolMultiplier,
+    .div = NULL,
+    .abs = NULL,
+    .is_zero = BoolIsZero,
+    .to_float = NULL,
+    .from_float = NULL,
+    .modulus = 0,
+    .zero = &g_bool_zero,
+    .one = &g_bool_one,
+    .id = FIELD_ID_BOOL,
+};
+
+const FieldInfo* GetMinPlusFieldInfo(void) {
+    return &g_minplus_field_info;
+}
+
+const FieldInfo* GetBoolFieldInfo(void) {
+    return &g_bool_field_info;
+}
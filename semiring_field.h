@@ -0,0 +1,12 @@
+#ifndef SEMIRING_FIELD_H
+#define SEMIRING_FIELD_H
+
+#include "field.h"
+
+//Полукольца без вычитания и деления (sub/div = NULL, Matrix_GaussSolve не применим)
+//min-plus над float: сложение - min, умножение - +, нуль +inf, единица 0
+const FieldInfo* GetMinPlusFieldInfo(void);
+//Булево полукольцо над uint8_t: сложение - OR, умножение - AND
+const FieldInfo* GetBoolFieldInfo(void);
+
+#endif
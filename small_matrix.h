@@ -0,0 +1,181 @@
+#ifndef SMALL_MATRIX_H
+#define SMALL_MATRIX_H
+
+#include <stdbool.h>
+#include <string.h>
+#include "matrix.h"
+
+//Квадратные матрицы фиксированного размера 2..8 для float (SmallMatNf) и double
+//(SmallMatNd): значения на стеке, без malloc и без обратных вызовов FieldInfo.
+//Размер - константа времени компиляции, поэтому циклы полностью разворачиваются,
+//а строки в умножении и исключении векторизуются (SSE/AVX по флагам компиляции).
+//Вырожденность - точный нулевой главный элемент; c в _Multiply может совпадать с a или b.
+#if defined(__GNUC__)
+    #define SMALL_UNROLL _Pragma("GCC unroll 8")
+#else
+    #define SMALL_UNROLL
+#endif
+
+#define SMALL_ABS(x) ((x) < 0 ? -(x) : (x))
+
+#define SMALL_MATRIX_DEFINE(N, T, S, FIELD)                                              \
+    typedef struct {                                                                     \
+        T m[N][N];                                                                       \
+    } SmallMat##N##S;                                                                    \
+                                                                                         \
+    static inline void SmallMat##N##S##_Identity(SmallMat##N##S* out) {                  \
+        SMALL_UNROLL                                                                     \
+        for (int i = 0; i < N; i++) {                                                    \
+            SMALL_UNROLL                                                                 \
+            for (int j = 0; j < N; j++) out->m[i][j] = (T)(i == j);                      \
+        }                                                                                \
+    }                                                                                    \
+                                                                                         \
+    static inline void SmallMat##N##S##_Multiply(const SmallMat##N##S* a,                \
+                                                 const SmallMat##N##S* b,                \
+                                                 SmallMat##N##S* c) {                    \
+        SmallMat##N##S r;                                                                \
+        SMALL_UNROLL                                                                     \
+        for (int i = 0; i < N; i++) {                                                    \
+            SMALL_UNROLL                                                                 \
+            for (int j = 0; j < N; j++) r.m[i][j] = a->m[i][0] * b->m[0][j];             \
+            SMALL_UNROLL                                                                 \
+            for (int k = 1; k < N; k++) {                                                \
+                T s = a->m[i][k];                                                        \
+                SMALL_UNROLL                                                             \
+                for (int j = 0; j < N; j++) r.m[i][j] += s * b->m[k][j];                 \
+            }                                                                            \
+        }                                                                                \
+        *c = r;                                                                          \
+    }                                                                                    \
+                                                                                         \
+    /*Исключение с выбором главного элемента на копии; swaps - число перестановок*/     \
+    static inline bool SmallMat##N##S##_Eliminate(SmallMat##N##S* w, T* rhs,             \
+                                                  SmallMat##N##S* rhs_mat, int* swaps) { \
+        SMALL_UNROLL                                                                     \
+        for (int k = 0; k < N; k++) {                                                    \
+            int p = k;                                                                   \
+            for (int i = k + 1; i < N; i++) {                                            \
+                if (SMALL_ABS(w->m[i][k]) > SMALL_ABS(w->m[p][k])) p = i;                \
+            }                                                                            \
+            if (w->m[p][k] == (T)0) return false;                                        \
+            if (p != k) {                                                                \
+                SMALL_UNROLL                                                             \
+                for (int j = 0; j < N; j++) {                                            \
+                    T t = w->m[k][j]; w->m[k][j] = w->m[p][j]; w->m[p][j] = t;           \
+                    if (rhs_mat) {                                                       \
+                        t = rhs_mat->m[k][j];                                            \
+                        rhs_mat->m[k][j] = rhs_mat->m[p][j];                             \
+                        rhs_mat->m[p][j] = t;                                            \
+                    }                                                                    \
+                }                                                                        \
+                if (rhs) { T t = rhs[k]; rhs[k] = rhs[p]; rhs[p] = t; }                  \
+                (*swaps)++;                                                              \
+            }                                                                            \
+            SMALL_UNROLL                                                                 \
+            for (int i = k + 1; i < N; i++) {                                            \
+                T f = w->m[i][k] / w->m[k][k];                                           \
+                SMALL_UNROLL                                                             \
+                for (int j = 0; j < N; j++) {                                            \
+                    w->m[i][j] -= f * w->m[k][j];                                        \
+                    if (rhs_mat) rhs_mat->m[i][j] -= f * rhs_mat->m[k][j];               \
+                }                                                                        \
+                if (rhs) rhs[i] -= f * rhs[k];                                           \
+            }                                                                            \
+        }                                                                                \
+        return true;                                                                     \
+    }                                                                                    \
+                                                                                         \
+    static inline T SmallMat##N##S##_Determinant(const SmallMat##N##S* a) {              \
+        SmallMat##N##S w = *a;                                                           \
+        int swaps = 0;                                                                   \
+        if (!SmallMat##N##S##_Eliminate(&w, NULL, NULL, &swaps)) return (T)0;            \
+        T det = (swaps % 2) ? (T)-1 : (T)1;                                              \
+        SMALL_UNROLL                                                                     \
+        for (int k = 0; k < N; k++) det *= w.m[k][k];                                    \
+        return det;                                                                      \
+    }                                                                                    \
+                                                                                         \
+    /*x = A^-1 b; false, если A вырождена (x не меняется)*/                             \
+    static inline bool SmallMat##N##S##_Solve(const SmallMat##N##S* a, const T* b,       \
+                                              T* x) {                                    \
+        SmallMat##N##S w = *a;                                                           \
+        T y[N];                                                                          \
+        int swaps = 0;                                                                   \
+        memcpy(y, b, sizeof(y));                                                         \
+        if (!SmallMat##N##S##_Eliminate(&w, y, NULL, &swaps)) return false;             \
+        SMALL_UNROLL                                                                     \
+        for (int i = N - 1; i >= 0; i--) {                                               \
+            T acc = y[i];                                                                \
+            for (int j = i + 1; j < N; j++) acc -= w.m[i][j] * y[j];                     \
+            y[i] = acc / w.m[i][i];                                                      \
+        }                                                                                \
+        memcpy(x, y, sizeof(y));                                                         \
+        return true;                                                                     \
+    }                                                                                    \
+                                                                                         \
+    /*Прямой ход над [A | I], затем обратный по строкам U*/                             \
+    static inline bool SmallMat##N##S##_Inverse(const SmallMat##N##S* a,                 \
+                                                SmallMat##N##S* out) {                   \
+        SmallMat##N##S w = *a;                                                           \
+        SmallMat##N##S inv;                                                              \
+        int swaps = 0;                                                                   \
+        SmallMat##N##S##_Identity(&inv);                                                 \
+        if (!SmallMat##N##S##_Eliminate(&w, NULL, &inv, &swaps)) return false;          \
+        SMALL_UNROLL                                                                     \
+        for (int i = N - 1; i >= 0; i--) {                                               \
+            for (int k = i + 1; k < N; k++) {                                            \
+                T f = w.m[i][k];                                                         \
+                SMALL_UNROLL                                                             \
+                for (int j = 0; j < N; j++) inv.m[i][j] -= f * inv.m[k][j];              \
+            }                                                                            \
+            T d = w.m[i][i];                                                             \
+            SMALL_UNROLL                                                                 \
+            for (int j = 0; j < N; j++) inv.m[i][j] /= d;                                \
+        }                                                                                \
+        *out = inv;                                                                      \
+        return true;                                                                     \
+    }                                                                                    \
+                                                                                         \
+    static inline MatrixError SmallMat##N##S##_FromMatrix(const Matrix* m,               \
+                                                          SmallMat##N##S* out) {         \
+        if (!m || !out) return MATRIX_ERROR_NULL_POINTER;                                \
+        if (m->type->id != FIELD) return MATRIX_ERROR_TYPE_MISMATCH;                     \
+        if (m->rows != N || m->cols != N) return MATRIX_ERROR_DIMENSION_MISMATCH;        \
+        memcpy(out->m, m->data, sizeof(out->m));                                         \
+        return MATRIX_OK;                                                                \
+    }                                                                                    \
+                                                                                         \
+    static inline Matrix* SmallMat##N##S##_ToMatrix(const SmallMat##N##S* s,             \
+                                                    MatrixError* error) {                \
+        if (error) *error = MATRIX_OK;                                                   \
+        if (!s) {                                                                        \
+            if (error) *error = MATRIX_ERROR_NULL_POINTER;                               \
+            return NULL;                                                                 \
+        }                                                                                \
+        Matrix* m = Matrix_Create(N, N, Field_Lookup(FIELD));                            \
+        if (!m) {                                                                        \
+            if (error) *error = MATRIX_ERROR_MEMORY;                                     \
+            return NULL;                                                                 \
+        }                                                                                \
+        memcpy(m->data, s->m, sizeof(s->m));                                             \
+        return m;                                                                        \
+    }
+
+SMALL_MATRIX_DEFINE(2, float, f, FIELD_ID_FLOAT)
+SMALL_MATRIX_DEFINE(3, float, f, FIELD_ID_FLOAT)
+SMALL_MATRIX_DEFINE(4, float, f, FIELD_ID_FLOAT)
+SMALL_MATRIX_DEFINE(5, float, f, FIELD_ID_FLOAT)
+SMALL_MATRIX_DEFINE(6, float, f, FIELD_ID_FLOAT)
+SMALL_MATRIX_DEFINE(7, float, f, FIELD_ID_FLOAT)
+SMALL_MATRIX_DEFINE(8, float, f, FIELD_ID_FLOAT)
+
+SMALL_MATRIX_DEFINE(2, double, d, FIELD_ID_DOUBLE)
+SMALL_MATRIX_DEFINE(3, double, d, FIELD_ID_DOUBLE)
+SMALL_MATRIX_DEFINE(4, double, d, FIELD_ID_DOUBLE)
+SMALL_MATRIX_DEFINE(5, double, d, FIELD_ID_DOUBLE)
+SMALL_MATRIX_DEFINE(6, double, d, FIELD_ID_DOUBLE)
+SMALL_MATRIX_DEFINE(7, double, d, FIELD_ID_DOUBLE)
+SMALL_MATRIX_DEFINE(8, double, d, FIELD_ID_DOUBLE)
+
+#endif
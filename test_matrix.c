@@ -2,10 +2,22 @@
 #include <time.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include "matrix.h"
 #include "field.h"         
 #include "int_field.h"      
 #include "float_field.h" 
+#include "half_field.h"
+#include "modular_field.h"
+#include "gf2_matrix.h"
+#include "semiring_field.h"
+#include "complex_field.h"
+#include "double_field.h"
+#include "int64_field.h"
+#include "small_matrix.h"
+#if (defined(MATRIX_ENABLE_STATS) || defined(MATRIX_ENABLE_TRACE)) && !defined(_WIN32)
+    #include <pthread.h>
+#endif
 
 static int tests_passed = 0;
 static int tests_failed = 0;
@@ -337,6 +349,1995 @@ void test_gauss_singular() {
     Matrix_Destroy(x);
 }
 
+//Счетчики операций (заполняются только при -DMATRIX_ENABLE_STATS)
+#if defined(MATRIX_ENABLE_STATS) && !defined(_WIN32)
+static void* stats_worker(void* arg) {
+    Matrix_Destroy(Matrix_Create(2, 2, GetIntFieldInfo()));
+    return arg;
+}
+#endif
+
+void test_stats() {
+    printf("\nTest 11 Operation Statistics:\n");
+    
+    Matrix_ResetStats();
+    
+    Matrix* a = Matrix_Create(4, 4, GetFloatFieldInfo());
+    Matrix* b = Matrix_Create(4, 4, GetFloatFieldInfo());
+    MatrixError err;
+    Matrix* c = Matrix_Multiply(a, b, &err);
+    
+    MatrixStats stats;
+    err = Matrix_GetStats(&stats);
+    TEST_ASSERT(err == MATRIX_OK, "Get statistics");
+    
+    if (stats.enabled) {
+        TEST_ASSERT(stats.ops[MATRIX_OP_CREATE].calls == 2, "Count Matrix_Create calls");
+        TEST_ASSERT(stats.ops[MATRIX_OP_MULTIPLY].calls == 1, "Count Matrix_Multiply calls");
+        TEST_ASSERT(stats.ops[MATRIX_OP_MULTIPLY].flops == 2 * 4 * 4 * 4, "Count Matrix_Multiply FLOPs");
+        TEST_ASSERT(stats.ops[MATRIX_OP_MULTIPLY].bytes_allocated == 4 * 4 * sizeof(float),
+                    "Attribute result allocation to Matrix_Multiply");
+        TEST_ASSERT(stats.peak_live_bytes >= 3 * 4 * 4 * sizeof(float), "Track peak live memory");
+#if defined(MATRIX_ENABLE_STATS) && !defined(_WIN32)
+        //Блок вышедшего потока переходит к следующему, его счетчики сохраняются
+        for (int i = 0; i < 8; i++) {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, stats_worker, NULL) == 0) pthread_join(thread, NULL);
+        }
+        Matrix_GetStats(&stats);
+        TEST_ASSERT(stats.ops[MATRIX_OP_CREATE].calls == 2 + 8, "Calls from exited threads are kept");
+#endif
+    } else {
+        TEST_ASSERT(stats.ops[MATRIX_OP_MULTIPLY].calls == 0, "Statistics compiled out");
+    }
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(c);
+}
+#ifdef MATRIX_ENABLE_TRACE
+static size_t count_substring(const char* text, const char* pattern) {
+    size_t count = 0;
+    for (const char* p = strstr(text, pattern); p; p = strstr(p + 1, pattern)) count++;
+    return count;
+}
+
+//ts и dur первого события name
+static bool span_interval(const char* dump, const char* name, double* ts, double* dur) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"name\":\"%s\",", name);
+    const char* p = strstr(dump, pattern);
+    if (p) p = strstr(p, "\"ts\":");
+    return p && sscanf(p, "\"ts\":%lf,\"dur\":%lf", ts, dur) == 2;
+}
+
+static char* trace_dump_text(void) {
+    FILE* f = tmpfile();
+    Matrix_TraceDump(f);
+    size_t bytes = (size_t)ftell(f);
+    char* dump = (char*)calloc(bytes + 1, 1);
+    rewind(f);
+    fread(dump, 1, bytes, f);
+    fclose(f);
+    return dump;
+}
+
+#ifndef _WIN32
+static void* trace_worker(void* arg) {
+    float value = 0.0f;
+    for (int i = 0; i < 10; i++) Matrix_Get((const Matrix*)arg, 0, 0, &value);
+    return NULL;
+}
+#endif
+#endif
+
+//Выгрузка трассы (события пишутся только при -DMATRIX_ENABLE_TRACE)
+void test_trace() {
+    printf("\nTest 12 Trace Export:\n");
+    
+    Matrix_TraceClear();
+    
+    Matrix* a = Matrix_Create(3, 3, GetFloatFieldInfo());
+    Matrix* b = Matrix_Create(3, 1, GetFloatFieldInfo());
+    Matrix* x = Matrix_Create(3, 1, GetFloatFieldInfo());
+    Matrix_Identity(a);
+    Matrix_GaussSolve(a, b, x);
+    
+    FILE* f = tmpfile();
+    MatrixError err = Matrix_TraceDump(f);
+    TEST_ASSERT(err == MATRIX_OK, "Dump trace");
+    
+    char buffer[32] = {0};
+    rewind(f);
+    fread(buffer, 1, 15, f);
+    TEST_ASSERT(strcmp(buffer, "{\"traceEvents\":") == 0, "Trace is Chrome trace-event JSON");
+    
+#ifdef MATRIX_ENABLE_TRACE
+    //Каждый интервал записан один раз, вложенные - внутри родителя
+    fseek(f, 0, SEEK_END);
+    size_t bytes = (size_t)ftell(f);
+    char* dump = (char*)calloc(bytes + 1, 1);
+    rewind(f);
+    fread(dump, 1, bytes, f);
+    TEST_ASSERT(count_substring(dump, "\"name\":\"Matrix_Identity\"") == 1 &&
+                count_substring(dump, "\"name\":\"Matrix_GaussSolve\"") == 1 &&
+                count_substring(dump, "\"name\":\"gauss_lu_factor\"") == 1 &&
+                count_substring(dump, "\"name\":\"gauss_back_substitution\"") == 1,
+                "Recorded spans are in the dump");
+    double solve_ts = 0.0, solve_dur = 0.0, factor_ts = 0.0, factor_dur = 0.0, back_ts = 0.0, back_dur = 0.0;
+    bool found = span_interval(dump, "Matrix_GaussSolve", &solve_ts, &solve_dur) &&
+                 span_interval(dump, "gauss_lu_factor", &factor_ts, &factor_dur) &&
+                 span_interval(dump, "gauss_back_substitution", &back_ts, &back_dur);
+    //Метки округлены до 1 нс
+    const double eps = 0.002;
+    TEST_ASSERT(found && factor_ts + eps >= solve_ts && back_ts + eps >= factor_ts + factor_dur &&
+                back_ts + back_dur <= solve_ts + solve_dur + eps, "Nested spans lie inside Matrix_GaussSolve");
+    free(dump);
+    
+    //Переполненное кольцо: слот, который пишется сейчас, не выводится
+    Matrix_TraceClear();
+    float value = 0.0f;
+    for (int i = 0; i < 70000; i++) Matrix_Get(a, 0, 0, &value);
+    dump = trace_dump_text();
+    TEST_ASSERT(count_substring(dump, "\"name\":\"Matrix_Get\"") == 65535, "Full ring keeps size - 1 events");
+    free(dump);
+#ifndef _WIN32
+    //Кольцо вышедшего потока достается следующему, его события сохраняются
+    Matrix_TraceClear();
+    dump = trace_dump_text();
+    size_t lanes = count_substring(dump, "\"ph\":\"M\"");
+    free(dump);
+    for (int i = 0; i < 8; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, trace_worker, a) == 0) pthread_join(thread, NULL);
+    }
+    dump = trace_dump_text();
+    TEST_ASSERT(count_substring(dump, "\"ph\":\"M\"") <= lanes + 1 &&
+                count_substring(dump, "\"name\":\"Matrix_Get\"") == 8 * 10,
+                "Rings of exited threads are reused and keep their events");
+    free(dump);
+#endif
+#endif
+    fclose(f);
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(x);
+}
+
+//2-байтовые типы и смешанные операции
+void test_half_fields() {
+    printf("\nTest 13 Half/BFloat16 Fields:\n");
+    
+    TEST_ASSERT(HalfToFloat(HalfFromFloat(1.5f)) == 1.5f, "half round trip 1.5");
+    TEST_ASSERT(BFloat16ToFloat(BFloat16FromFloat(-2.0f)) == -2.0f, "bfloat16 round trip -2.0");
+    
+    Matrix* a = Matrix_Create(2, 2, GetHalfFieldInfo());
+    Matrix* b = Matrix_Create(2, 2, GetBFloat16FieldInfo());
+    Matrix* f = Matrix_Create(2, 2, GetFloatFieldInfo());
+    
+    float a_vals[] = {1, 2, 3, 4};
+    float b_vals[] = {5, 6, 7, 8};
+    for (int i = 0; i < 4; i++) {
+        uint16_t h = HalfFromFloat(a_vals[i]);
+        uint16_t bf = BFloat16FromFloat(b_vals[i]);
+        Matrix_Set(a, i/2, i%2, &h);
+        Matrix_Set(b, i/2, i%2, &bf);
+        Matrix_Set(f, i/2, i%2, &b_vals[i]);
+    }
+    
+    MatrixError err;
+    Matrix* c = Matrix_Multiply(a, a, &err);
+    TEST_ASSERT(err == MATRIX_OK && c != NULL && c->type == GetHalfFieldInfo(),
+                "half x half gives half");
+    
+    float expected_aa[] = {7, 10, 15, 22};
+    int ok = 1;
+    for (int i = 0; i < 4; i++) {
+        uint16_t h;
+        Matrix_Get(c, i/2, i%2, &h);
+        if (HalfToFloat(h) != expected_aa[i]) ok = 0;
+    }
+    TEST_ASSERT(ok, "Check half product");
+    
+    Matrix* mixed = Matrix_Multiply(b, f, &err);
+    TEST_ASSERT(err == MATRIX_OK && mixed != NULL && mixed->type == GetFloatFieldInfo(),
+                "bfloat16 x float gives float");
+    
+    float expected_bf[] = {67, 78, 91, 106};
+    ok = 1;
+    for (int i = 0; i < 4; i++) {
+        float val;
+        Matrix_Get(mixed, i/2, i%2, &val);
+        if (val != expected_bf[i]) ok = 0;
+    }
+    TEST_ASSERT(ok, "Check mixed product");
+    
+    Matrix* bh = Matrix_Create(2, 1, GetHalfFieldInfo());
+    Matrix* xh = Matrix_Create(2, 1, GetHalfFieldInfo());
+    uint16_t rhs[] = {HalfFromFloat(5.0f), HalfFromFloat(11.0f)};
+    Matrix_Set(bh, 0, 0, &rhs[0]);
+    Matrix_Set(bh, 1, 0, &rhs[1]);
+    err = Matrix_GaussSolve(a, bh, xh);
+    uint16_t x0, x1;
+    Matrix_Get(xh, 0, 0, &x0);
+    Matrix_Get(xh, 1, 0, &x1);
+    TEST_ASSERT(err == MATRIX_OK && fabs(HalfToFloat(x0) - 1.0f) < 0.01f &&
+                fabs(HalfToFloat(x1) - 2.0f) < 0.01f, "Solve half system");
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(f);
+    Matrix_Destroy(c);
+    Matrix_Destroy(mixed);
+    Matrix_Destroy(bh);
+    Matrix_Destroy(xh);
+}
+
+//Квантованное умножение int8 против float
+void test_quantized_multiply() {
+    printf("\nTest 14 Quantized int8 Multiplication:\n");
+    
+    const int n = 37;
+    Matrix* a = Matrix_Create(n, n, GetFloatFieldInfo());
+    Matrix* b = Matrix_Create(n, n, GetFloatFieldInfo());
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            float va = (float)((i * 7 + j * 3) % 11) - 4.0f;
+            float vb = (float)((i * 5 + j * 2) % 13) * 0.5f;
+            Matrix_Set(a, i, j, &va);
+            Matrix_Set(b, i, j, &vb);
+        }
+    }
+    
+    MatrixError err;
+    QuantizedMatrix* qa = Matrix_Quantize(a, MATRIX_QUANT_PER_ROW, &err);
+    QuantizedMatrix* qb = Matrix_Quantize(b, MATRIX_QUANT_PER_COL, &err);
+    TEST_ASSERT(qa && qb && qa->values->type->size == 1, "Quantize to int8");
+    
+    Matrix* exact = Matrix_Multiply(a, b, &err);
+    Matrix* approx = Matrix_QuantizedMultiply(qa, qb, &err);
+    TEST_ASSERT(err == MATRIX_OK && approx != NULL, "Quantized multiply");
+    
+    float max_err = 0.0f, max_val = 0.0f;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            float e, q;
+            Matrix_Get(exact, i, j, &e);
+            Matrix_Get(approx, i, j, &q);
+            if (fabs(e - q) > max_err) max_err = fabs(e - q);
+            if (fabs(e) > max_val) max_val = fabs(e);
+        }
+    }
+    TEST_ASSERT(max_err < 0.02f * max_val, "Quantized result within 2% of float");
+    
+    Matrix* wrong = Matrix_QuantizedMultiply(qb, qa, &err);
+    TEST_ASSERT(wrong == NULL && err == MATRIX_ERROR_TYPE_MISMATCH, "Reject wrong quantization axes");
+    
+    QuantizedMatrix_Destroy(qa);
+    QuantizedMatrix_Destroy(qb);
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(exact);
+    Matrix_Destroy(approx);
+}
+
+//int-умножение с контролем переполнения
+void test_multiply_checked() {
+    printf("\nTest 15 Overflow-checked int Multiplication:\n");
+    
+    Matrix* a = Matrix_Create(2, 3, GetIntFieldInfo());
+    Matrix* b = Matrix_Create(3, 2, GetIntFieldInfo());
+    int a_vals[] = {1, 2, 3, 2147483647, 2147483647, 2147483647};
+    int b_vals[] = {7, 8, 9, 10, 11, -2147483647 - 1};
+    for (int i = 0; i < 6; i++) {
+        Matrix_Set(a, i/3, i%3, &a_vals[i]);
+        Matrix_Set(b, i/2, i%2, &b_vals[i]);
+    }
+    
+    MatrixError err;
+    MatrixOverflowReport report;
+    Matrix* c = Matrix_MultiplyChecked(a, b, MATRIX_OVERFLOW_ERROR, &report, &err);
+    TEST_ASSERT(c == NULL && err == MATRIX_ERROR_OVERFLOW, "Raise MATRIX_ERROR_OVERFLOW");
+    TEST_ASSERT(report.overflow_count == 3 && report.first_row == 0 && report.first_col == 1,
+                "Report overflowing elements");
+    
+    c = Matrix_MultiplyChecked(a, b, MATRIX_OVERFLOW_SATURATE, &report, &err);
+    TEST_ASSERT(err == MATRIX_OK && c != NULL, "Saturating multiply");
+    
+    int expected[] = {58, -2147483647 - 1, 2147483647, -2147483647 - 1};
+    for (int i = 0; i < 4; i++) {
+        int val;
+        Matrix_Get(c, i/2, i%2, &val);
+        TEST_ASSERT(val == expected[i], "Check saturated result");
+    }
+    Matrix_Destroy(c);
+    
+    int val;
+    Matrix* wrapped = Matrix_Multiply(a, b, &err);
+    Matrix_Get(wrapped, 1, 0, &val);
+    TEST_ASSERT(err == MATRIX_OK && val == (int)(unsigned)(2147483647u * 27u), "Plain multiply wraps modulo 2^32");
+    Matrix_Destroy(wrapped);
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+}
+
+void test_modular_field() {
+    printf("\nTest 16 Prime Field GF(p):\n");
+    
+    TEST_ASSERT(CreateModularFieldInfo(15) == NULL, "Reject composite modulus");
+    
+    const uint32_t p = 2147483647u;
+    const FieldInfo* gf = CreateModularFieldInfo(p);
+    TEST_ASSERT(gf != NULL && gf->size == sizeof(uint32_t), "Create GF(2^31 - 1)");
+    
+    uint32_t three = 3, one = 1, q;
+    gf->div(gf, &q, &one, &three);
+    gf->mul(gf, &q, &q, &three);
+    TEST_ASSERT(q == 1, "Division uses modular inverse");
+    
+    //Большие элементы: каждое произведение близко к p^2
+    size_t n = 24;
+    Matrix* a = Matrix_Create(n, n, gf);
+    Matrix* x = Matrix_Create(n, 1, gf);
+    srand(7);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            uint32_t v = p - 1 - (uint32_t)(rand() % 1000);
+            Matrix_Set(a, i, j, &v);
+        }
+        uint32_t v = (uint32_t)rand();
+        Matrix_Set(x, i, 0, &v);
+    }
+    
+    MatrixError err;
+    Matrix* b = Matrix_Multiply(a, x, &err);
+    bool match = (err == MATRIX_OK && b != NULL);
+    for (size_t i = 0; match && i < n; i++) {
+        uint64_t expected = 0;
+        for (size_t j = 0; j < n; j++) {
+            uint32_t aij, xj;
+            Matrix_Get(a, i, j, &aij);
+            Matrix_Get(x, j, 0, &xj);
+            expected = (expected + (uint64_t)aij * xj % p) % p;
+        }
+        uint32_t bi;
+        Matrix_Get(b, i, 0, &bi);
+        match = (bi == expected);
+    }
+    TEST_ASSERT(match, "Multiply with delayed reduction matches per-product % p");
+    
+    Matrix* solved = Matrix_Create(n, 1, gf);
+    err = Matrix_GaussSolve(a, b, solved);
+    match = (err == MATRIX_OK);
+    for (size_t i = 0; match && i < n; i++) {
+        uint32_t s, e;
+        Matrix_Get(solved, i, 0, &s);
+        Matrix_Get(x, i, 0, &e);
+        match = (s == e);
+    }
+    TEST_ASSERT(match, "Exact solve recovers x");
+    
+    Matrix* m = Matrix_Create(3, 3, gf);
+    uint32_t m_vals[] = {0, 1, 2, 3, 4, 5, 6, 7, 9};
+    for (int i = 0; i < 9; i++) Matrix_Set(m, i/3, i%3, &m_vals[i]);
+    uint32_t det = 0;
+    size_t rank = 0;
+    TEST_ASSERT(Matrix_ModularDeterminant(m, &det) == MATRIX_OK && det == p - 3,
+                "Determinant with row swap is -3 mod p");
+    TEST_ASSERT(Matrix_ModularRank(m, &rank) == MATRIX_OK && rank == 3, "Full rank");
+    
+    uint32_t last[] = {6, 9, 12};
+    for (int j = 0; j < 3; j++) Matrix_Set(m, 2, j, &last[j]);
+    Matrix_ModularRank(m, &rank);
+    Matrix_ModularDeterminant(m, &det);
+    TEST_ASSERT(rank == 2 && det == 0, "Dependent rows: rank 2, determinant 0");
+    TEST_ASSERT(Matrix_ModularRank(x, NULL) == MATRIX_ERROR_NULL_POINTER &&
+                Matrix_ModularDeterminant(x, &det) == MATRIX_ERROR_DIMENSION_MISMATCH,
+                "Argument checks");
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(x);
+    Matrix_Destroy(b);
+    Matrix_Destroy(solved);
+    Matrix_Destroy(m);
+    DestroyModularFieldInfo(gf);
+}
+
+//Значение BigInt по модулю простого p с учетом знака
+static uint32_t bigint_residue(const BigInt* x, uint32_t p) {
+    uint32_t r = bigint_mod_u32(x, p);
+    return (x->negative && r) ? p - r : r;
+}
+
+void test_exact_integer() {
+    printf("\nTest 17 Exact Integer Determinant and Solve (CRT):\n");
+    
+    Matrix* m = Matrix_Create(3, 3, GetIntFieldInfo());
+    int m_vals[] = {0, 1, 2, 3, 4, 5, 6, 7, 9};
+    for (int i = 0; i < 9; i++) Matrix_Set(m, i/3, i%3, &m_vals[i]);
+    
+    BigInt det;
+    BigInt_Init(&det);
+    int64_t value = 0;
+    TEST_ASSERT(Matrix_DeterminantExact(m, &det) == MATRIX_OK && BigInt_ToInt64(&det, &value) && value == -3,
+                "Small determinant is -3");
+    
+    //2x + y = 3, x + 3y = 5 -> x = 4/5, y = 7/5 (int Gauss дал бы 0 и 1)
+    Matrix* a = Matrix_Create(2, 2, GetIntFieldInfo());
+    Matrix* b = Matrix_Create(2, 1, GetIntFieldInfo());
+    int a_vals[] = {2, 1, 1, 3};
+    int b_vals[] = {3, 5};
+    for (int i = 0; i < 4; i++) Matrix_Set(a, i/2, i%2, &a_vals[i]);
+    for (int i = 0; i < 2; i++) Matrix_Set(b, i, 0, &b_vals[i]);
+    
+    BigInt num[2], den;
+    BigInt_Init(&num[0]);
+    BigInt_Init(&num[1]);
+    BigInt_Init(&den);
+    int64_t x0 = 0, x1 = 0, d = 0;
+    MatrixError err = Matrix_SolveExact(a, b, num, &den);
+    TEST_ASSERT(err == MATRIX_OK && BigInt_ToInt64(&num[0], &x0) && BigInt_ToInt64(&num[1], &x1) &&
+                BigInt_ToInt64(&den, &d) && x0 == 4 && x1 == 7 && d == 5,
+                "Rational solution 4/5, 7/5");
+    
+    int singular_vals[] = {1, 2, 2, 4};
+    for (int i = 0; i < 4; i++) Matrix_Set(a, i/2, i%2, &singular_vals[i]);
+    TEST_ASSERT(Matrix_SolveExact(a, b, num, &den) == MATRIX_ERROR_SINGULAR_MATRIX, "Detect singular system");
+    
+    //Определитель далеко за пределами int64: сверка с GF(q) для независимого q
+    size_t n = 30;
+    Matrix* big = Matrix_Create(n, n, GetIntFieldInfo());
+    Matrix* rhs = Matrix_Create(n, 1, GetIntFieldInfo());
+    srand(11);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            int v = rand() % 2000001 - 1000000;
+            Matrix_Set(big, i, j, &v);
+        }
+        int v = rand() % 2001 - 1000;
+        Matrix_Set(rhs, i, 0, &v);
+    }
+    
+    err = Matrix_DeterminantExact(big, &det);
+    TEST_ASSERT(err == MATRIX_OK && BigInt_Bits(&det) > 500, "Large determinant computed");
+    
+    const uint32_t q = 1000003;
+    const FieldInfo* gf = CreateModularFieldInfo(q);
+    Matrix* big_q = Matrix_Create(n, n, gf);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            int v;
+            Matrix_Get(big, i, j, &v);
+            uint32_t r = (uint32_t)((v % (int)q + (int)q) % (int)q);
+            Matrix_Set(big_q, i, j, &r);
+        }
+    }
+    uint32_t det_q = 0;
+    Matrix_ModularDeterminant(big_q, &det_q);
+    TEST_ASSERT(bigint_residue(&det, q) == det_q, "Determinant agrees modulo an independent prime");
+    
+    BigInt* nums = (BigInt*)malloc(n * sizeof(BigInt));
+    for (size_t i = 0; i < n; i++) BigInt_Init(&nums[i]);
+    err = Matrix_SolveExact(big, rhs, nums, &den);
+    
+    //A * numerators == denominator * b по модулю q
+    bool match = (err == MATRIX_OK);
+    for (size_t i = 0; match && i < n; i++) {
+        uint64_t lhs = 0;
+        for (size_t j = 0; j < n; j++) {
+            uint32_t aij;
+            Matrix_Get(big_q, i, j, &aij);
+            lhs = (lhs + (uint64_t)aij * bigint_residue(&nums[j], q)) % q;
+        }
+        int bi;
+        Matrix_Get(rhs, i, 0, &bi);
+        uint64_t rhs_q = (uint64_t)((bi % (int)q + (int)q) % (int)q) * bigint_residue(&den, q) % q;
+        match = (lhs == rhs_q);
+    }
+    TEST_ASSERT(match, "A * numerators == denominator * b");
+    
+    for (size_t i = 0; i < n; i++) BigInt_Free(&nums[i]);
+    free(nums);
+    BigInt_Free(&num[0]);
+    BigInt_Free(&num[1]);
+    BigInt_Free(&den);
+    BigInt_Free(&det);
+    Matrix_Destroy(m);
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(big);
+    Matrix_Destroy(rhs);
+    Matrix_Destroy(big_q);
+    DestroyModularFieldInfo(gf);
+}
+
+void test_bareiss() {
+    printf("\nTest 18 Fraction-free Bareiss Elimination (int):\n");
+    
+    //x + 2y + z = 8, 2x + y + 3z = 13, 3x + 4y + 2z = 17 -> (1, 2, 3)
+    Matrix* a = Matrix_Create(3, 3, GetIntFieldInfo());
+    Matrix* b = Matrix_Create(3, 1, GetIntFieldInfo());
+    Matrix* x = Matrix_Create(3, 1, GetIntFieldInfo());
+    int a_vals[] = {1, 2, 1, 2, 1, 3, 3, 4, 2};
+    int b_vals[] = {8, 13, 17};
+    for (int i = 0; i < 9; i++) Matrix_Set(a, i/3, i%3, &a_vals[i]);
+    for (int i = 0; i < 3; i++) Matrix_Set(b, i, 0, &b_vals[i]);
+    
+    MatrixError err = Matrix_GaussSolve(a, b, x);
+    int x0, x1, x2;
+    Matrix_Get(x, 0, 0, &x0);
+    Matrix_Get(x, 1, 0, &x1);
+    Matrix_Get(x, 2, 0, &x2);
+    TEST_ASSERT(err == MATRIX_OK && x0 == 1 && x1 == 2 && x2 == 3, "int Gauss is exact");
+    
+    int odd = 14;
+    Matrix_Set(b, 1, 0, &odd);
+    TEST_ASSERT(Matrix_GaussSolve(a, b, x) == MATRIX_ERROR_INEXACT, "Non-integer solution reported");
+    
+    int64_t num[3], den = 0, det = 0;
+    err = Matrix_BareissSolve(a, b, num, &den);
+    //det = 5, x = (5, 9, 17) / 5 при b = (8, 14, 17)
+    TEST_ASSERT(err == MATRIX_OK && den == 5 && num[0] == 5 && num[1] == 9 && num[2] == 17,
+                "Scaled solution with common denominator");
+    
+    //Сверка с КТО на матрице, где определитель занимает почти весь int64
+    size_t n = 8;
+    Matrix* m = Matrix_Create(n, n, GetIntFieldInfo());
+    srand(5);
+    for (size_t i = 0; i < n * n; i++) {
+        int v = rand() % 201 - 100;
+        Matrix_Set(m, i / n, i % n, &v);
+    }
+    BigInt exact;
+    BigInt_Init(&exact);
+    int64_t exact_value = 0;
+    Matrix_DeterminantExact(m, &exact);
+    err = Matrix_BareissDeterminant(m, &det);
+    TEST_ASSERT(err == MATRIX_OK && BigInt_ToInt64(&exact, &exact_value) && det == exact_value,
+                "Determinant matches CRT result");
+    BigInt_Free(&exact);
+    
+    Matrix* big = Matrix_Create(20, 20, GetIntFieldInfo());
+    for (size_t i = 0; i < 400; i++) {
+        int v = rand() % 2000001 - 1000000;
+        Matrix_Set(big, i / 20, i % 20, &v);
+    }
+    TEST_ASSERT(Matrix_BareissDeterminant(big, &det) == MATRIX_ERROR_OVERFLOW, "Report int64 overflow");
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(x);
+    Matrix_Destroy(m);
+    Matrix_Destroy(big);
+}
+
+static GF2Matrix* random_gf2(size_t rows, size_t cols) {
+    GF2Matrix* m = GF2Matrix_Create(rows, cols);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) GF2Matrix_Set(m, i, j, rand() & 1);
+    }
+    return m;
+}
+
+void test_gf2_matrix() {
+    printf("\nTest 19 Bit-packed GF(2) Matrices:\n");
+    srand(3);
+    
+    //Размеры не кратны 64 и 8, чтобы проверить хвосты слов и неполные группы
+    GF2Matrix* a = random_gf2(70, 131);
+    GF2Matrix* b = random_gf2(131, 67);
+    MatrixError err;
+    GF2Matrix* c = GF2Matrix_Multiply(a, b, &err);
+    
+    Matrix* ai = GF2Matrix_ToMatrix(a, &err);
+    Matrix* bi = GF2Matrix_ToMatrix(b, &err);
+    Matrix* ci = Matrix_Multiply(ai, bi, &err);
+    bool match = (c != NULL && ci != NULL);
+    for (size_t i = 0; match && i < 70; i++) {
+        for (size_t j = 0; match && j < 67; j++) {
+            int bit, val;
+            GF2Matrix_Get(c, i, j, &bit);
+            Matrix_Get(ci, i, j, &val);
+            match = (bit == (val & 1));
+        }
+    }
+    TEST_ASSERT(match, "M4RM multiply matches int multiply mod 2");
+    
+    GF2Matrix* back = GF2Matrix_FromMatrix(ai, &err);
+    TEST_ASSERT(err == MATRIX_OK && memcmp(back->words, a->words, 70 * a->stride * sizeof(uint64_t)) == 0,
+                "Round trip through int Matrix");
+    
+    //A = L * U с единичными диагоналями невырождена
+    size_t n = 100;
+    GF2Matrix* l = GF2Matrix_Create(n, n);
+    GF2Matrix* u = GF2Matrix_Create(n, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            GF2Matrix_Set(l, i, j, i == j || (j < i && (rand() & 1)));
+            GF2Matrix_Set(u, i, j, i == j || (j > i && (rand() & 1)));
+        }
+    }
+    GF2Matrix* sq = GF2Matrix_Multiply(l, u, &err);
+    size_t rank = 0;
+    TEST_ASSERT(GF2Matrix_Rank(sq, &rank) == MATRIX_OK && rank == n, "Full rank of L*U");
+    
+    GF2Matrix* x = random_gf2(n, 3);
+    GF2Matrix* rhs = GF2Matrix_Multiply(sq, x, &err);
+    GF2Matrix* solved = GF2Matrix_Create(n, 3);
+    err = GF2Matrix_Solve(sq, rhs, solved);
+    TEST_ASSERT(err == MATRIX_OK && memcmp(solved->words, x->words, n * x->stride * sizeof(uint64_t)) == 0,
+                "M4RI solve with three right-hand sides");
+    
+    //Строка 1 = строка 0 + строка 2: ранг падает на 1
+    for (size_t j = 0; j < n; j++) {
+        int r0, r2;
+        GF2Matrix_Get(sq, 0, j, &r0);
+        GF2Matrix_Get(sq, 2, j, &r2);
+        GF2Matrix_Set(sq, 1, j, r0 ^ r2);
+    }
+    GF2Matrix_Rank(sq, &rank);
+    TEST_ASSERT(rank == n - 1, "Dependent row lowers rank");
+    TEST_ASSERT(GF2Matrix_Solve(sq, rhs, solved) == MATRIX_ERROR_SINGULAR_MATRIX, "Singular system detected");
+    
+    GF2Matrix_Destroy(a);
+    GF2Matrix_Destroy(b);
+    GF2Matrix_Destroy(c);
+    GF2Matrix_Destroy(back);
+    GF2Matrix_Destroy(l);
+    GF2Matrix_Destroy(u);
+    GF2Matrix_Destroy(sq);
+    GF2Matrix_Destroy(x);
+    GF2Matrix_Destroy(rhs);
+    GF2Matrix_Destroy(solved);
+    Matrix_Destroy(ai);
+    Matrix_Destroy(bi);
+    Matrix_Destroy(ci);
+}
+
+void test_semirings() {
+    printf("\nTest 20 Min-plus and Boolean Semirings:\n");
+    
+    const FieldInfo* mp = GetMinPlusFieldInfo();
+    Matrix* id = Matrix_Create(3, 3, mp);
+    float corner;
+    Matrix_Get(id, 0, 1, &corner);
+    TEST_ASSERT(isinf(corner), "New min-plus matrix is filled with +inf");
+    Matrix_Identity(id);
+    Matrix_Get(id, 1, 1, &corner);
+    TEST_ASSERT(corner == 0.0f, "Min-plus identity has 0 on the diagonal");
+    
+    //Случайный орграф на 150 вершинах (больше одного блока), сверка с простым Флойдом
+    size_t n = 150;
+    Matrix* g = Matrix_Create(n, n, mp);
+    float* ref = (float*)malloc(n * n * sizeof(float));
+    srand(13);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            float w = (i != j && rand() % 10 == 0) ? (float)(rand() % 100 + 1) : INFINITY;
+            if (i == j) w = 0.0f;
+            Matrix_Set(g, i, j, &w);
+            ref[i * n + j] = w;
+        }
+    }
+    for (size_t k = 0; k < n; k++) {
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                float s = ref[i * n + k] + ref[k * n + j];
+                if (s < ref[i * n + j]) ref[i * n + j] = s;
+            }
+        }
+    }
+    
+    MatrixError err;
+    Matrix* dist = Matrix_Closure(g, &err);
+    bool match = (err == MATRIX_OK && dist != NULL);
+    for (size_t i = 0; match && i < n * n; i++) match = (((float*)dist->data)[i] == ref[i]);
+    TEST_ASSERT(match, "Blocked closure equals Floyd-Warshall");
+    
+    //Путь из двух ребер: (G * G)[i][j] = min_k g[i][k] + g[k][j]
+    Matrix* g2 = Matrix_Multiply(g, g, &err);
+    float expected = INFINITY;
+    for (size_t k = 0; k < n; k++) {
+        float s = ((float*)g->data)[3 * n + k] + ((float*)g->data)[k * n + 7];
+        if (s < expected) expected = s;
+    }
+    float got;
+    Matrix_Get(g2, 3, 7, &got);
+    TEST_ASSERT(err == MATRIX_OK && got == expected, "Min-plus multiply");
+    
+    //Цепочка 0 -> 1 -> 2, вершина 3 изолирована
+    const FieldInfo* bt = GetBoolFieldInfo();
+    Matrix* r = Matrix_Create(4, 4, bt);
+    uint8_t one = 1;
+    Matrix_Set(r, 0, 1, &one);
+    Matrix_Set(r, 1, 2, &one);
+    Matrix* reach = Matrix_Closure(r, &err);
+    uint8_t r02, r20, r33, r03;
+    Matrix_Get(reach, 0, 2, &r02);
+    Matrix_Get(reach, 2, 0, &r20);
+    Matrix_Get(reach, 3, 3, &r33);
+    Matrix_Get(reach, 0, 3, &r03);
+    TEST_ASSERT(err == MATRIX_OK && r02 == 1 && r20 == 0 && r33 == 1 && r03 == 0, "Boolean reachability");
+    
+    Matrix* x = Matrix_Create(4, 1, bt);
+    TEST_ASSERT(Matrix_GaussSolve(r, x, x) == MATRIX_ERROR_TYPE_MISMATCH, "Gauss rejects semirings");
+    
+    //Описание без zero и one: нуль - нулевые байты, единичной матрицы нет
+    FieldInfo legacy = *GetIntFieldInfo();
+    strcpy(legacy.name, "legacy_int");
+    legacy.zero = NULL;
+    legacy.one = NULL;
+    legacy.id = FIELD_ID_NONE;
+    Matrix* la = Matrix_Create(2, 2, &legacy);
+    int la_values[] = {1, 2, 3, 4};
+    memcpy(la->data, la_values, sizeof(la_values));
+    Matrix* lp = Matrix_Multiply(la, la, &err);
+    int lp00 = 0, lp11 = 0;
+    Matrix_Get(lp, 0, 0, &lp00);
+    Matrix_Get(lp, 1, 1, &lp11);
+    TEST_ASSERT(lp && lp00 == 7 && lp11 == 22, "Type without zero multiplies");
+    TEST_ASSERT(Matrix_Identity(la) == MATRIX_ERROR_TYPE_MISMATCH, "Identity needs one");
+    Matrix* l0 = Matrix_Power(la, 0, &err);
+    TEST_ASSERT(!l0 && err == MATRIX_ERROR_TYPE_MISMATCH, "Power 0 needs one");
+    
+    //Нуль шире 16 байт копируется целиком
+    static const double wide_zero[4] = {1.0, 2.0, 3.0, 4.0};
+    FieldInfo wide = legacy;
+    strcpy(wide.name, "wide4");
+    wide.size = sizeof(wide_zero);
+    wide.zero = wide_zero;
+    Matrix* w = Matrix_Create(3, 3, &wide);
+    TEST_ASSERT(w && memcmp((char*)w->data + 8 * sizeof(wide_zero), wide_zero, sizeof(wide_zero)) == 0,
+                "Zero wider than 16 bytes fills the matrix");
+    Matrix_Destroy(la);
+    Matrix_Destroy(lp);
+    Matrix_Destroy(w);
+    
+    free(ref);
+    Matrix_Destroy(id);
+    Matrix_Destroy(g);
+    Matrix_Destroy(dist);
+    Matrix_Destroy(g2);
+    Matrix_Destroy(r);
+    Matrix_Destroy(reach);
+    Matrix_Destroy(x);
+}
+
+static ComplexFloat random_complex(void) {
+    ComplexFloat z = {(float)(rand() % 200 - 100) / 50.0f, (float)(rand() % 200 - 100) / 50.0f};
+    return z;
+}
+
+void test_complex_field() {
+    printf("\nTest 21 Complex Field (interleaved and split):\n");
+    
+    const FieldInfo* ct = GetComplexFieldInfo();
+    size_t m = 37, k = 29, n = 41;
+    Matrix* a = Matrix_Create(m, k, ct);
+    Matrix* b = Matrix_Create(k, n, ct);
+    srand(21);
+    for (size_t i = 0; i < m * k; i++) ((ComplexFloat*)a->data)[i] = random_complex();
+    for (size_t i = 0; i < k * n; i++) ((ComplexFloat*)b->data)[i] = random_complex();
+    
+    //Эталон в double
+    MatrixError err;
+    Matrix* c = Matrix_Multiply(a, b, &err);
+    double max_diff = 0.0;
+    for (size_t i = 0; c && i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double re = 0.0, im = 0.0;
+            for (size_t p = 0; p < k; p++) {
+                ComplexFloat x = ((ComplexFloat*)a->data)[i * k + p];
+                ComplexFloat y = ((ComplexFloat*)b->data)[p * n + j];
+                re += (double)x.re * y.re - (double)x.im * y.im;
+                im += (double)x.re * y.im + (double)x.im * y.re;
+            }
+            ComplexFloat got = ((ComplexFloat*)c->data)[i * n + j];
+            max_diff = fmax(max_diff, fmax(fabs(got.re - re), fabs(got.im - im)));
+        }
+    }
+    TEST_ASSERT(err == MATRIX_OK && max_diff < 1e-3, "Interleaved complex multiply (4M)");
+    
+    SplitComplexMatrix* sa = Matrix_ToSplitComplex(a, &err);
+    SplitComplexMatrix* sb = Matrix_ToSplitComplex(b, NULL);
+    SplitComplexMatrix* sc = SplitComplexMatrix_Multiply(sa, sb, &err);
+    Matrix* c3 = SplitComplexMatrix_ToMatrix(sc, NULL);
+    double split_diff = 0.0;
+    for (size_t i = 0; c && c3 && i < m * n; i++) {
+        ComplexFloat x = ((ComplexFloat*)c->data)[i];
+        ComplexFloat y = ((ComplexFloat*)c3->data)[i];
+        split_diff = fmax(split_diff, fmax(fabs(x.re - y.re), fabs(x.im - y.im)));
+    }
+    TEST_ASSERT(err == MATRIX_OK && c3 != NULL && split_diff < 1e-3, "Split complex multiply (3M) matches 4M");
+    
+    Matrix* back = SplitComplexMatrix_ToMatrix(sa, NULL);
+    TEST_ASSERT(back && memcmp(back->data, a->data, m * k * sizeof(ComplexFloat)) == 0,
+                "Split layout round trip");
+    
+    //Нулевой a[0][0]: без перестановки по модулю деление на ноль
+    Matrix* sys = Matrix_Create(2, 2, ct);
+    Matrix* rhs = Matrix_Create(2, 1, ct);
+    Matrix* sol = Matrix_Create(2, 1, ct);
+    ComplexFloat a01 = {0.0f, 1.0f}, a10 = {1.0f, 1.0f}, a11 = {2.0f, 0.0f};
+    Matrix_Set(sys, 0, 1, &a01);
+    Matrix_Set(sys, 1, 0, &a10);
+    Matrix_Set(sys, 1, 1, &a11);
+    //x = (1 + 2i, 3 - i): b0 = i * (3 - i) = 1 + 3i, b1 = (1 + i)(1 + 2i) + 2(3 - i) = 5 + i
+    ComplexFloat b0 = {1.0f, 3.0f}, b1 = {5.0f, 1.0f};
+    Matrix_Set(rhs, 0, 0, &b0);
+    Matrix_Set(rhs, 1, 0, &b1);
+    err = Matrix_GaussSolve(sys, rhs, sol);
+    ComplexFloat x0, x1;
+    Matrix_Get(sol, 0, 0, &x0);
+    Matrix_Get(sol, 1, 0, &x1);
+    TEST_ASSERT(err == MATRIX_OK && fabsf(x0.re - 1.0f) < 1e-5f && fabsf(x0.im - 2.0f) < 1e-5f &&
+                fabsf(x1.re - 3.0f) < 1e-5f && fabsf(x1.im + 1.0f) < 1e-5f,
+                "Complex Gauss pivots by magnitude");
+    
+    ComplexFloat twice_a10 = {2.0f, 2.0f}, twice_a11 = {4.0f, 0.0f};
+    Matrix_Set(sys, 0, 0, &twice_a10);
+    Matrix_Set(sys, 0, 1, &twice_a11);
+    TEST_ASSERT(Matrix_GaussSolve(sys, rhs, sol) == MATRIX_ERROR_SINGULAR_MATRIX, "Complex singular detection");
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(c);
+    Matrix_Destroy(c3);
+    Matrix_Destroy(back);
+    SplitComplexMatrix_Destroy(sa);
+    SplitComplexMatrix_Destroy(sb);
+    SplitComplexMatrix_Destroy(sc);
+    Matrix_Destroy(sys);
+    Matrix_Destroy(rhs);
+    Matrix_Destroy(sol);
+}
+
+void test_wide_fields() {
+    printf("\nTest 22 Double and Int64 Fields:\n");
+    
+    const FieldInfo* dt = GetDoubleFieldInfo();
+    size_t n = 300;
+    Matrix* a = Matrix_Create(n, n, dt);
+    Matrix* x_true = Matrix_Create(n, 1, dt);
+    srand(22);
+    for (size_t i = 0; i < n * n; i++) ((double*)a->data)[i] = (double)(rand() % 2001 - 1000) / 1000.0;
+    for (size_t i = 0; i < n; i++) ((double*)x_true->data)[i] = 1.0 + (double)i / n;
+    
+    MatrixError err;
+    Matrix* b = Matrix_Multiply(a, x_true, &err);
+    double max_diff = 0.0;
+    for (size_t i = 0; b && i < n; i++) {
+        double ref = 0.0;
+        for (size_t j = 0; j < n; j++) ref += ((double*)a->data)[i * n + j] * ((double*)x_true->data)[j];
+        max_diff = fmax(max_diff, fabs(((double*)b->data)[i] - ref));
+    }
+    TEST_ASSERT(err == MATRIX_OK && max_diff < 1e-10, "Double multiply");
+    
+    Matrix* x = Matrix_Create(n, 1, dt);
+    err = Matrix_GaussSolve(a, b, x);
+    double max_err = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        max_err = fmax(max_err, fabs(((double*)x->data)[i] - ((double*)x_true->data)[i]));
+    }
+    TEST_ASSERT(err == MATRIX_OK && max_err < 1e-9, "Double Gauss 300x300 accurate to 1e-9");
+    
+    double two = 2.0;
+    Matrix* doubled = Matrix_ScalarMultiply(x_true, &two, NULL);
+    Matrix* summed = Matrix_Add(x_true, x_true, NULL);
+    TEST_ASSERT(doubled && summed && memcmp(doubled->data, summed->data, n * sizeof(double)) == 0,
+                "Double add and scalar multiply");
+    
+    //0 * Inf и 0 * NaN дают NaN, как в float и в общем пути
+    Matrix* zero_row = Matrix_Create(1, 2, dt);
+    Matrix* special = Matrix_Create(2, 2, dt);
+    double special_vals[4] = {INFINITY, NAN, 1.0, 1.0};
+    memcpy(special->data, special_vals, sizeof(special_vals));
+    Matrix* nan_row = Matrix_Multiply(zero_row, special, &err);
+    TEST_ASSERT(err == MATRIX_OK && isnan(((double*)nan_row->data)[0]) && isnan(((double*)nan_row->data)[1]),
+                "Double multiply propagates 0 * Inf and 0 * NaN");
+    Matrix_Destroy(zero_row);
+    Matrix_Destroy(special);
+    Matrix_Destroy(nan_row);
+    
+    //Значения за пределами int: произведение 3e9 * 3e9 помещается только в int64
+    const FieldInfo* lt = GetInt64FieldInfo();
+    Matrix* big = Matrix_Create(2, 2, lt);
+    int64_t vals[4] = {3000000000LL, 1, -2, 5};
+    for (int i = 0; i < 4; i++) Matrix_Set(big, i / 2, i % 2, &vals[i]);
+    Matrix* sq = Matrix_Multiply(big, big, &err);
+    int64_t s00, s01;
+    Matrix_Get(sq, 0, 0, &s00);
+    Matrix_Get(sq, 0, 1, &s01);
+    TEST_ASSERT(err == MATRIX_OK && s00 == 9000000000000000000LL - 2 && s01 == 3000000005LL, "Int64 multiply");
+    
+    //A x = b с x = (4000000000, -7)
+    Matrix* rhs = Matrix_Create(2, 1, lt);
+    Matrix* sol = Matrix_Create(2, 1, lt);
+    int64_t a00 = 3000;
+    int64_t r0 = 3000 * 4000000000LL - 7, r1 = -2 * 4000000000LL - 35;
+    Matrix_Set(big, 0, 0, &a00);
+    Matrix_Set(rhs, 0, 0, &r0);
+    Matrix_Set(rhs, 1, 0, &r1);
+    err = Matrix_GaussSolve(big, rhs, sol);
+    int64_t x0, x1;
+    Matrix_Get(sol, 0, 0, &x0);
+    Matrix_Get(sol, 1, 0, &x1);
+    TEST_ASSERT(err == MATRIX_OK && x0 == 4000000000LL && x1 == -7, "Int64 Gauss is exact");
+    
+    //Единица и нуль берутся из описания типа
+    Matrix* id = Matrix_Create(3, 3, dt);
+    Matrix_Identity(id);
+    double d11, d12;
+    Matrix_Get(id, 1, 1, &d11);
+    Matrix_Get(id, 1, 2, &d12);
+    TEST_ASSERT(d11 == 1.0 && d12 == 0.0, "Double identity");
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(x_true);
+    Matrix_Destroy(b);
+    Matrix_Destroy(x);
+    Matrix_Destroy(doubled);
+    Matrix_Destroy(summed);
+    Matrix_Destroy(big);
+    Matrix_Destroy(sq);
+    Matrix_Destroy(rhs);
+    Matrix_Destroy(sol);
+    Matrix_Destroy(id);
+}
+
+void test_refined_solve() {
+    printf("\nTest 23 Mixed-Precision Iterative Refinement:\n");
+    
+    const FieldInfo* dt = GetDoubleFieldInfo();
+    size_t n = 200;
+    Matrix* a = Matrix_Create(n, n, dt);
+    Matrix* x_true = Matrix_Create(n, 1, dt);
+    srand(23);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            ((double*)a->data)[i * n + j] = (double)rand() / RAND_MAX - 0.5 + (i == j ? 10.0 : 0.0);
+        }
+        ((double*)x_true->data)[i] = sin((double)i);
+    }
+    MatrixError err;
+    Matrix* b = Matrix_Multiply(a, x_true, &err);
+    Matrix* x = Matrix_Create(n, 1, dt);
+    
+    MatrixRefineReport report;
+    err = Matrix_SolveRefined(a, b, x, NULL, &report);
+    double max_err = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        max_err = fmax(max_err, fabs(((double*)x->data)[i] - ((double*)x_true->data)[i]));
+    }
+    TEST_ASSERT(err == MATRIX_OK && !report.fell_back && report.iterations >= 1 &&
+                report.backward_error < 1e-15 && max_err < 1e-12,
+                "Float factors refined to double accuracy");
+    
+    err = Matrix_SolveRefined(a, b, x, GetBFloat16FieldInfo(), &report);
+    TEST_ASSERT(err == MATRIX_OK && !report.fell_back && report.backward_error < 1e-15,
+                "Bfloat16 factors converge");
+    
+    //Гильберт 12x12: число обусловленности ~1e16, float-множители бесполезны
+    size_t h = 12;
+    Matrix* hilbert = Matrix_Create(h, h, dt);
+    Matrix* hb = Matrix_Create(h, 1, dt);
+    Matrix* hx = Matrix_Create(h, 1, dt);
+    for (size_t i = 0; i < h; i++) {
+        double sum = 0.0;
+        for (size_t j = 0; j < h; j++) {
+            ((double*)hilbert->data)[i * h + j] = 1.0 / (double)(i + j + 1);
+            sum += 1.0 / (double)(i + j + 1);
+        }
+        ((double*)hb->data)[i] = sum;
+    }
+    err = Matrix_SolveRefined(hilbert, hb, hx, NULL, &report);
+    TEST_ASSERT(err == MATRIX_OK && report.fell_back && report.backward_error < 1e-14,
+                "Divergent refinement falls back to double");
+    
+    Matrix* fa = Matrix_Create(2, 2, GetFloatFieldInfo());
+    Matrix* fb = Matrix_Create(2, 1, GetFloatFieldInfo());
+    TEST_ASSERT(Matrix_SolveRefined(fa, fb, fb, NULL, NULL) == MATRIX_ERROR_TYPE_MISMATCH,
+                "Refinement requires double system");
+    
+    Matrix_Destroy(a);
+    Matrix_Destroy(x_true);
+    Matrix_Destroy(b);
+    Matrix_Destroy(x);
+    Matrix_Destroy(hilbert);
+    Matrix_Destroy(hb);
+    Matrix_Destroy(hx);
+    Matrix_Destroy(fa);
+    Matrix_Destroy(fb);
+}
+
+void test_field_registry() {
+    printf("\nTest 24 Field Registry and Type IDs:\n");
+    
+    TEST_ASSERT(GetIntFieldInfo()->id == FIELD_ID_INT && GetDoubleFieldInfo()->id == FIELD_ID_DOUBLE &&
+                Field_Lookup(FIELD_ID_COMPLEX) == GetComplexFieldInfo(), "Built-in types have static IDs");
+    
+    //Одновременный первый вызов из нескольких потоков дает один и тот же адрес
+    const FieldInfo* seen[64];
+    #pragma omp parallel for
+    for (int i = 0; i < 64; i++) seen[i] = (i % 2) ? GetFloatFieldInfo() : GetHalfFieldInfo();
+    bool same = true;
+    for (int i = 0; i < 64; i++) same &= (seen[i] == ((i % 2) ? GetFloatFieldInfo() : GetHalfFieldInfo()));
+    TEST_ASSERT(same, "Concurrent lookups return the same descriptor");
+    
+    const FieldInfo* gf7 = CreateModularFieldInfo(7);
+    const FieldInfo* gf7_again = CreateModularFieldInfo(7);
+    const FieldInfo* gf11 = CreateModularFieldInfo(11);
+    TEST_ASSERT(FieldInfo_Equals(gf7, gf7_again) && !FieldInfo_Equals(gf7, gf11),
+                "GF(p) types compare by ID and modulus");
+    
+    //Пользовательский тип: копия int под другим именем
+    static FieldInfo custom;
+    static FieldInfo custom_twin;
+    custom = *GetIntFieldInfo();
+    strcpy(custom.name, "myint");
+    custom.id = FIELD_ID_NONE;
+    custom_twin = custom;
+    uint32_t id = Field_Register(&custom);
+    uint32_t twin_id = Field_Register(&custom_twin);
+    TEST_ASSERT(id >= FIELD_ID_BUILTIN_COUNT && twin_id == id && Field_Lookup(id) == &custom &&
+                Field_Register(&custom) == id, "Field_Register assigns one ID per type");
+    
+    //Потоки одновременно регистрируют одно описание и его копии с тем же именем
+    static FieldInfo raced;
+    static FieldInfo raced_twins[8];
+    raced = *GetIntFieldInfo();
+    strcpy(raced.name, "racedint");
+    raced.id = FIELD_ID_NONE;
+    for (int i = 0; i < 8; i++) raced_twins[i] = raced;
+    uint32_t raced_ids[64];
+    #pragma omp parallel for num_threads(8)
+    for (int i = 0; i < 64; i++) raced_ids[i] = Field_Register((i % 2) ? &raced : &raced_twins[(i / 2) % 8]);
+    bool one_id = raced_ids[0] >= FIELD_ID_BUILTIN_COUNT && raced.id == raced_ids[0];
+    for (int i = 0; i < 64; i++) one_id &= raced_ids[i] == raced_ids[0];
+    for (int i = 0; i < 8; i++) one_id &= raced_twins[i].id == raced_ids[0];
+    TEST_ASSERT(one_id && FieldInfo_Equals(Field_Lookup(raced_ids[0]), &raced),
+                "Concurrent Field_Register gives one ID");
+    
+    Matrix* a = Matrix_Create(2, 2, &custom);
+    Matrix* b = Matrix_Create(2, 2, &custom_twin);
+    Matrix* c = Matrix_Create(2, 2, GetIntFieldInfo());
+    Matrix_Identity(a);
+    Matrix_Identity(b);
+    MatrixError err;
+    Matrix* sum = Matrix_Add(a, b, &err);
+    int s00;
+    Matrix_Get(sum, 0, 0, &s00);
+    TEST_ASSERT(err == MATRIX_OK && s00 == 2, "Registered types with one ID are compatible");
+    Matrix* product = Matrix_Multiply(a, b, &err);
+    TEST_ASSERT(err == MATRIX_OK && product != NULL, "User type uses the generic kernel");
+    Matrix* mixed = Matrix_Add(a, c, &err);
+    TEST_ASSERT(mixed == NULL && err == MATRIX_ERROR_TYPE_MISMATCH, "Different IDs are incompatible");
+    
+    //Незарегистрированная копия с тем же именем совместима при любом порядке операндов
+    static FieldInfo custom_unregistered;
+    custom_unregistered = custom;
+    custom_unregistered.id = FIELD_ID_NONE;
+    Matrix* u = Matrix_Create(2, 2, &custom_unregistered);
+    Matrix_Identity(u);
+    MatrixError err_ru, err_ur;
+    Matrix* sum_ru = Matrix_Add(a, u, &err_ru);
+    Matrix* sum_ur = Matrix_Add(u, a, &err_ur);
+    TEST_ASSERT(custom_unregistered.id == FIELD_ID_NONE && err_ru == MATRIX_OK && err_ur == MATRIX_OK,
+                "Registered and unregistered twins are compatible in both orders");
+    Matrix_Destroy(u);
+    Matrix_Destroy(sum_ru);
+    Matrix_Destroy(sum_ur);
+    
+    DestroyModularFieldInfo(gf7);
+    DestroyModularFieldInfo(gf7_again);
+    DestroyModularFieldInfo(gf11);
+    Matrix_Destroy(a);
+    Matrix_Destroy(b);
+    Matrix_Destroy(c);
+    Matrix_Destroy(sum);
+    Matrix_Destroy(product);
+}
+
+void test_small_matrix() {
+    printf("\nTest 25 Fixed-Size Small Matrices:\n");
+    
+    SmallMat4f a4 = {{{4, 1, 0, 2}, {1, 5, 1, 0}, {0, 1, 6, 1}, {2, 0, 1, 7}}};
+    SmallMat4f b4 = {{{1, 2, 3, 4}, {0, 1, 0, 1}, {2, 0, 1, 0}, {1, 1, 1, 1}}};
+    SmallMat4f c4;
+    SmallMat4f_Multiply(&a4, &b4, &c4);
+    
+    MatrixError err;
+    Matrix* ma = SmallMat4f_ToMatrix(&a4, &err);
+    Matrix* mb = SmallMat4f_ToMatrix(&b4, &err);
+    Matrix* mc = Matrix_Multiply(ma, mb, &err);
+    SmallMat4f back;
+    TEST_ASSERT(SmallMat4f_FromMatrix(mc, &back) == MATRIX_OK &&
+                memcmp(&back, &c4, sizeof(back)) == 0, "4x4 float product matches Matrix_Multiply");
+    
+    //Определитель треугольной матрицы с перестановкой строк
+    SmallMat3d t3 = {{{0, 0, 5}, {0, 3, 1}, {2, 7, 4}}};
+    TEST_ASSERT(fabs(SmallMat3d_Determinant(&t3) + 30.0) < 1e-12, "3x3 double determinant");
+    
+    SmallMat8d a8;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) a8.m[i][j] = (i == j) ? 10.0 : 1.0 / (1 + i + 2 * j);
+    }
+    SmallMat8d inv8, check8;
+    double max_err = 1;
+    if (SmallMat8d_Inverse(&a8, &inv8)) {
+        SmallMat8d_Multiply(&inv8, &a8, &check8);
+        max_err = 0;
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < 8; j++) {
+                double d = fabs(check8.m[i][j] - (i == j));
+                if (d > max_err) max_err = d;
+            }
+        }
+    }
+    TEST_ASSERT(max_err < 1e-13, "8x8 double inverse gives A^-1 A = I");
+    
+    double x_true[8] = {1, -2, 3, -4, 5, -6, 7, -8};
+    double b8[8], x8[8];
+    for (int i = 0; i < 8; i++) {
+        b8[i] = 0;
+        for (int j = 0; j < 8; j++) b8[i] += a8.m[i][j] * x_true[j];
+    }
+    bool solved = SmallMat8d_Solve(&a8, b8, x8);
+    max_err = 0;
+    for (int i = 0; i < 8; i++) {
+        if (fabs(x8[i] - x_true[i]) > max_err) max_err = fabs(x8[i] - x_true[i]);
+    }
+    TEST_ASSERT(solved && max_err < 1e-12, "8x8 double solve");
+    
+    SmallMat2f singular = {{{1, 2}, {2, 4}}};
+    SmallMat2f singular_inv;
+    TEST_ASSERT(!SmallMat2f_Inverse(&singular, &singular_inv) && SmallMat2f_Determinant(&singular) == 0.0f,
+                "Singular 2x2 is detected");
+    
+    SmallMat4d wrong;
+    SmallMat3f wrong_size;
+    TEST_ASSERT(SmallMat4d_FromMatrix(ma, &wrong) == MATRIX_ERROR_TYPE_MISMATCH &&
+                SmallMat3f_FromMatrix(ma, &wrong_size) == MATRIX_ERROR_DIMENSION_MISMATCH,
+                "FromMatrix checks type and size");
+    
+    Matrix_Destroy(ma);
+    Matrix_Destroy(mb);
+    Matrix_Destroy(mc);
+}
+
+void test_batch_operations() {
+    printf("\nTest 26 Batched Operations:\n");
+    
+    //37 матриц: два полных блока и неполный хвост
+    const size_t count = 37;
+    float* fa = (float*)malloc(count * 12 * sizeof(float));
+    float* fb = (float*)malloc(count * 15 * sizeof(float));
+    float* fc = (float*)malloc(count * 20 * sizeof(float));
+    for (size_t i = 0; i < count * 12; i++) fa[i] = (float)((i * 7) % 11) - 5.0f;
+    for (size_t i = 0; i < count * 15; i++) fb[i] = (float)((i * 5) % 13) - 6.0f;
+    MatrixBatch ba = { fa, count, 4, 3, 12, GetFloatFieldInfo() };
+    MatrixBatch bb = { fb, count, 3, 5, 15, GetFloatFieldInfo() };
+    MatrixBatch bc = { fc, count, 4, 5, 20, GetFloatFieldInfo() };
+    MatrixError err = Matrix_MultiplyBatch(&ba, &bb, &bc);
+    
+    bool same = true;
+    Matrix* ma = Matrix_Create(4, 3, GetFloatFieldInfo());
+    Matrix* mb = Matrix_Create(3, 5, GetFloatFieldInfo());
+    for (size_t t = 0; t < count; t++) {
+        memcpy(ma->data, fa + t * 12, 12 * sizeof(float));
+        memcpy(mb->data, fb + t * 15, 15 * sizeof(float));
+        MatrixError merr;
+        Matrix* mc = Matrix_Multiply(ma, mb, &merr);
+        same &= memcmp(mc->data, fc + t * 20, 20 * sizeof(float)) == 0;
+        Matrix_Destroy(mc);
+    }
+    TEST_ASSERT(err == MATRIX_OK && same, "Strided float batch matches Matrix_Multiply");
+    
+    //Массив double-систем 16 x 16, одна из них вырождена
+    const size_t n = 16;
+    Matrix* as[20];
+    Matrix* bs[20];
+    Matrix* xs[20];
+    for (size_t t = 0; t < 20; t++) {
+        as[t] = Matrix_Create(n, n, GetDoubleFieldInfo());
+        bs[t] = Matrix_Create(n, 1, GetDoubleFieldInfo());
+        xs[t] = Matrix_Create(n, 1, GetDoubleFieldInfo());
+        double* ad = (double*)as[t]->data;
+        double* bd = (double*)bs[t]->data;
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) ad[i * n + j] = (i == j) ? (double)n : (double)((i + 3 * j + t) % 5) - 2.0;
+        }
+        //b = A * (1, 2, ..., n)
+        for (size_t i = 0; i < n; i++) {
+            bd[i] = 0;
+            for (size_t j = 0; j < n; j++) bd[i] += ad[i * n + j] * (double)(j + 1);
+        }
+    }
+    double* s = (double*)as[5]->data;
+    for (size_t j = 0; j < n; j++) s[n + j] = 2.0 * s[j];
+    
+    bool singular[20];
+    err = Matrix_SolveArray((const Matrix* const*)as, (const Matrix* const*)bs, xs, 20, singular);
+    double max_err = 0;
+    bool flags_ok = true;
+    for (size_t t = 0; t < 20; t++) {
+        flags_ok &= singular[t] == (t == 5);
+        if (t == 5) continue;
+        const double* xd = (const double*)xs[t]->data;
+        for (size_t i = 0; i < n; i++) max_err = fmax(max_err, fabs(xd[i] - (double)(i + 1)));
+    }
+    TEST_ASSERT(err == MATRIX_ERROR_SINGULAR_MATRIX && flags_ok, "Singular system is flagged per item");
+    TEST_ASSERT(max_err < 1e-10, "Remaining double systems are solved");
+    
+    Matrix* ints[1] = { Matrix_Create(2, 2, GetIntFieldInfo()) };
+    TEST_ASSERT(Matrix_MultiplyArray((const Matrix* const*)ints, (const Matrix* const*)ints, ints, 1) ==
+                MATRIX_ERROR_TYPE_MISMATCH, "Batch API rejects unsupported types");
+    bb.count = count - 1;
+    TEST_ASSERT(Matrix_MultiplyBatch(&ba, &bb, &bc) == MATRIX_ERROR_DIMENSION_MISMATCH,
+                "Batch sizes must match");
+    
+    for (size_t t = 0; t < 20; t++) {
+        Matrix_Destroy(as[t]);
+        Matrix_Destroy(bs[t]);
+        Matrix_Destroy(xs[t]);
+    }
+    Matrix_Destroy(ints[0]);
+    Matrix_Destroy(ma);
+    Matrix_Destroy(mb);
+    free(fa);
+    free(fb);
+    free(fc);
+}
+
+void test_determinant_inverse() {
+    printf("\nTest 27 Determinant and Inverse:\n");
+    
+    Matrix* a3 = Matrix_Create(3, 3, GetDoubleFieldInfo());
+    double v3[9] = {0, 2, 1, 3, 1, 0, 1, 1, 1};
+    memcpy(a3->data, v3, sizeof(v3));
+    int sign = 0;
+    double log_abs = 0;
+    MatrixError err = Matrix_Determinant(a3, &sign, &log_abs);
+    TEST_ASSERT(err == MATRIX_OK && sign == -1 && fabs(log_abs - log(4.0)) < 1e-12,
+                "3x3 determinant with row exchange");
+    
+    //det = 10^150 не помещается во float
+    const size_t big = 150;
+    Matrix* d = Matrix_Create(big, big, GetFloatFieldInfo());
+    float* dd = (float*)d->data;
+    for (size_t i = 0; i < big; i++) {
+        for (size_t j = 0; j < big; j++) dd[i * big + j] = (i == j) ? 10.0f : (j == i + 1 ? 3.0f : 0.0f);
+    }
+    err = Matrix_Determinant(d, &sign, &log_abs);
+    TEST_ASSERT(err == MATRIX_OK && sign == 1 && fabs(log_abs - big * log(10.0)) < 1e-9,
+                "Log-determinant does not overflow");
+    
+    Matrix* s = Matrix_Create(3, 3, GetIntFieldInfo());
+    int sv[9] = {1, 2, 3, 2, 4, 6, 1, 0, 1};
+    memcpy(s->data, sv, sizeof(sv));
+    err = Matrix_Determinant(s, &sign, &log_abs);
+    TEST_ASSERT(err == MATRIX_OK && sign == 0 && isinf(log_abs), "Singular determinant has zero sign");
+    
+    //200 > блока LU: несколько панелей и перестановки строк
+    const size_t n = 200;
+    Matrix* a = Matrix_Create(n, n, GetDoubleFieldInfo());
+    double* ad = (double*)a->data;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) ad[i * n + j] = (double)((i * 31 + j * 17) % 23) - 11.0 + (i == j ? 0.5 : 0.0);
+    }
+    Matrix* inv = Matrix_Inverse(a, &err);
+    Matrix* prod = inv ? Matrix_Multiply(a, inv, &err) : NULL;
+    double max_err = prod ? 0 : 1;
+    for (size_t i = 0; prod && i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            max_err = fmax(max_err, fabs(((double*)prod->data)[i * n + j] - (i == j ? 1.0 : 0.0)));
+        }
+    }
+    TEST_ASSERT(err == MATRIX_OK && max_err < 1e-9, "200x200 double inverse gives A A^-1 = I");
+    
+    Matrix* f = Matrix_Create(2, 2, GetFloatFieldInfo());
+    float fv[4] = {4, 7, 2, 6};
+    memcpy(f->data, fv, sizeof(fv));
+    Matrix* finv = Matrix_Inverse(f, &err);
+    float expected[4] = {0.6f, -0.7f, -0.2f, 0.4f};
+    bool close = finv && finv->type == GetFloatFieldInfo();
+    for (int i = 0; close && i < 4; i++) close = fabsf(((float*)finv->data)[i] - expected[i]) < 1e-6f;
+    TEST_ASSERT(err == MATRIX_OK && close, "Float inverse keeps the element type");
+    
+    Matrix* none = Matrix_Inverse(s, &err);
+    TEST_ASSERT(none == NULL && err == MATRIX_ERROR_TYPE_MISMATCH, "Integer matrix has no inverse in its type");
+    memcpy(a3->data, (double[9]){1, 2, 3, 2, 4, 6, 1, 0, 1}, 9 * sizeof(double));
+    none = Matrix_Inverse(a3, &err);
+    TEST_ASSERT(none == NULL && err == MATRIX_ERROR_SINGULAR_MATRIX, "Singular matrix is not inverted");
+    
+    Matrix_Destroy(a3);
+    Matrix_Destroy(d);
+    Matrix_Destroy(s);
+    Matrix_Destroy(a);
+    Matrix_Destroy(inv);
+    Matrix_Destroy(prod);
+    Matrix_Destroy(f);
+    Matrix_Destroy(finv);
+}
+
+void test_matrix_power() {
+    printf("\nTest 28 Matrix Power:\n");
+    
+    //Фибоначчи: [[1,1],[1,0]]^k = [[F(k+1), F(k)], [F(k), F(k-1)]]
+    Matrix* fib = Matrix_Create(2, 2, GetInt64FieldInfo());
+    int64_t fv[4] = {1, 1, 1, 0};
+    memcpy(fib->data, fv, sizeof(fv));
+    MatrixError err;
+    Matrix* f90 = Matrix_Power(fib, 90, &err);
+    TEST_ASSERT(err == MATRIX_OK && ((int64_t*)f90->data)[1] == 2880067194370816120LL, "int64 Fibonacci F(90)");
+    
+    Matrix* zero = Matrix_Power(fib, 0, &err);
+    int64_t z[4];
+    memcpy(z, zero->data, sizeof(z));
+    TEST_ASSERT(err == MATRIX_OK && z[0] == 1 && z[1] == 0 && z[2] == 0 && z[3] == 1, "A^0 is identity");
+    
+    //GF(p): степень совпадает с последовательными умножениями
+    const FieldInfo* gf = CreateModularFieldInfo(1000000007u);
+    Matrix* g = Matrix_Create(3, 3, gf);
+    for (uint32_t i = 0; i < 9; i++) ((uint32_t*)g->data)[i] = (i * 123456789u + 17u) % 1000000007u;
+    Matrix* gp = Matrix_Power(g, 77, &err);
+    Matrix* loop = Matrix_Clone(g, &err);
+    for (int i = 1; i < 77; i++) {
+        Matrix* next = Matrix_Multiply(loop, g, &err);
+        Matrix_Destroy(loop);
+        loop = next;
+    }
+    TEST_ASSERT(gp && memcmp(gp->data, loop->data, 9 * sizeof(uint32_t)) == 0, "GF(p) power matches repeated multiply");
+    
+    //min-plus: A^3 - кратчайшие пути ровно из трех ребер
+    Matrix* mp = Matrix_Create(3, 3, GetMinPlusFieldInfo());
+    float w[9] = {INFINITY, 1, 5, INFINITY, INFINITY, 1, 1, INFINITY, INFINITY};
+    memcpy(mp->data, w, sizeof(w));
+    Matrix* mp3 = Matrix_Power(mp, 3, &err);
+    Matrix* mp2 = Matrix_Multiply(mp, mp, &err);
+    Matrix* mp3_ref = Matrix_Multiply(mp2, mp, &err);
+    TEST_ASSERT(mp3 && memcmp(mp3->data, mp3_ref->data, sizeof(w)) == 0 && ((float*)mp3->data)[0] == 3.0f,
+                "Min-plus power gives k-edge shortest paths");
+    
+    //Цепь Маркова: строки A^k остаются стохастическими
+    Matrix* markov = Matrix_Create(2, 2, GetHalfFieldInfo());
+    Matrix* mf = Matrix_Create(2, 2, GetFloatFieldInfo());
+    float mv[4] = {0.75f, 0.25f, 0.5f, 0.5f};
+    memcpy(mf->data, mv, sizeof(mv));
+    GetHalfFieldInfo()->from_float(markov->data, mv, 4);
+    Matrix* m64 = Matrix_Power(markov, 64, &err);
+    float row[4];
+    if (m64) m64->type->to_float(row, m64->data, 4);
+    TEST_ASSERT(m64 && m64->type == GetHalfFieldInfo() && fabsf(row[0] - 2.0f / 3.0f) < 1e-3f &&
+                fabsf(row[0] + row[1] - 1.0f) < 1e-3f, "Half Markov chain converges to stationary distribution");
+    
+    Matrix* rect = Matrix_Create(2, 3, GetIntFieldInfo());
+    TEST_ASSERT(Matrix_Power(rect, 2, &err) == NULL && err == MATRIX_ERROR_DIMENSION_MISMATCH,
+                "Power requires a square matrix");
+    
+    Matrix_Destroy(fib);
+    Matrix_Destroy(f90);
+    Matrix_Destroy(zero);
+    Matrix_Destroy(g);
+    Matrix_Destroy(gp);
+    Matrix_Destroy(loop);
+    DestroyModularFieldInfo(gf);
+    Matrix_Destroy(mp);
+    Matrix_Destroy(mp2);
+    Matrix_Destroy(mp3);
+    Matrix_Destroy(mp3_ref);
+    Matrix_Destroy(markov);
+    Matrix_Destroy(mf);
+    Matrix_Destroy(m64);
+    Matrix_Destroy(rect);
+}
+
+static Matrix* chain_matrix(size_t rows, size_t cols, const FieldInfo* type, int seed) {
+    Matrix* m = Matrix_Create(rows, cols, type);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            int v = (int)((i * 7 + j * 3 + seed) % 5) - 2;
+            if (type == GetIntFieldInfo()) {
+                Matrix_Set(m, i, j, &v);
+            } else {
+                double d = v;
+                Matrix_Set(m, i, j, &d);
+            }
+        }
+    }
+    return m;
+}
+
+void test_matrix_chain() {
+    printf("\nTest 29 Matrix Chain Multiplication:\n");
+    
+    size_t dims[5] = {40, 20, 30, 10, 30};
+    const Matrix* chain[4];
+    for (int i = 0; i < 4; i++) chain[i] = chain_matrix(dims[i], dims[i + 1], GetDoubleFieldInfo(), i);
+    
+    MatrixError err;
+    MatrixChainPlan* plan = Matrix_PlanChain(chain, 4, &err);
+    char text[64] = {0};
+    FILE* out = tmpfile();
+    MatrixChainPlan_Print(plan, out);
+    rewind(out);
+    fgets(text, sizeof(text), out);
+    fclose(out);
+    TEST_ASSERT(err == MATRIX_OK && strcmp(text, "((A0 (A1 A2)) A3)\n") == 0, "Plan picks the cheapest parenthesization");
+    TEST_ASSERT(plan->flops == 2 * 26000 && plan->naive_flops == 2 * 48000, "Plan reports estimated FLOPs");
+    
+    Matrix* product = Matrix_MultiplyChain(chain, 4, &err);
+    Matrix* ab = Matrix_Multiply(chain[0], chain[1], &err);
+    Matrix* abc = Matrix_Multiply(ab, chain[2], &err);
+    Matrix* abcd = Matrix_Multiply(abc, chain[3], &err);
+    TEST_ASSERT(product && product->rows == 40 && product->cols == 30 &&
+                memcmp(product->data, abcd->data, 40 * 30 * sizeof(double)) == 0,
+                "Chain product matches left-to-right result");
+    
+    //Два независимых подпроизведения и переиспользование буферов
+    size_t idims[7] = {16, 64, 4, 64, 16, 64, 4};
+    const Matrix* ichain[6];
+    for (int i = 0; i < 6; i++) ichain[i] = chain_matrix(idims[i], idims[i + 1], GetIntFieldInfo(), i);
+    Matrix* iproduct = Matrix_MultiplyChain(ichain, 6, &err);
+    Matrix* iref = Matrix_Clone(ichain[0], &err);
+    for (int i = 1; i < 6; i++) {
+        Matrix* next = Matrix_Multiply(iref, ichain[i], &err);
+        Matrix_Destroy(iref);
+        iref = next;
+    }
+    TEST_ASSERT(iproduct && memcmp(iproduct->data, iref->data, 16 * 4 * sizeof(int)) == 0,
+                "Int chain with independent subproducts");
+    
+    const Matrix* bad[2] = {chain[0], chain[0]};
+    TEST_ASSERT(Matrix_MultiplyChain(bad, 2, &err) == NULL && err == MATRIX_ERROR_DIMENSION_MISMATCH,
+                "Incompatible chain is rejected");
+    
+    for (int i = 0; i < 4; i++) Matrix_Destroy((Matrix*)chain[i]);
+    for (int i = 0; i < 6; i++) Matrix_Destroy((Matrix*)ichain[i]);
+    MatrixChainPlan_Destroy(plan);
+    Matrix_Destroy(product);
+    Matrix_Destroy(ab);
+    Matrix_Destroy(abc);
+    Matrix_Destroy(abcd);
+    Matrix_Destroy(iproduct);
+    Matrix_Destroy(iref);
+}
+
+void test_row_operations() {
+    printf("\nTest 30 Batched Row Operations:\n");
+    
+    const size_t rows = 50, cols = 40;
+    Matrix* m = Matrix_Create(rows, cols, GetDoubleFieldInfo());
+    Matrix* c = Matrix_Create(rows, rows, GetDoubleFieldInfo());
+    double* md = (double*)m->data;
+    double* cd = (double*)c->data;
+    for (size_t i = 0; i < rows * cols; i++) md[i] = (double)((i * 13) % 17) - 8.0;
+    //Меняются строки 3, 10 и 49; строка 10 включает себя (диагональ)
+    cd[3 * rows + 0] = 2.0;
+    cd[3 * rows + 7] = -1.0;
+    cd[10 * rows + 10] = 1.0;
+    cd[10 * rows + 3] = 0.5;
+    cd[49 * rows + 48] = 3.0;
+    
+    double* expected = (double*)malloc(rows * cols * sizeof(double));
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            double acc = md[i * cols + j];
+            for (size_t k = 0; k < rows; k++) acc += cd[i * rows + k] * md[k * cols + j];
+            expected[i * cols + j] = acc;
+        }
+    }
+    MatrixError err = Matrix_ApplyRowOps(m, c);
+    TEST_ASSERT(err == MATRIX_OK && memcmp(md, expected, rows * cols * sizeof(double)) == 0,
+                "Coefficient matrix applied as (I + C) M in place");
+    
+    //Список: две операции над строкой 0 суммируются, alphas[target] пропускается
+    Matrix* f = Matrix_Create(3, 2, GetFloatFieldInfo());
+    float fv[6] = {1, 2, 3, 4, 5, 6};
+    memcpy(f->data, fv, sizeof(fv));
+    float a1[3] = {100, 1, 0};
+    float a2[3] = {0, 0, 2};
+    float a3[3] = {1, 0, 0};
+    MatrixRowOp ops[3] = {{0, a1}, {0, a2}, {2, a3}};
+    err = Matrix_ApplyRowOpList(f, ops, 3);
+    float fe[6] = {1 + 3 + 10, 2 + 4 + 12, 3, 4, 5 + 1, 6 + 2};
+    TEST_ASSERT(err == MATRIX_OK && memcmp(f->data, fe, sizeof(fe)) == 0,
+                "Row operation list reads original rows");
+    
+    //min-plus: row0 = min(row0, min_k (c_k + row_k))
+    Matrix* mp = Matrix_Create(2, 2, GetMinPlusFieldInfo());
+    float mv[4] = {10, 10, 1, 7};
+    memcpy(mp->data, mv, sizeof(mv));
+    float malpha[2] = {INFINITY, 2};
+    MatrixRowOp mop = {0, malpha};
+    err = Matrix_ApplyRowOpList(mp, &mop, 1);
+    TEST_ASSERT(err == MATRIX_OK && ((float*)mp->data)[0] == 3.0f && ((float*)mp->data)[1] == 9.0f,
+                "Row operations follow semiring arithmetic");
+    
+    MatrixRowOp bad = {7, a1};
+    TEST_ASSERT(Matrix_ApplyRowOpList(f, &bad, 1) == MATRIX_ERROR_INVALID_INDEX, "Invalid target row");
+    TEST_ASSERT(Matrix_ApplyRowOps(f, c) == MATRIX_ERROR_TYPE_MISMATCH, "Coefficient type must match");
+    
+    free(expected);
+    Matrix_Destroy(m);
+    Matrix_Destroy(c);
+    Matrix_Destroy(f);
+    Matrix_Destroy(mp);
+}
+
+void test_copy_on_write() {
+    printf("\nTest 31 Copy-on-Write Buffers:\n");
+    
+    const size_t rows = 6, cols = 4;
+    Matrix* m = Matrix_Create(rows, cols, GetDoubleFieldInfo());
+    for (size_t i = 0; i < rows * cols; i++) ((double*)m->data)[i] = (double)i;
+    
+    MatrixError err;
+    Matrix* clone = Matrix_Clone(m, &err);
+    TEST_ASSERT(err == MATRIX_OK && clone->buffer == m->buffer && clone->data == m->data,
+                "Clone shares the buffer");
+    double v = -1.0;
+    Matrix_Set(clone, 0, 0, &v);
+    double got = 0.0;
+    Matrix_Get(m, 0, 0, &got);
+    TEST_ASSERT(clone->data != m->data && got == 0.0 && ((double*)clone->data)[0] == -1.0,
+                "Write to clone detaches it, original unchanged");
+    
+    double factor = 2.0;
+    Matrix* source = Matrix_Clone(m, &err);
+    Matrix* scaled = Matrix_ScalarMultiply(source, &factor, &err);
+    TEST_ASSERT(err == MATRIX_OK && ((double*)source->data)[5] == 5.0 && ((double*)scaled->data)[5] == 10.0,
+                "Scalar multiply leaves shared source unchanged");
+    
+    //Представление строк 2..4 указывает в данные исходной матрицы
+    Matrix* view = Matrix_ViewRows(m, 2, 3, &err);
+    TEST_ASSERT(err == MATRIX_OK && view->rows == 3 && view->cols == cols &&
+                view->data == (char*)m->data + 2 * cols * sizeof(double),
+                "Row view shares data without copying");
+    v = 100.0;
+    Matrix_Set(view, 0, 1, &v);
+    Matrix_Get(m, 2, 1, &got);
+    TEST_ASSERT(got == 9.0 && ((double*)view->data)[1] == 100.0 && view->buffer != m->buffer,
+                "Write to view copies its rows, parent unchanged");
+    Matrix* bad_view = Matrix_ViewRows(m, 4, 3, &err);
+    TEST_ASSERT(bad_view == NULL && err == MATRIX_ERROR_INVALID_INDEX, "View beyond last row rejected");
+    
+    //Файл отображается только для чтения, запись копирует в кучу
+    const char* path = "test_matrix_map.bin";
+    FILE* f = fopen(path, "wb");
+    fwrite(m->data, sizeof(double), rows * cols, f);
+    fclose(f);
+    Matrix* mapped = Matrix_MapFile(path, rows, cols, GetDoubleFieldInfo(), &err);
+    TEST_ASSERT(err == MATRIX_OK && mapped && memcmp(mapped->data, m->data, rows * cols * sizeof(double)) == 0,
+                "Mapped file reads matrix values");
+    if (mapped) {
+        v = 7.5;
+        TEST_ASSERT(Matrix_Set(mapped, 5, 3, &v) == MATRIX_OK && ((double*)mapped->data)[23] == 7.5 &&
+                    ((double*)mapped->data)[22] == 22.0,
+                    "Write to mapped matrix goes to a private copy");
+    }
+    Matrix* short_map = Matrix_MapFile(path, rows + 1, cols, GetDoubleFieldInfo(), &err);
+    TEST_ASSERT(short_map == NULL && err == MATRIX_ERROR_INVALID_SIZE, "File shorter than matrix rejected");
+    Matrix_Destroy(mapped);
+    remove(path);
+    Matrix* missing = Matrix_MapFile("no_such_matrix_file.bin", 2, 2, GetDoubleFieldInfo(), &err);
+    TEST_ASSERT(missing == NULL && err == MATRIX_ERROR_IO, "Missing file reports IO error");
+    
+    //Клоны создаются и удаляются из разных потоков
+    bool shared_ok = true;
+    #pragma omp parallel for reduction(&&:shared_ok)
+    for (int t = 0; t < 64; t++) {
+        Matrix* c = Matrix_Clone(m, NULL);
+        double x = (double)t;
+        shared_ok = shared_ok && c && Matrix_Set(c, 1, 1, &x) == MATRIX_OK && ((double*)c->data)[5] == x;
+        Matrix_Destroy(c);
+    }
+    Matrix_Get(m, 1, 1, &got);
+    TEST_ASSERT(shared_ok && got == 5.0, "Concurrent clone and write keep the original");
+    
+    Matrix_Destroy(m);
+    Matrix_Destroy(clone);
+    Matrix_Destroy(source);
+    Matrix_Destroy(scaled);
+    Matrix_Destroy(view);
+}
+
+void test_result_cache() {
+    printf("\nTest 32 Result Cache:\n");
+    
+    const size_t n = 60, k = 40;
+    Matrix* a = Matrix_Create(n, n, GetDoubleFieldInfo());
+    Matrix* b = Matrix_Create(n, k, GetDoubleFieldInfo());
+    for (size_t i = 0; i < n * n; i++) ((double*)a->data)[i] = (double)((i * 37) % 23) - 11.0 + (i % (n + 1) == 0 ? 60.0 : 0.0);
+    for (size_t i = 0; i < n * k; i++) ((double*)b->data)[i] = (double)((i * 11) % 7) - 3.0;
+    
+    TEST_ASSERT(Matrix_CacheEnable(0) == MATRIX_ERROR_INVALID_SIZE, "Zero budget rejected");
+    TEST_ASSERT(Matrix_CacheEnable(16 << 20) == MATRIX_OK, "Enable cache");
+    Matrix_ResetCacheStats();
+    
+    MatrixError err;
+    MatrixCacheStats s;
+    Matrix* p1 = Matrix_Multiply(a, b, &err);
+    Matrix* p2 = Matrix_Multiply(a, b, &err);
+    Matrix_GetCacheStats(&s);
+    TEST_ASSERT(s.hits == 1 && s.misses == 1 && s.entries == 1, "Repeated product served from cache");
+    TEST_ASSERT(p1->buffer == p2->buffer && memcmp(p1->data, p2->data, n * k * sizeof(double)) == 0,
+                "Cached product shares the buffer");
+    
+    //Тот же контент в другой матрице находится по хешу
+    Matrix* a_copy = Matrix_Create(n, n, GetDoubleFieldInfo());
+    memcpy(a_copy->data, a->data, n * n * sizeof(double));
+    Matrix* p3 = Matrix_Multiply(a_copy, b, &err);
+    Matrix_GetCacheStats(&s);
+    TEST_ASSERT(s.hits == 2 && p3->buffer == p1->buffer, "Equal contents hit the same entry");
+    
+    //Запись в полученный результат не портит кэш
+    double v = 1e9;
+    Matrix_Set(p2, 0, 0, &v);
+    Matrix* p4 = Matrix_Multiply(a, b, &err);
+    TEST_ASSERT(((double*)p4->data)[0] == ((double*)p1->data)[0], "Writes to a result do not reach the cache");
+    
+    //Изменение операнда - новая версия буфера, новый хеш
+    double old = 0.0;
+    Matrix_Get(a, 0, 0, &old);
+    v = old + 1.0;
+    Matrix_Set(a, 0, 0, &v);
+    Matrix* p5 = Matrix_Multiply(a, b, &err);
+    double expected = ((double*)p1->data)[0] + ((double*)b->data)[0];
+    Matrix_GetCacheStats(&s);
+    TEST_ASSERT(s.misses == 2 && ((double*)p5->data)[0] == expected, "Mutated operand misses the cache");
+    Matrix_MakeWritable(a);
+    ((double*)a->data)[0] = old;
+    Matrix* p6 = Matrix_Multiply(a, b, &err);
+    Matrix_GetCacheStats(&s);
+    TEST_ASSERT(s.misses == 2 && p6->buffer == p1->buffer, "Direct write after MakeWritable is seen");
+    
+    //LU-множители A переиспользуются для новых правых частей
+    Matrix* rhs = Matrix_Create(n, 1, GetDoubleFieldInfo());
+    Matrix* x = Matrix_Create(n, 1, GetDoubleFieldInfo());
+    bool solved = true;
+    Matrix_ResetCacheStats();
+    for (int r = 0; r < 3; r++) {
+        Matrix_MakeWritable(rhs);
+        for (size_t i = 0; i < n; i++) ((double*)rhs->data)[i] = (double)(i % 5) + r;
+        solved = solved && Matrix_GaussSolve(a, rhs, x) == MATRIX_OK;
+        for (size_t i = 0; i < n && solved; i++) {
+            double acc = 0.0;
+            for (size_t j = 0; j < n; j++) acc += ((double*)a->data)[i * n + j] * ((double*)x->data)[j];
+            solved = fabs(acc - ((double*)rhs->data)[i]) < 1e-9;
+        }
+    }
+    Matrix_GetCacheStats(&s);
+    TEST_ASSERT(solved && s.misses == 1 && s.hits == 2, "Gauss solve reuses cached LU factors");
+    
+    //Прямая запись в data без Matrix_MakeWritable: A = 2I, затем A = I
+    Matrix* a2 = Matrix_Create(2, 2, GetDoubleFieldInfo());
+    Matrix* b2 = Matrix_Create(2, 1, GetDoubleFieldInfo());
+    Matrix* x2 = Matrix_Create(2, 1, GetDoubleFieldInfo());
+    double a2_values[] = {2.0, 0.0, 0.0, 2.0}, b2_values[] = {2.0, 4.0};
+    memcpy(a2->data, a2_values, sizeof(a2_values));
+    memcpy(b2->data, b2_values, sizeof(b2_values));
+    Matrix_GaussSolve(a2, b2, x2);
+    bool first = ((double*)x2->data)[0] == 1.0 && ((double*)x2->data)[1] == 2.0;
+    ((double*)a2->data)[0] = 1.0;
+    ((double*)a2->data)[3] = 1.0;
+    Matrix_GaussSolve(a2, b2, x2);
+    TEST_ASSERT(first && ((double*)x2->data)[0] == 2.0 && ((double*)x2->data)[1] == 4.0,
+                "Direct write to data without MakeWritable is seen");
+    
+    //Описание GF(7) удаляется, пока произведение остается в кэше
+    const FieldInfo* gf7 = CreateModularFieldInfo(7);
+    Matrix* g1 = Matrix_Create(2, 2, gf7);
+    uint32_t g_values[] = {1, 2, 3, 4};
+    memcpy(g1->data, g_values, sizeof(g_values));
+    Matrix* gp1 = Matrix_Multiply(g1, g1, &err);
+    Matrix_Destroy(g1);
+    DestroyModularFieldInfo(gf7);
+    gf7 = CreateModularFieldInfo(7);
+    Matrix* g2 = Matrix_Create(2, 2, gf7);
+    memcpy(g2->data, g_values, sizeof(g_values));
+    Matrix* gp2 = Matrix_Multiply(g2, g2, &err);
+    TEST_ASSERT(gp2 && gp2->type == gf7 && memcmp(gp1->data, gp2->data, sizeof(g_values)) == 0,
+                "Hit after the GF(p) descriptor is recreated returns the live type");
+    Matrix_Destroy(gp1);
+    Matrix_Destroy(gp2);
+    Matrix_Destroy(g2);
+    DestroyModularFieldInfo(gf7);
+    
+    //Смешанное произведение bfloat16 x float: из кэша тоже float
+    Matrix* h = Matrix_Create(2, 2, GetBFloat16FieldInfo());
+    Matrix* f = Matrix_Create(2, 2, GetFloatFieldInfo());
+    for (size_t i = 0; i < 4; i++) {
+        ((uint16_t*)h->data)[i] = BFloat16FromFloat((float)(i + 1));
+        ((float*)f->data)[i] = 1.0f;
+    }
+    Matrix* hp1 = Matrix_Multiply(h, f, &err);
+    Matrix* hp2 = Matrix_Multiply(h, f, &err);
+    TEST_ASSERT(hp1 && hp2 && hp2->type == GetFloatFieldInfo() && hp2->buffer == hp1->buffer &&
+                ((float*)hp2->data)[0] == 3.0f && ((float*)hp2->data)[3] == 7.0f,
+                "Cached mixed-type product keeps the promoted type");
+    Matrix_Destroy(h);
+    Matrix_Destroy(f);
+    Matrix_Destroy(hp1);
+    Matrix_Destroy(hp2);
+    
+    //Умножение 3M пишет в T1 и T3 на месте: из кэша они приходят с общим буфером
+    const FieldInfo* ct = GetComplexFieldInfo();
+    Matrix* ca = Matrix_Create(2, 2, ct);
+    Matrix* cb = Matrix_Create(2, 2, ct);
+    for (size_t i = 0; i < 4; i++) {
+        ComplexFloat x = {(float)(2 * i + 1), (float)(i + 5)};
+        ComplexFloat y = {(float)(3 * i + 2), (float)(2 * i + 7)};
+        ((ComplexFloat*)ca->data)[i] = x;
+        ((ComplexFloat*)cb->data)[i] = y;
+    }
+    SplitComplexMatrix* sa = Matrix_ToSplitComplex(ca, NULL);
+    SplitComplexMatrix* sb = Matrix_ToSplitComplex(cb, NULL);
+    Matrix* rr = Matrix_Multiply(sa->re, sb->re, &err);
+    float rr_before[4];
+    memcpy(rr_before, rr->data, sizeof(rr_before));
+    SplitComplexMatrix* sc1 = SplitComplexMatrix_Multiply(sa, sb, &err);
+    SplitComplexMatrix* sc2 = SplitComplexMatrix_Multiply(sa, sb, &err);
+    bool split_ok = sc1 && sc2;
+    for (size_t i = 0; split_ok && i < 2; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            float re = 0.0f, im = 0.0f;
+            for (size_t p = 0; p < 2; p++) {
+                ComplexFloat x = ((ComplexFloat*)ca->data)[i * 2 + p];
+                ComplexFloat y = ((ComplexFloat*)cb->data)[p * 2 + j];
+                re += x.re * y.re - x.im * y.im;
+                im += x.re * y.im + x.im * y.re;
+            }
+            for (int r = 0; r < 2; r++) {
+                const SplitComplexMatrix* sc = r ? sc2 : sc1;
+                split_ok = split_ok && ((float*)sc->re->data)[i * 2 + j] == re &&
+                           ((float*)sc->im->data)[i * 2 + j] == im;
+            }
+        }
+    }
+    Matrix* rr_again = Matrix_Multiply(sa->re, sb->re, &err);
+    TEST_ASSERT(split_ok && memcmp(rr->data, rr_before, sizeof(rr_before)) == 0 &&
+                memcmp(rr_again->data, rr_before, sizeof(rr_before)) == 0,
+                "Split complex multiply leaves cached products intact");
+    
+    //Ar Br = Ai Bi: T1 и T2 приходят из одной записи кэша
+    memcpy(sa->im->data, sa->re->data, 4 * sizeof(float));
+    memcpy(sb->im->data, sb->re->data, 4 * sizeof(float));
+    SplitComplexMatrix* sc3 = SplitComplexMatrix_Multiply(sa, sb, &err);
+    split_ok = sc3 != NULL;
+    for (size_t i = 0; split_ok && i < 4; i++) {
+        split_ok = ((float*)sc3->re->data)[i] == 0.0f && ((float*)sc3->im->data)[i] == 2.0f * rr_before[i];
+    }
+    TEST_ASSERT(split_ok && memcmp(rr->data, rr_before, sizeof(rr_before)) == 0,
+                "Split complex multiply with equal partial products");
+    Matrix_Destroy(ca);
+    Matrix_Destroy(cb);
+    Matrix_Destroy(rr);
+    Matrix_Destroy(rr_again);
+    SplitComplexMatrix_Destroy(sa);
+    SplitComplexMatrix_Destroy(sb);
+    SplitComplexMatrix_Destroy(sc1);
+    SplitComplexMatrix_Destroy(sc2);
+    SplitComplexMatrix_Destroy(sc3);
+    
+    //Вытеснение: бюджет вмещает произведение A * B с копиями операндов, но не два
+    TEST_ASSERT(Matrix_CacheEnable(2 * n * k * sizeof(double) + n * n * sizeof(double) + 1024) == MATRIX_OK,
+                "Shrink budget");
+    Matrix_ResetCacheStats();
+    Matrix* c2 = Matrix_Create(k, 2, GetDoubleFieldInfo());
+    Matrix* p7 = Matrix_Multiply(b, c2, &err);
+    Matrix* p8 = Matrix_Multiply(a, b, &err);
+    Matrix_GetCacheStats(&s);
+    TEST_ASSERT(s.evictions >= 1 && s.bytes <= s.budget_bytes && s.entries >= 1, "LRU eviction keeps budget");
+    
+    Matrix_CacheDisable();
+    Matrix_ResetCacheStats();
+    Matrix* p9 = Matrix_Multiply(a, b, &err);
+    Matrix_GetCacheStats(&s);
+    TEST_ASSERT(!s.enabled && s.entries == 0 && s.hits == 0 && s.misses == 0 && p9->buffer != p8->buffer,
+                "Disabled cache is bypassed");
+    
+    Matrix* all[] = {a, b, a_copy, p1, p2, p3, p4, p5, p6, rhs, x, a2, b2, x2, c2, p7, p8, p9};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) Matrix_Destroy(all[i]);
+}
+
+//Максимальная разница элементов двух double-матриц одного размера
+static double max_abs_diff(const Matrix* a, const Matrix* b) {
+    double d = 0.0;
+    for (size_t i = 0; i < a->rows * a->cols; i++) {
+        d = fmax(d, fabs(((const double*)a->data)[i] - ((const double*)b->data)[i]));
+    }
+    return d;
+}
+
+void test_incremental_updates() {
+    printf("\nTest 33 Incremental Updates:\n");
+    
+    const size_t n = 80;
+    Matrix* a = Matrix_Create(n, n, GetDoubleFieldInfo());
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            ((double*)a->data)[i * n + j] = (i == j) ? 40.0 : (double)((i * 7 + j * 3) % 11) / 11.0 - 0.5;
+        }
+    }
+    Matrix* b = Matrix_Create(n, 1, GetDoubleFieldInfo());
+    for (size_t i = 0; i < n; i++) ((double*)b->data)[i] = (double)(i % 9) - 4.0;
+    Matrix* x = Matrix_Create(n, 1, GetDoubleFieldInfo());
+    Matrix* x_ref = Matrix_Create(n, 1, GetDoubleFieldInfo());
+    
+    MatrixError err;
+    MatrixFactorization* f = Matrix_Factorize(a, 0, 0.0, &err);
+    TEST_ASSERT(err == MATRIX_OK && f != NULL, "Factorize double matrix");
+    
+    //Поток изменений отдельных элементов
+    Matrix* current = Matrix_Clone(a, &err);
+    for (size_t t = 0; t < 10; t++) {
+        double value = 3.0 + (double)t;
+        size_t row = (t * 13) % n, col = (t * 29 + 5) % n;
+        MatrixFactorization_Set(f, row, col, value);
+        Matrix_Set(current, row, col, &value);
+    }
+    err = MatrixFactorization_Solve(f, b, x);
+    Matrix_GaussSolve(current, b, x_ref);
+    MatrixUpdateReport report;
+    MatrixFactorization_GetReport(f, &report);
+    TEST_ASSERT(err == MATRIX_OK && max_abs_diff(x, x_ref) < 1e-10 && report.rank == 10 &&
+                report.refactorizations == 1 && report.backward_error < 1e-13,
+                "Element updates solved through Woodbury without refactoring");
+    
+    //Поправка ранга 3
+    Matrix* u = Matrix_Create(n, 3, GetDoubleFieldInfo());
+    Matrix* v = Matrix_Create(n, 3, GetDoubleFieldInfo());
+    for (size_t i = 0; i < n * 3; i++) {
+        ((double*)u->data)[i] = (double)((i * 5) % 7) / 7.0;
+        ((double*)v->data)[i] = (double)((i * 3) % 5) / 5.0 - 0.4;
+    }
+    err = MatrixFactorization_Update(f, u, v);
+    Matrix_MakeWritable(current);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double s = 0.0;
+            for (size_t t = 0; t < 3; t++) s += ((double*)u->data)[i * 3 + t] * ((double*)v->data)[j * 3 + t];
+            ((double*)current->data)[i * n + j] += s;
+        }
+    }
+    MatrixFactorization_Solve(f, b, x);
+    Matrix_GaussSolve(current, b, x_ref);
+    MatrixFactorization_GetReport(f, &report);
+    TEST_ASSERT(max_abs_diff(x, x_ref) < 1e-10 && report.rank == 13 && report.updates == 13,
+                "Rank-3 update accumulates in the correction");
+    MatrixFactorization_Destroy(f);
+    
+    //Превышение ранга и дрейф ведут к полному разложению
+    f = Matrix_Factorize(a, 4, 0.0, &err);
+    for (size_t t = 0; t < 5; t++) MatrixFactorization_Set(f, t, t + 1, 1.0 + (double)t);
+    MatrixFactorization_GetReport(f, &report);
+    TEST_ASSERT(report.refactorizations == 2 && report.rank == 0, "Rank limit triggers refactorization");
+    MatrixFactorization_Destroy(f);
+    
+    f = Matrix_Factorize(a, 0, 1e-300, &err);
+    MatrixFactorization_Set(f, 0, 1, 2.0);
+    MatrixFactorization_Solve(f, b, x);
+    MatrixFactorization_GetReport(f, &report);
+    TEST_ASSERT(report.refactorizations == 2 && report.rank == 0, "Drift check triggers refactorization");
+    MatrixFactorization_Destroy(f);
+    
+    //Поправка, после которой A вырождена, отклоняется без изменения разложения
+    Matrix* e2 = Matrix_Create(2, 2, GetDoubleFieldInfo());
+    Matrix* b2 = Matrix_Create(2, 1, GetDoubleFieldInfo());
+    Matrix* x2 = Matrix_Create(2, 1, GetDoubleFieldInfo());
+    Matrix_Identity(e2);
+    ((double*)b2->data)[0] = 3.0;
+    ((double*)b2->data)[1] = 5.0;
+    f = Matrix_Factorize(e2, 0, 0.0, &err);
+    err = MatrixFactorization_Set(f, 0, 0, 0.0);
+    MatrixError solve_err = MatrixFactorization_Solve(f, b2, x2);
+    MatrixFactorization_GetReport(f, &report);
+    TEST_ASSERT(err == MATRIX_ERROR_SINGULAR_MATRIX && solve_err == MATRIX_OK && report.updates == 0 &&
+                report.rank == 0 && ((double*)x2->data)[0] == 3.0 && ((double*)x2->data)[1] == 5.0,
+                "Failed update leaves the factorization unchanged");
+    err = MatrixFactorization_Set(f, 0, 0, 2.0);
+    MatrixFactorization_Solve(f, b2, x2);
+    TEST_ASSERT(err == MATRIX_OK && fabs(((double*)x2->data)[0] - 1.5) < 1e-15 && ((double*)x2->data)[1] == 5.0,
+                "Update after a rejected one applies to the old A");
+    MatrixFactorization_Destroy(f);
+    Matrix_Destroy(e2);
+    Matrix_Destroy(b2);
+    Matrix_Destroy(x2);
+    
+    //Обратная матрица по Вудбери
+    Matrix* inv = Matrix_Inverse(a, &err);
+    Matrix* a2 = Matrix_Clone(a, &err);
+    err = Matrix_InverseUpdate(inv, a2, u, v);
+    Matrix* inv_ref = Matrix_Inverse(a2, &err);
+    TEST_ASSERT(err == MATRIX_OK && max_abs_diff(inv, inv_ref) < 1e-12 && ((double*)a->data)[0] == 40.0,
+                "Inverse updated in place, original A untouched");
+    
+    //A = I, u = (-1, 0), v = (1, 0): новая A вырождена, a и inv не меняются
+    Matrix* ra = Matrix_Create(2, 2, GetDoubleFieldInfo());
+    Matrix* rinv = Matrix_Create(2, 2, GetDoubleFieldInfo());
+    Matrix* ru = Matrix_Create(2, 1, GetDoubleFieldInfo());
+    Matrix* rv = Matrix_Create(2, 1, GetDoubleFieldInfo());
+    Matrix_Identity(ra);
+    Matrix_Identity(rinv);
+    ((double*)ru->data)[0] = -1.0;
+    ((double*)rv->data)[0] = 1.0;
+    err = Matrix_InverseUpdate(rinv, ra, ru, rv);
+    double eye[] = {1.0, 0.0, 0.0, 1.0};
+    TEST_ASSERT(err == MATRIX_ERROR_SINGULAR_MATRIX && memcmp(ra->data, eye, sizeof(eye)) == 0 &&
+                memcmp(rinv->data, eye, sizeof(eye)) == 0,
+                "Failed inverse update leaves A and inverse unchanged");
+    Matrix_Destroy(ra);
+    Matrix_Destroy(rinv);
+    Matrix_Destroy(ru);
+    Matrix_Destroy(rv);
+    
+    //Произведение: строка и столбец A
+    const size_t m = 30, k = 20, p = 25;
+    Matrix* pa = Matrix_Create(m, k, GetDoubleFieldInfo());
+    Matrix* pb = Matrix_Create(k, p, GetDoubleFieldInfo());
+    for (size_t i = 0; i < m * k; i++) ((double*)pa->data)[i] = (double)((i * 7) % 13) - 6.0;
+    for (size_t i = 0; i < k * p; i++) ((double*)pb->data)[i] = (double)((i * 5) % 11) - 5.0;
+    Matrix* pc = Matrix_Multiply(pa, pb, &err);
+    Matrix* pc_old = Matrix_Clone(pc, &err);
+    double value = 9.0;
+    for (size_t j = 0; j < k; j++) Matrix_Set(pa, 5, j, &value);
+    err = Matrix_ProductRefreshRow(pc, pa, pb, 5);
+    Matrix* fresh = Matrix_Multiply(pa, pb, &err);
+    TEST_ASSERT(err == MATRIX_OK && max_abs_diff(pc, fresh) == 0.0 && max_abs_diff(pc_old, fresh) > 0.0,
+                "Row refresh matches full product, clone keeps old values");
+    Matrix_Destroy(fresh);
+    
+    double old_column[30];
+    for (size_t i = 0; i < m; i++) {
+        old_column[i] = ((double*)pa->data)[i * k + 3];
+        value = (double)(i % 4);
+        Matrix_Set(pa, i, 3, &value);
+    }
+    err = Matrix_ProductRefreshColumn(pc, pa, pb, 3, old_column);
+    fresh = Matrix_Multiply(pa, pb, &err);
+    TEST_ASSERT(err == MATRIX_OK && max_abs_diff(pc, fresh) == 0.0, "Column refresh as rank-1 update (double)");
+    Matrix_Destroy(fresh);
+    
+    //int - точное обновление, min-plus - полный пересчет
+    Matrix* ia = Matrix_Create(4, 3, GetIntFieldInfo());
+    Matrix* ib = Matrix_Create(3, 5, GetIntFieldInfo());
+    for (int i = 0; i < 12; i++) ((int*)ia->data)[i] = i - 5;
+    for (int i = 0; i < 15; i++) ((int*)ib->data)[i] = 2 * i - 7;
+    Matrix* ic = Matrix_Multiply(ia, ib, &err);
+    int old_int[4];
+    for (int i = 0; i < 4; i++) {
+        old_int[i] = ((int*)ia->data)[i * 3 + 1];
+        int nv = 3 * i + 1;
+        Matrix_Set(ia, i, 1, &nv);
+    }
+    err = Matrix_ProductRefreshColumn(ic, ia, ib, 1, old_int);
+    Matrix* ic_ref = Matrix_Multiply(ia, ib, &err);
+    TEST_ASSERT(err == MATRIX_OK && memcmp(ic->data, ic_ref->data, 20 * sizeof(int)) == 0,
+                "Column refresh exact for int");
+    
+    Matrix* ma = Matrix_Create(3, 3, GetMinPlusFieldInfo());
+    Matrix* mb = Matrix_Create(3, 3, GetMinPlusFieldInfo());
+    for (int i = 0; i < 9; i++) {
+        ((float*)ma->data)[i] = (float)(i % 4);
+        ((float*)mb->data)[i] = (float)((i * 2) % 5);
+    }
+    Matrix* mc = Matrix_Multiply(ma, mb, &err);
+    float old_mp[3] = {((float*)ma->data)[0], ((float*)ma->data)[3], ((float*)ma->data)[6]};
+    float big = 100.0f;
+    for (size_t i = 0; i < 3; i++) Matrix_Set(ma, i, 0, &big);
+    err = Matrix_ProductRefreshColumn(mc, ma, mb, 0, old_mp);
+    Matrix* mc_ref = Matrix_Multiply(ma, mb, &err);
+    TEST_ASSERT(err == MATRIX_OK && memcmp(mc->data, mc_ref->data, 9 * sizeof(float)) == 0,
+                "Semiring column change recomputes the product");
+    TEST_ASSERT(Matrix_ProductRefreshRow(pc, pa, pb, m) == MATRIX_ERROR_INVALID_INDEX, "Row index checked");
+    
+    Matrix* all[] = {a, b, x, x_ref, current, u, v, inv, a2, inv_ref, pa, pb, pc, pc_old,
+                     ia, ib, ic, ic_ref, ma, mb, mc, mc_ref};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) Matrix_Destroy(all[i]);
+}
 
 //Производительность для матрицы 100x100
 void test_performance_100x100() {
@@ -462,6 +2463,29 @@ void run_all_tests() {
     test_gauss_solve_int();
     test_gauss_solve_float();
     test_gauss_singular();
+    test_stats();
+    test_trace();
+    test_half_fields();
+    test_quantized_multiply();
+    test_multiply_checked();
+    test_modular_field();
+    test_exact_integer();
+    test_bareiss();
+    test_gf2_matrix();
+    test_semirings();
+    test_complex_field();
+    test_wide_fields();
+    test_refined_solve();
+    test_field_registry();
+    test_small_matrix();
+    test_batch_operations();
+    test_determinant_inverse();
+    test_matrix_power();
+    test_matrix_chain();
+    test_row_operations();
+    test_copy_on_write();
+    test_result_cache();
+    test_incremental_updates();
  
 //Тест производительности 100*100
     test_performance_100x100();
@@ -475,4 +2499,6 @@ void run_all_tests() {
 
 
 
-//gcc -o matrix.exe field.c matrix.c int_field.c float_field.c test_matrix.c main.c
+//gcc -o matrix.exe field.c matrix.c int_field.c float_field.c half_field.c int8_field.c matrix_quant.c modular_field.c matrix_modular.c matrix_exact.c matrix_bareiss.c gf2_matrix.c semiring_field.c matrix_semiring.c complex_field.c matrix_complex.c double_field.c int64_field.c matrix_wide.c matrix_lu.c matrix_refine.c matrix_batch.c matrix_inverse.c matrix_chain.c matrix_rowops.c matrix_buffer.c matrix_cache.c matrix_update.c bigint.c matrix_stats.c matrix_trace.c test_matrix.c main.c
+//Статистика операций: -DMATRIX_ENABLE_STATS, трасса для Perfetto: -DMATRIX_ENABLE_TRACE,
+//простые для Matrix_DeterminantExact/Matrix_SolveExact и строки Барейса по потокам: -fopenmp